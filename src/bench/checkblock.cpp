@@ -7,6 +7,7 @@
 #include <consensus/validation.h>
 #include <kernel/chainparams.h>
 #include <primitives/block.h>
+#include <primitives/block_view.h>
 #include <primitives/transaction.h>
 #include <serialize.h>
 #include <streams.h>
@@ -31,6 +32,21 @@ static void DeserializeBlockTest(benchmark::Bench& bench)
     });
 }
 
+/** Parse the same block as BlockView and read all its outputs, as indexes do.  */
+static void ParseBlockViewTest(benchmark::Bench& bench)
+{
+    const auto block_data{std::as_bytes(std::span{benchmark::data::block413567})};
+    bench.unit("block").run([&] {
+        const BlockView view{block_data};
+        size_t num_outputs{0};
+        for (const auto& tx : view.GetTransactions()) {
+            tx.ForEachOutput([&](const TxView::Output&) { ++num_outputs; });
+        }
+        assert(view.GetTransactions().size() == 1557);
+        ankerl::nanobench::doNotOptimizeAway(num_outputs);
+    });
+}
+
 static void CheckBlockTest(benchmark::Bench& bench)
 {
     const auto& chain_params{CChainParams::Main()};
@@ -51,4 +67,5 @@ static void CheckBlockTest(benchmark::Bench& bench)
 }
 
 BENCHMARK(DeserializeBlockTest);
+BENCHMARK(ParseBlockViewTest);
 BENCHMARK(CheckBlockTest);
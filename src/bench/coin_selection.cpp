@@ -4,21 +4,29 @@
 
 #include <bench/bench.h>
 #include <consensus/amount.h>
+#include <kernel/chainparams.h>
+#include <names/main.h>
 #include <outputtype.h>
 #include <policy/feerate.h>
 #include <policy/policy.h>
 #include <primitives/transaction.h>
 #include <random.h>
+#include <script/names.h>
+#include <script/script.h>
 #include <sync.h>
 #include <test/util/setup_common.h>
+#include <uint256.h>
 #include <util/check.h>
 #include <util/result.h>
+#include <util/string.h>
+#include <validation.h>
 #include <wallet/coinselection.h>
 #include <wallet/db.h>
 #include <wallet/spend.h>
 #include <wallet/sqlite.h>
 #include <wallet/transaction.h>
 #include <wallet/wallet.h>
+#include <wallet/walletutil.h>
 
 #include <cstddef>
 #include <cstdint>
@@ -170,6 +178,73 @@ static void BnBExhaustion(benchmark::Bench& bench)
         });
 }
 
+/** Number of names and coins in the name-heavy wallet.  */
+static constexpr size_t NAME_HEAVY_NAMES{20'000};
+static constexpr size_t NAME_HEAVY_COINS{200};
+
+/**
+ * Lists the available coins of a name-heavy wallet, like that of a registrar,
+ * which has many more name outputs than coins.  The name outputs are never
+ * available for ordinary spending, so the cost should only depend on the
+ * number of coins.
+ */
+static void CoinSelectionNameHeavyWallet(benchmark::Bench& bench)
+{
+    const auto test_setup = MakeNoLogFileContext<const TestingSetup>();
+
+    CWallet wallet{test_setup->m_node.chain.get(), "", MakeInMemoryWalletDatabase()};
+    LOCK(wallet.cs_wallet);
+    wallet.SetWalletFlag(WALLET_FLAG_DESCRIPTORS);
+    wallet.SetupDescriptorScriptPubKeyMans();
+
+    const uint256 genesis{test_setup->m_node.chainman->GetParams().GenesisBlock().GetHash()};
+    wallet.SetLastBlockProcessed(0, genesis);
+
+    const CScript script{GetScriptForDestination(*Assert(wallet.GetNewDestination(OutputType::BECH32, "")))};
+    for (size_t i = 0; i < NAME_HEAVY_NAMES; ++i) {
+        const std::string name{"d/name-" + util::ToString(i)};
+        CMutableTransaction mtx;
+        mtx.vin.emplace_back(COutPoint{Txid::FromUint256(uint256::ONE), static_cast<uint32_t>(i)});
+        mtx.vout.emplace_back(NAME_LOCKED_AMOUNT, CNameScript::buildNameUpdate(script, valtype(name.begin(), name.end()), valtype{}));
+        if (i % (NAME_HEAVY_NAMES / NAME_HEAVY_COINS) == 0) mtx.vout.emplace_back(COIN, script);
+        CWalletTx wtx{MakeTransactionRef(std::move(mtx)), TxStateConfirmed{genesis, 0, static_cast<int>(i)}};
+        wtx.nOrderPos = i;
+        Assert(wallet.LoadToWallet(std::move(wtx)));
+    }
+
+    bench.run([&] {
+        const auto coins{AvailableCoins(wallet)};
+        assert(coins.Size() == NAME_HEAVY_COINS);
+    });
+}
+
+/**
+ * Selects the fee coins for a batch of name updates, one for each of the
+ * transactions, out of a diverse UTXO pool.
+ */
+static void NameBatchSelection(benchmark::Bench& bench)
+{
+    FastRandomContext det_rand{/*fDeterministic=*/true};
+
+    std::vector<OutputGroup> utxo_pool;
+    for (uint32_t i = 0; i < 2'000; ++i) {
+        add_coin(10'000 + det_rand.randrange(1'000'000), i, utxo_pool);
+    }
+
+    constexpr size_t NUM_UPDATES{500};
+    std::vector<CAmount> targets;
+    for (size_t i = 0; i < NUM_UPDATES; ++i) {
+        targets.push_back(20'000 + det_rand.randrange(10'000));
+    }
+
+    bench.batch(NUM_UPDATES).unit("update").run([&] {
+        const auto results{SelectNameBatchCoins(utxo_pool, targets, /*cost_of_change=*/1'000)};
+        assert(results.size() == NUM_UPDATES && results.back());
+    });
+}
+
 BENCHMARK(CoinSelection);
 BENCHMARK(BnBExhaustion);
+BENCHMARK(CoinSelectionNameHeavyWallet);
+BENCHMARK(NameBatchSelection);
 }; // namespace wallet
@@ -0,0 +1,71 @@
+// Copyright (c) 2026 The Namecoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <bench/bench.h>
+#include <consensus/amount.h>
+#include <key.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+/** Number of transactions accepted to the mempool in the benchmark.  */
+static constexpr size_t NUM_TXS{250};
+/** Number of inputs of each of them.  */
+static constexpr size_t NUM_INPUTS{8};
+
+/**
+ * Accept transactions with several P2WPKH inputs each to the mempool, so that
+ * their script checks can be spread over the script check threads. Every
+ * transaction is accepted only once, so that the signature cache is cold.
+ */
+static void MempoolAcceptMultiInput(benchmark::Bench& bench)
+{
+    const auto test_setup{MakeNoLogFileContext<TestChain100Setup>()};
+    auto& chainman{*test_setup->m_node.chainman};
+
+    const CKey key{GenerateRandomKey()};
+    const CScript spk{GetScriptForDestination(WitnessV0KeyHash{key.GetPubKey()})};
+    constexpr CAmount input_value{COIN / 50};
+    constexpr CAmount fee{COIN / 100};
+
+    // Fund all the inputs from one transaction, which is mined so that
+    // validating it is not part of the benchmark.
+    const auto& coinbase_tx{test_setup->m_coinbase_txns[0]};
+    const std::vector<CTxOut> funding_outputs(NUM_TXS * NUM_INPUTS, CTxOut{input_value, spk});
+    const auto [funding_mtx, _]{test_setup->CreateValidTransaction(
+        {coinbase_tx}, {COutPoint{coinbase_tx->GetHash(), 0}},
+        WITH_LOCK(cs_main, return chainman.ActiveHeight()) + 1, {test_setup->coinbaseKey}, funding_outputs, {}, {})};
+    const CTransactionRef funding_tx{MakeTransactionRef(funding_mtx)};
+    test_setup->CreateAndProcessBlock({funding_mtx}, CScript{} << OP_TRUE);
+    const int height{WITH_LOCK(cs_main, return chainman.ActiveHeight())};
+
+    std::vector<CTransactionRef> txs;
+    txs.reserve(NUM_TXS);
+    for (size_t i{0}; i < NUM_TXS; ++i) {
+        std::vector<COutPoint> inputs;
+        for (size_t j{0}; j < NUM_INPUTS; ++j) {
+            inputs.emplace_back(funding_tx->GetHash(), i * NUM_INPUTS + j);
+        }
+        const std::vector<CTxOut> outputs{{NUM_INPUTS * input_value - fee, spk}};
+        const auto [mtx, _]{test_setup->CreateValidTransaction({funding_tx}, inputs, height, {key}, outputs, {}, {})};
+        txs.push_back(MakeTransactionRef(mtx));
+    }
+
+    bench.batch(NUM_TXS).unit("tx").epochs(1).epochIterations(1).run([&] {
+        LOCK(cs_main);
+        for (const auto& tx : txs) {
+            const auto res{chainman.ProcessTransaction(tx)};
+            assert(res.m_result_type == MempoolAcceptResult::ResultType::VALID);
+        }
+    });
+}
+
+BENCHMARK(MempoolAcceptMultiInput);
@@ -0,0 +1,88 @@
+// Copyright (c) 2026 The Namecoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <names/applications.h>
+#include <names/encoding.h>
+#include <script/script.h>
+
+#include <univalue.h>
+
+#include <cassert>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+/** Number of names and values, like a large name_scan or name_list.  */
+constexpr unsigned NUM_NAMES{1'000};
+
+/** Typical domain value, which is minimal JSON.  */
+const std::string DOMAIN_VALUE{
+    R"({"ip":["192.0.2.1","192.0.2.2"],"ip6":["2001:db8::1"],)"
+    R"("map":{"www":{"alias":""},"mail":{"ip":["192.0.2.3"]}},)"
+    R"("tls":[[2,1,0,"MDkwEwYHKoZIzj0CAQYIKoZIzj0DAQcDIgADvxHcjwDYMNfUSTtSIn3VbBC1sOzh\/1Fv5T0UzEuLWIo="]],)"
+    R"("email":"hostmaster@example.bit","info":"Namecoin domain äöü"})"};
+
+std::vector<valtype> MakeNames()
+{
+    std::vector<valtype> names;
+    for (unsigned i = 0; i < NUM_NAMES; ++i) {
+        const std::string str{"d/bench-domain-name-" + std::to_string(i)};
+        names.emplace_back(str.begin(), str.end());
+    }
+    return names;
+}
+
+} // anonymous namespace
+
+/** Encode names and values for the RPC interface as UTF-8 and hex.  */
+static void NameEncodeForRpc(benchmark::Bench& bench)
+{
+    const auto names{MakeNames()};
+    const valtype value(DOMAIN_VALUE.begin(), DOMAIN_VALUE.end());
+
+    bench.batch(NUM_NAMES).unit("name").run([&] {
+        for (const auto& name : names) {
+            UniValue obj(UniValue::VOBJ);
+            AddEncodedNameToUniv(obj, "name", name, NameEncoding::ASCII);
+            AddEncodedNameToUniv(obj, "value", value, NameEncoding::UTF8);
+            AddEncodedNameToUniv(obj, "hex", name, NameEncoding::HEX);
+            assert(obj.size() == 6);
+        }
+    });
+}
+
+/** Decode names and values passed to the RPC interface.  */
+static void NameDecodeFromRpc(benchmark::Bench& bench)
+{
+    std::vector<std::string> hex;
+    for (const auto& name : MakeNames()) {
+        hex.push_back(EncodeName(name, NameEncoding::HEX));
+    }
+
+    bench.batch(NUM_NAMES).unit("name").run([&] {
+        for (const auto& str : hex) {
+            const valtype name{DecodeName(str, NameEncoding::HEX)};
+            const valtype value{DecodeName(DOMAIN_VALUE, NameEncoding::UTF8)};
+            assert(!name.empty() && !value.empty());
+        }
+    });
+}
+
+/** Check that values are valid and minimal JSON.  */
+static void NameValueJsonCheck(benchmark::Bench& bench)
+{
+    bench.batch(NUM_NAMES).unit("value").run([&] {
+        for (unsigned i = 0; i < NUM_NAMES; ++i) {
+            const bool ok{IsValidJSONOrEmptyString(DOMAIN_VALUE) && IsMinimalJSONOrEmptyString(DOMAIN_VALUE)};
+            assert(ok);
+        }
+    });
+}
+
+BENCHMARK(NameEncodeForRpc);
+BENCHMARK(NameDecodeFromRpc);
+BENCHMARK(NameValueJsonCheck);
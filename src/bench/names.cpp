@@ -0,0 +1,88 @@
+// Copyright (c) 2026 The Namecoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <coins.h>
+#include <names/common.h>
+#include <primitives/transaction.h>
+#include <script/names.h>
+#include <script/script.h>
+#include <uint256.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+/** Number of names already in the (warm) tip cache.  */
+constexpr unsigned NUM_CACHED_NAMES{20'000};
+/** Number of name updates in each simulated block.  */
+constexpr unsigned NUM_BLOCK_UPDATES{1'000};
+
+valtype MakeName(const unsigned i)
+{
+    const std::string str{"d/bench-name-" + std::to_string(i)};
+    return valtype(str.begin(), str.end());
+}
+
+CNameData MakeNameData(const valtype& name, const unsigned height)
+{
+    const valtype value(100, 'x');
+    const CScript addr{CScript() << OP_TRUE};
+    CNameData data;
+    data.fromScript(height, COutPoint(Txid::FromUint256(uint256::ONE), height),
+                    CNameScript(CNameScript::buildNameUpdate(addr, name, value)));
+    return data;
+}
+
+/** Empty base view, whose expire index is empty as well.  */
+class EmptyNamesView : public CoinsViewEmpty
+{
+public:
+    bool GetNamesForHeight(unsigned, std::set<valtype>& names) const override
+    {
+        names.clear();
+        return true;
+    }
+};
+
+} // anonymous namespace
+
+/**
+ * Connect blocks that update many names on top of a tip cache holding
+ * changes to many other names, as the name updates in ConnectBlock and the
+ * flush of its view to the chainstate's cache do.
+ */
+static void NameCacheBlockConnect(benchmark::Bench& bench)
+{
+    EmptyNamesView base;
+    CCoinsViewCache tip(&base);
+    for (unsigned i = 0; i < NUM_CACHED_NAMES; ++i) {
+        const valtype name{MakeName(i)};
+        tip.SetName(name, MakeNameData(name, i % 1'000), false);
+    }
+
+    std::vector<std::pair<valtype, CNameData>> updates;
+    for (unsigned i = 0; i < NUM_BLOCK_UPDATES; ++i) {
+        const valtype name{MakeName(i * (NUM_CACHED_NAMES / NUM_BLOCK_UPDATES))};
+        updates.emplace_back(name, MakeNameData(name, 2'000));
+    }
+
+    bench.run([&] {
+        CCoinsViewCache view(&tip);
+        CNameData data;
+        for (const auto& [name, new_data] : updates) {
+            assert(view.GetName(name, data));
+            view.SetName(name, new_data, false);
+        }
+        std::set<valtype> expired;
+        assert(view.GetNamesForHeight(500, expired));
+        view.SetBestBlock(uint256::ONE);
+        view.Flush();
+    });
+}
+
+BENCHMARK(NameCacheBlockConnect);
@@ -19,6 +19,9 @@
 #include <memory>
 #include <optional>
 #include <span>
+#include <thread>
+#include <utility>
+#include <vector>
 
 static CBlock CreateTestBlock()
 {
@@ -64,6 +67,34 @@ static void ReadRawBlockBench(benchmark::Bench& bench)
     });
 }
 
+/** Serve a batch of historical blocks to several peers in IBD at once. */
+static void ReadServedBlockPeersBench(benchmark::Bench& bench)
+{
+    constexpr int NUM_PEERS{8};
+    constexpr int NUM_BLOCKS{16};
+    const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN)};
+    auto& blockman{testing_setup->m_node.chainman->m_blockman};
+    std::vector<std::pair<uint256, FlatFilePos>> blocks;
+    CBlock block{CreateTestBlock()};
+    for (int i{0}; i < NUM_BLOCKS; ++i) {
+        ++block.nNonce;
+        blocks.emplace_back(block.GetHash(), WITH_LOCK(::cs_main, return blockman.WriteBlock(block, 413'567 + i)));
+    }
+    bench.run([&] {
+        std::vector<std::thread> peers;
+        for (int p{0}; p < NUM_PEERS; ++p) {
+            peers.emplace_back([&] {
+                for (const auto& [hash, pos] : blocks) {
+                    const auto res{blockman.ReadServedBlock(hash, pos)};
+                    assert(res);
+                }
+            });
+        }
+        for (auto& t : peers) t.join();
+    });
+}
+
 BENCHMARK(WriteBlockBench);
 BENCHMARK(ReadBlockBench);
 BENCHMARK(ReadRawBlockBench);
+BENCHMARK(ReadServedBlockPeersBench);
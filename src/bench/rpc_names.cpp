@@ -0,0 +1,60 @@
+// Copyright (c) 2026 The Namecoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <kernel/cs_main.h>
+#include <names/common.h>
+#include <primitives/transaction.h>
+#include <rpc/names.h>
+#include <script/names.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <uint256.h>
+#include <univalue.h>
+
+#include <string>
+#include <vector>
+
+/** Number of names in the simulated name_scan result.  */
+static constexpr unsigned NUM_SCANNED_NAMES{10'000};
+
+/**
+ * Build and serialize the result of a name_scan that returns many names,
+ * as the RPC server does for it.
+ */
+static void NameScanToJson(benchmark::Bench& bench)
+{
+    const auto testing_setup{MakeNoLogFileContext<const TestingSetup>()};
+    const auto& chainman{*testing_setup->m_node.chainman};
+
+    std::vector<std::pair<valtype, CNameData>> names;
+    for (unsigned i = 0; i < NUM_SCANNED_NAMES; ++i) {
+        const std::string str{"d/bench-name-" + std::to_string(i)};
+        const valtype name(str.begin(), str.end());
+        const std::string value{R"({"ip":"192.0.2.)" + std::to_string(i % 256) + R"(","email":"hostmaster@example.com"})"};
+        const CScript addr{CScript() << OP_TRUE};
+        CNameData data;
+        data.fromScript(i, COutPoint(Txid::FromUint256(uint256::ONE), i),
+                        CNameScript(CNameScript::buildNameUpdate(addr, name, valtype(value.begin(), value.end()))));
+        names.emplace_back(name, std::move(data));
+    }
+    const UniValue options(UniValue::VOBJ);
+
+    bench.batch(NUM_SCANNED_NAMES).unit("name").run([&] {
+        UniValue res(UniValue::VARR);
+        res.reserve(names.size());
+        {
+            LOCK(cs_main);
+            for (const auto& [name, data] : names) {
+                res.push_back(getNameInfo(chainman, options, name, data));
+            }
+        }
+        std::string str;
+        res.write(str);
+        ankerl::nanobench::doNotOptimizeAway(str);
+    });
+}
+
+BENCHMARK(NameScanToJson);
@@ -17,6 +17,7 @@
 #include <util/check.h>
 #include <util/translation.h>
 
+#include <cstdint>
 #include <map>
 #include <span>
 #include <vector>
@@ -76,6 +77,40 @@ static void SignTransactionSingleInput(benchmark::Bench& bench, InputType input_
 static void SignTransactionECDSA(benchmark::Bench& bench)   { SignTransactionSingleInput(bench, InputType::P2WPKH); }
 static void SignTransactionSchnorr(benchmark::Bench& bench) { SignTransactionSingleInput(bench, InputType::P2TR);   }
 
+static void SignTransactionManyInputs(benchmark::Bench& bench)
+{
+    ECC_Context ecc_context{};
+
+    // A transaction spending many outputs, like a batch of name operations
+    constexpr uint32_t NUM_INPUTS{500};
+
+    FlatSigningProvider keystore;
+    std::vector<CScript> prev_spks;
+    for (int i = 0; i < 32; i++) {
+        CKey privkey = GenerateRandomKey();
+        CPubKey pubkey = privkey.GetPubKey();
+        CKeyID key_id = pubkey.GetID();
+        keystore.keys.emplace(key_id, privkey);
+        keystore.pubkeys.emplace(key_id, pubkey);
+        prev_spks.push_back(GetScriptForDestination(WitnessV0KeyHash(pubkey)));
+    }
+
+    CMutableTransaction unsigned_tx;
+    std::map<COutPoint, Coin> coins;
+    for (uint32_t i = 0; i < NUM_INPUTS; i++) {
+        const COutPoint prevout{Txid::FromUint256(uint256::ONE), i};
+        unsigned_tx.vin.emplace_back(prevout);
+        coins[prevout] = Coin(CTxOut(10000, prev_spks[i % prev_spks.size()]), /*nHeightIn=*/100, /*fCoinBaseIn=*/false);
+    }
+
+    bench.unit("input").batch(NUM_INPUTS).run([&] {
+        CMutableTransaction tx{unsigned_tx};
+        std::map<int, bilingual_str> input_errors;
+        bool complete = SignTransaction(tx, &keystore, coins, {.sighash_type = SIGHASH_ALL}, input_errors);
+        assert(complete);
+    });
+}
+
 static void SignSchnorrTapTweakBenchmark(benchmark::Bench& bench, bool use_null_merkle_root)
 {
     FastRandomContext rng;
@@ -105,5 +140,6 @@ static void SignSchnorrWithNullMerkleRoot(benchmark::Bench& bench)
 
 BENCHMARK(SignTransactionECDSA);
 BENCHMARK(SignTransactionSchnorr);
+BENCHMARK(SignTransactionManyInputs);
 BENCHMARK(SignSchnorrWithMerkleRoot);
 BENCHMARK(SignSchnorrWithNullMerkleRoot);
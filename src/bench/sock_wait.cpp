@@ -0,0 +1,80 @@
+// Copyright (c) 2026 The Namecoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <compat/compat.h>
+#include <util/sock.h>
+
+#include <cassert>
+#include <chrono>
+#include <memory>
+
+using namespace std::chrono_literals;
+
+namespace
+{
+
+/** Number of connections, of which only one has data to receive.  */
+constexpr size_t NUM_CONNECTIONS{1'000};
+
+std::shared_ptr<const Sock> CreateUdpSock()
+{
+    const SOCKET s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    assert(s != INVALID_SOCKET);
+    return std::make_shared<const Sock>(s);
+}
+
+/**
+ * Set up the sockets to wait on, like CConnman does for mostly idle peers:
+ * one of them has a datagram queued that is never read, so that it stays
+ * ready, and all the others never become ready.
+ */
+Sock::EventsPerSock MostlyIdleSockets()
+{
+    Sock::EventsPerSock events_per_sock;
+
+    const auto ready{CreateUdpSock()};
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    assert(ready->Bind(reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    socklen_t addr_len{sizeof(addr)};
+    assert(ready->GetSockName(reinterpret_cast<sockaddr*>(&addr), &addr_len) == 0);
+    assert(ready->Connect(reinterpret_cast<sockaddr*>(&addr), addr_len) == 0);
+    assert(ready->Send("x", 1, 0) == 1);
+    events_per_sock.emplace(ready, Sock::Events{Sock::RecvEvent});
+
+    while (events_per_sock.size() < NUM_CONNECTIONS) {
+        events_per_sock.emplace(CreateUdpSock(), Sock::Events{Sock::RecvEvent});
+    }
+
+    return events_per_sock;
+}
+
+} // anonymous namespace
+
+/** Wait on all the sockets with poll(2) or select(2) every time.  */
+static void SockWaitManyIdleConnections(benchmark::Bench& bench)
+{
+    auto events_per_sock{MostlyIdleSockets()};
+    bench.run([&] {
+        const bool ok{events_per_sock.begin()->first->WaitMany(1s, events_per_sock)};
+        assert(ok);
+    });
+}
+
+/** Wait with the sockets kept registered in a SockPoller.  */
+static void SockPollerIdleConnections(benchmark::Bench& bench)
+{
+    auto events_per_sock{MostlyIdleSockets()};
+    SockPoller poller;
+    bench.run([&] {
+        const bool ok{events_per_sock.begin()->first->WaitManyPersistent(1s, events_per_sock, poller)};
+        assert(ok);
+    });
+}
+
+BENCHMARK(SockWaitManyIdleConnections);
+BENCHMARK(SockPollerIdleConnections);
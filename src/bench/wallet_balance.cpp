@@ -6,8 +6,10 @@
 #include <interfaces/chain.h>
 #include <interfaces/handler.h>
 #include <kernel/chainparams.h>
+#include <outputtype.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
+#include <script/script.h>
 #include <sync.h>
 #include <test/util/mining.h>
 #include <test/util/setup_common.h>
@@ -17,14 +19,17 @@
 #include <validation.h>
 #include <wallet/db.h>
 #include <wallet/receive.h>
+#include <wallet/spend.h>
 #include <wallet/sqlite.h>
 #include <wallet/test/util.h>
 #include <wallet/wallet.h>
 #include <wallet/walletutil.h>
 
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <string>
+#include <utility>
 
 namespace wallet {
 static void WalletBalance(benchmark::Bench& bench, const bool set_dirty, const bool add_mine)
@@ -69,7 +74,56 @@ static void WalletBalanceDirty(benchmark::Bench& bench) { WalletBalance(bench, /
 static void WalletBalanceClean(benchmark::Bench& bench) { WalletBalance(bench, /*set_dirty=*/false, /*add_mine=*/true); }
 static void WalletBalanceWatch(benchmark::Bench& bench) { WalletBalance(bench, /*set_dirty=*/false, /*add_mine=*/false); }
 
+/** Number of transactions in the history of the large wallet.  */
+static constexpr size_t LARGE_HISTORY_TXS{500'000};
+
+/**
+ * Computes the balance or the available coins of a wallet with a long
+ * history, where each transaction spends the output of the previous one.
+ * Only the last output is unspent, so the cost should not depend on the
+ * size of the history.
+ */
+static void WalletLargeHistory(benchmark::Bench& bench, const bool available_coins)
+{
+    const auto test_setup = MakeNoLogFileContext<const TestingSetup>();
+
+    CWallet wallet{test_setup->m_node.chain.get(), "", MakeInMemoryWalletDatabase()};
+    LOCK(wallet.cs_wallet);
+    wallet.SetWalletFlag(WALLET_FLAG_DESCRIPTORS);
+    wallet.SetupDescriptorScriptPubKeyMans();
+
+    const uint256 genesis{test_setup->m_node.chainman->GetParams().GenesisBlock().GetHash()};
+    wallet.SetLastBlockProcessed(0, genesis);
+
+    const CScript script{GetScriptForDestination(*Assert(wallet.GetNewDestination(OutputType::BECH32, "")))};
+    COutPoint prevout{Txid::FromUint256(uint256::ONE), 0};
+    for (size_t i = 0; i < LARGE_HISTORY_TXS; ++i) {
+        CMutableTransaction mtx;
+        mtx.vin.emplace_back(prevout);
+        mtx.vout.emplace_back(COIN, script);
+        CWalletTx wtx{MakeTransactionRef(std::move(mtx)), TxStateConfirmed{genesis, 0, static_cast<int>(i)}};
+        wtx.nOrderPos = i;
+        prevout = COutPoint{wtx.GetHash(), 0};
+        Assert(wallet.LoadToWallet(std::move(wtx)));
+    }
+
+    bench.run([&] {
+        if (available_coins) {
+            const auto coins{AvailableCoins(wallet)};
+            assert(coins.Size() == 1);
+        } else {
+            const auto bal{GetBalance(wallet)};
+            assert(bal.m_mine_trusted == COIN);
+        }
+    });
+}
+
+static void WalletBalanceLargeHistory(benchmark::Bench& bench) { WalletLargeHistory(bench, /*available_coins=*/false); }
+static void WalletAvailableCoinsLargeHistory(benchmark::Bench& bench) { WalletLargeHistory(bench, /*available_coins=*/true); }
+
 BENCHMARK(WalletBalanceDirty);
 BENCHMARK(WalletBalanceClean);
 BENCHMARK(WalletBalanceWatch);
+BENCHMARK(WalletBalanceLargeHistory);
+BENCHMARK(WalletAvailableCoinsLargeHistory);
 } // namespace wallet
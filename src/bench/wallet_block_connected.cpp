@@ -0,0 +1,92 @@
+// Copyright (c) 2026 The Namecoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <bench/bench.h>
+#include <consensus/amount.h>
+#include <interfaces/chain.h>
+#include <kernel/chain.h>
+#include <kernel/types.h>
+#include <outputtype.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <script/script.h>
+#include <test/util/setup_common.h>
+#include <uint256.h>
+#include <util/check.h>
+#include <util/translation.h>
+#include <wallet/context.h>
+#include <wallet/db.h>
+#include <wallet/test/util.h>
+#include <wallet/wallet.h>
+#include <wallet/walletutil.h>
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+
+namespace wallet {
+
+/**
+ * Connect blocks with @p num_txs transactions each to an on-disk wallet,
+ * @p num_wallet_txs of which pay to the wallet.  Many of them, like for a
+ * registrar or exchange, are written (with the key pool top-up) in one
+ * database transaction.  The others are matched against the wallet's
+ * scripts, on threads for large blocks, and not synced at all.
+ */
+static void WalletBlockConnected(benchmark::Bench& bench, const size_t num_txs, const size_t num_wallet_txs)
+{
+    const auto test_setup = MakeNoLogFileContext<TestingSetup>();
+
+    WalletContext context;
+    context.args = &test_setup->m_args;
+    context.chain = test_setup->m_node.chain.get();
+
+    DatabaseStatus status;
+    DatabaseOptions options;
+    options.require_format = DatabaseFormat::SQLITE;
+    options.require_create = true;
+    bilingual_str error;
+    auto wallet = TestCreateWallet(MakeWalletDatabase("", options, status, error), context, WALLET_FLAG_DESCRIPTORS);
+
+    FastRandomContext rng{/*fDeterministic=*/true};
+    const CScript other_script{GetScriptForDestination(WitnessV0KeyHash{uint160{}})};
+    CBlock block;
+    uint256 hash;
+    int height{0};
+
+    bench.epochs(5).epochIterations(1)
+        .setup([&] {
+            block.vtx.clear();
+            for (size_t i = 0; i < num_txs; ++i) {
+                CMutableTransaction mtx;
+                mtx.vin.emplace_back(COutPoint{Txid::FromUint256(rng.rand256()), 0});
+                if (i % (num_txs / num_wallet_txs) == 0) {
+                    mtx.vout.emplace_back(COIN, GetScriptForDestination(*Assert(wallet->GetNewDestination(OutputType::BECH32, ""))));
+                } else {
+                    mtx.vout.emplace_back(COIN, other_script);
+                }
+                block.vtx.push_back(MakeTransactionRef(mtx));
+            }
+            hash = rng.rand256();
+            ++height;
+        })
+        .run([&] {
+            interfaces::BlockInfo info{hash};
+            info.height = height;
+            info.data = &block;
+            info.chain_time_max = std::numeric_limits<unsigned int>::max();
+            wallet->blockConnected(kernel::ChainstateRole{}, info);
+        });
+
+    TestUnloadWallet(std::move(wallet));
+}
+
+static void WalletBlockConnectedDescriptors(benchmark::Bench& bench) { WalletBlockConnected(bench, /*num_txs=*/200, /*num_wallet_txs=*/200); }
+static void WalletBlockConnectedLargeBlock(benchmark::Bench& bench) { WalletBlockConnected(bench, /*num_txs=*/5000, /*num_wallet_txs=*/50); }
+
+BENCHMARK(WalletBlockConnectedDescriptors);
+BENCHMARK(WalletBlockConnectedLargeBlock);
+} // namespace wallet
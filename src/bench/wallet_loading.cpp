@@ -16,6 +16,7 @@
 #include <wallet/test/util.h>
 #include <wallet/transaction.h>
 #include <wallet/wallet.h>
+#include <wallet/walletdb.h>
 #include <wallet/walletutil.h>
 
 #include <cstdint>
@@ -35,7 +36,7 @@ static void AddTx(CWallet& wallet)
     wallet.AddToWallet(MakeTransactionRef(mtx), TxStateInactive{});
 }
 
-static void WalletLoadingDescriptors(benchmark::Bench& bench)
+static void WalletLoading(benchmark::Bench& bench, const int num_txs)
 {
     const auto test_setup = MakeNoLogFileContext<TestingSetup>();
 
@@ -55,8 +56,13 @@ static void WalletLoadingDescriptors(benchmark::Bench& bench)
     auto wallet = TestCreateWallet(std::move(database), context, create_flags);
 
     // Generate a bunch of transactions and addresses to put into the wallet
-    for (int i = 0; i < 1000; ++i) {
-        AddTx(*wallet);
+    {
+        WalletBatch batch{wallet->GetDatabase()};
+        batch.TxnBegin();
+        for (int i = 0; i < num_txs; ++i) {
+            AddTx(*wallet);
+        }
+        batch.TxnCommit();
     }
 
     options.require_create = false;
@@ -75,5 +81,9 @@ static void WalletLoadingDescriptors(benchmark::Bench& bench)
     TestUnloadWallet(std::move(wallet));
 }
 
+static void WalletLoadingDescriptors(benchmark::Bench& bench) { WalletLoading(bench, /*num_txs=*/1000); }
+static void WalletLoadingDescriptorsLarge(benchmark::Bench& bench) { WalletLoading(bench, /*num_txs=*/20000); }
+
 BENCHMARK(WalletLoadingDescriptors);
+BENCHMARK(WalletLoadingDescriptorsLarge);
 } // namespace wallet
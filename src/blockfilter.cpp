@@ -11,6 +11,7 @@
 #include <hash.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
+#include <script/names.h>
 #include <script/script.h>
 #include <streams.h>
 #include <undo.h>
@@ -21,6 +22,7 @@ using util::Join;
 
 static const std::map<BlockFilterType, std::string> g_filter_types = {
     {BlockFilterType::BASIC, "basic"},
+    {BlockFilterType::NAMES, "names"},
 };
 
 uint64_t GCSFilter::HashToRange(const Element& element) const
@@ -184,8 +186,26 @@ const std::string& ListBlockFilterTypes()
     return type_list;
 }
 
+/**
+ * Adds a script to the filter elements.  With @p name_addresses, the address
+ * part of name scripts is added as well, so that wallets can match name
+ * outputs to their own scripts without knowing the name and value in advance.
+ */
+static void AddScriptElements(GCSFilter::ElementSet& elements, const CScript& script, bool name_addresses)
+{
+    elements.emplace(script.begin(), script.end());
+    if (!name_addresses) return;
+
+    const CNameScript nameOp(script);
+    if (nameOp.isNameOp()) {
+        const CScript& addr = nameOp.getAddress();
+        if (!addr.empty()) elements.emplace(addr.begin(), addr.end());
+    }
+}
+
 static GCSFilter::ElementSet BasicFilterElements(const CBlock& block,
-                                                 const CBlockUndo& block_undo)
+                                                 const CBlockUndo& block_undo,
+                                                 bool name_addresses)
 {
     GCSFilter::ElementSet elements;
 
@@ -193,7 +213,7 @@ static GCSFilter::ElementSet BasicFilterElements(const CBlock& block,
         for (const CTxOut& txout : tx->vout) {
             const CScript& script = txout.scriptPubKey;
             if (script.empty() || script[0] == OP_RETURN) continue;
-            elements.emplace(script.begin(), script.end());
+            AddScriptElements(elements, script, name_addresses);
         }
     }
 
@@ -201,7 +221,7 @@ static GCSFilter::ElementSet BasicFilterElements(const CBlock& block,
         for (const Coin& prevout : tx_undo.vprevout) {
             const CScript& script = prevout.out.scriptPubKey;
             if (script.empty()) continue;
-            elements.emplace(script.begin(), script.end());
+            AddScriptElements(elements, script, name_addresses);
         }
     }
 
@@ -226,13 +246,15 @@ BlockFilter::BlockFilter(BlockFilterType filter_type, const CBlock& block, const
     if (!BuildParams(params)) {
         throw std::invalid_argument("unknown filter_type");
     }
-    m_filter = GCSFilter(params, BasicFilterElements(block, block_undo));
+    m_filter = GCSFilter(params, BasicFilterElements(block, block_undo,
+                                                     /*name_addresses=*/filter_type == BlockFilterType::NAMES));
 }
 
 bool BlockFilter::BuildParams(GCSFilter::Params& params) const
 {
     switch (m_filter_type) {
     case BlockFilterType::BASIC:
+    case BlockFilterType::NAMES:
         params.m_siphash_k0 = m_block_hash.GetUint64(0);
         params.m_siphash_k1 = m_block_hash.GetUint64(1);
         params.m_P = BASIC_FILTER_P;
@@ -93,6 +93,12 @@ inline constexpr uint32_t BASIC_FILTER_M = 784931;
 enum class BlockFilterType : uint8_t
 {
     BASIC = 0,
+    /**
+     * Namecoin-specific type, not part of BIP 158 and not served over P2P.
+     * It contains the BASIC elements plus the address part of name scripts,
+     * so that wallets can match name outputs sent to their addresses.
+     */
+    NAMES = 0x80,
     INVALID = 255,
 };
 
@@ -48,7 +48,7 @@ CCoinsViewCache::CCoinsViewCache(CCoinsView* in_base, bool deterministic) :
 }
 
 size_t CCoinsViewCache::DynamicMemoryUsage() const {
-    return memusage::DynamicUsage(cacheCoins) + cachedCoinsUsage;
+    return memusage::DynamicUsage(cacheCoins) + cachedCoinsUsage + cacheNames.DynamicMemoryUsage();
 }
 
 std::optional<Coin> CCoinsViewCache::FetchCoinFromBase(const COutPoint& outpoint) const
@@ -380,6 +380,8 @@ void CCoinsViewCache::Flush(bool reallocate_cache)
         ReallocateCache();
     }
     cachedCoinsUsage = 0;
+    /* The name cache only records changes, which are all written now.  */
+    cacheNames.clear();
 }
 
 void CCoinsViewCache::Sync()
@@ -391,6 +393,7 @@ void CCoinsViewCache::Sync()
         /* BatchWrite must clear flags of all entries */
         throw std::logic_error("Not all unspent flagged entries were cleared");
     }
+    cacheNames.clear();
 }
 
 void CCoinsViewCache::Reset() noexcept
@@ -491,7 +491,6 @@ protected:
     mutable CCoinsMap cacheCoins;
 
     /* Cached dynamic memory usage for the inner Coin objects. */
-    /* TODO: Sum up also name cache usage.  */
     mutable size_t cachedCoinsUsage{0};
     /* Running count of dirty Coin cache entries. */
     mutable size_t m_dirty_count{0};
@@ -602,9 +601,12 @@ public:
     //! Number of dirty cache entries (transaction outputs)
     size_t GetDirtyCount() const noexcept { return m_dirty_count; }
 
-    //! Calculate the size of the cache (in bytes)
+    //! Calculate the size of the cache (in bytes), including cached name changes
     size_t DynamicMemoryUsage() const;
 
+    //! Calculate the size of the cached name changes (in bytes)
+    size_t NameCacheMemoryUsage() const { return cacheNames.DynamicMemoryUsage(); }
+
     //! Check whether all prevouts of the transaction are present in the UTXO set represented by this view
     bool HaveInputs(const CTransaction& tx) const;
 
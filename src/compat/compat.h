@@ -105,6 +105,11 @@ typedef SSIZE_T ssize_t;
 #define USE_POLL
 #endif
 
+// Keep long-lived sockets registered with the kernel between waits, see SockPoller
+#if defined(__linux__)
+#define USE_EPOLL
+#endif
+
 // MSG_NOSIGNAL is not available on some platforms, if it doesn't exist define it as 0
 #if !defined(MSG_NOSIGNAL)
 #define MSG_NOSIGNAL 0
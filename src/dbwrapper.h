@@ -52,6 +52,10 @@ struct DBParams {
     bool obfuscate = false;
     //! If true, build a LevelDB bloom filter to accelerate point lookups.
     bool bloom_filter = true;
+    //! If set, size of the LevelDB write buffer. Up to two of them may be
+    //! held in memory, the remainder of cache_bytes goes to the block cache.
+    //! Defaults to a quarter of cache_bytes.
+    std::optional<size_t> write_buffer_bytes{};
     //! Passed-through options.
     DBOptions options{};
     //! If non-null, use this as the leveldb::Env instead of the default.
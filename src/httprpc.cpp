@@ -9,6 +9,7 @@
 #include <httpserver.h>
 #include <netaddress.h>
 #include <rpc/protocol.h>
+#include <rpc/request.h>
 #include <rpc/server.h>
 #include <util/fs.h>
 #include <util/fs_helpers.h>
@@ -18,6 +19,7 @@
 #include <walletinitinterface.h>
 
 #include <algorithm>
+#include <cassert>
 #include <iterator>
 #include <map>
 #include <memory>
@@ -39,6 +41,108 @@ static std::vector<std::vector<std::string>> g_rpcauth;
 static std::map<std::string, std::set<std::string>> g_rpc_whitelist;
 static bool g_rpc_whitelist_default = false;
 
+/** Size at which buffered parts of a streamed RPC result are sent */
+static constexpr size_t RPC_STREAM_CHUNK_SIZE{1 << 16};
+
+/**
+ * Sends the reply to a single JSON-RPC request as chunked HTTP response,
+ * while the RPC method produces the entries of its result. The reply is the
+ * same as JSONRPCReplyObj would produce for the whole result.
+ */
+class HTTPRPCResultStream : public JSONRPCResultStream
+{
+public:
+    HTTPRPCResultStream(HTTPRequest& req, const JSONRPCRequest& jreq) : m_req{req}, m_jreq{jreq} {}
+
+    /** Whether (part of) the reply has been sent already. */
+    bool Started() const { return m_started; }
+
+    void Begin(UniValue::VType type) override
+    {
+        assert(m_type == UniValue::VNULL);
+        m_type = type;
+
+        // Notifications are executed, but never get a reply.
+        if (m_jreq.IsNotification()) return;
+
+        m_req.WriteHeader("Content-Type", "application/json");
+        m_req.StartChunkedReply(HTTP_OK);
+        m_started = true;
+        m_buffer = "{";
+        if (m_jreq.m_json_version == JSONRPCVersion::V2) m_buffer += R"("jsonrpc":"2.0",)";
+        m_buffer += type == UniValue::VARR ? R"("result":[)" : R"("result":{)";
+    }
+
+    void Push(const UniValue& value) override
+    {
+        if (!m_started) return;
+        AddSeparator();
+        value.write(m_buffer);
+        MaybeFlush();
+    }
+
+    void PushKV(const std::string& key, const UniValue& value) override
+    {
+        if (!m_started) return;
+        AddSeparator();
+        UniValue{key}.write(m_buffer);
+        m_buffer += ':';
+        value.write(m_buffer);
+        MaybeFlush();
+    }
+
+    /** Completes the reply after the RPC method returned successfully. */
+    void Finish()
+    {
+        assert(m_started);
+        m_buffer += m_type == UniValue::VARR ? "]" : "}";
+        if (m_jreq.m_json_version == JSONRPCVersion::V1_LEGACY) m_buffer += R"(,"error":null)";
+        if (m_jreq.id.has_value()) {
+            m_buffer += R"(,"id":)";
+            m_jreq.id->write(m_buffer);
+        }
+        m_buffer += "}\n";
+        if (m_failed || !m_req.WriteReplyChunk(m_buffer)) {
+            m_req.AbortChunkedReply();
+            return;
+        }
+        m_req.EndChunkedReply();
+    }
+
+    /**
+     * Cuts off the reply if the RPC method failed after parts of its result
+     * were sent already, as there is no way to turn them into an error.
+     */
+    void Abort()
+    {
+        assert(m_started);
+        m_req.AbortChunkedReply();
+    }
+
+private:
+    HTTPRequest& m_req;
+    const JSONRPCRequest& m_jreq;
+    UniValue::VType m_type{UniValue::VNULL};
+    bool m_started{false};
+    bool m_empty{true};
+    //! Set when the client is gone, after which the rest of the result is dropped
+    bool m_failed{false};
+    std::string m_buffer;
+
+    void AddSeparator()
+    {
+        if (!m_empty) m_buffer += ',';
+        m_empty = false;
+    }
+
+    void MaybeFlush()
+    {
+        if (m_buffer.size() < RPC_STREAM_CHUNK_SIZE) return;
+        if (!m_failed) m_failed = !m_req.WriteReplyChunk(m_buffer);
+        m_buffer.clear();
+    }
+};
+
 static UniValue JSONErrorReply(UniValue objError, const JSONRPCRequest& jreq, HTTPStatusCode& nStatus)
 {
     // HTTP errors should never be returned if JSON-RPC v2 was requested. This
@@ -134,6 +238,10 @@ UniValue ExecuteHTTPRPC(const UniValue& valRequest, JSONRPCRequest& jreq, HTTPSt
             return reply;
         // array of requests
         } else if (valRequest.isArray()) {
+            // The replies of a batch are combined into one array, which is
+            // not streamed.
+            jreq.m_result_stream = nullptr;
+
             // Check authorization for each request's method
             if (user_has_whitelist) {
                 for (unsigned int reqIdx = 0; reqIdx < valRequest.size(); reqIdx++) {
@@ -226,23 +334,38 @@ static void HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
         return;
     }
 
-    // Generate reply
+    // Generate reply, which RPC methods may already start to send as they
+    // produce their results
     HTTPStatusCode status;
     UniValue reply;
     UniValue request;
+    HTTPRPCResultStream stream{*req, jreq};
+    jreq.m_result_stream = &stream;
     if (request.read(req->ReadBody())) {
         reply = ExecuteHTTPRPC(request, jreq, status);
     } else {
         reply = JSONErrorReply(JSONRPCError(RPC_PARSE_ERROR, "Parse error"), jreq, status);
     }
 
+    if (stream.Started()) {
+        if (status == HTTP_OK && reply.find_value("error").isNull()) {
+            stream.Finish();
+        } else {
+            stream.Abort();
+        }
+        return;
+    }
+
     // Write reply
     if (reply.isNull()) {
         // Error case or no-content notification reply.
         req->WriteReply(status);
     } else {
         req->WriteHeader("Content-Type", "application/json");
-        req->WriteReply(status, reply.write() + "\n");
+        std::string body;
+        reply.write(body);
+        body += '\n';
+        req->WriteReply(status, body);
     }
 }
 
@@ -514,7 +514,7 @@ bool HTTPRequest::LoadBody(LineReader& reader)
     }
 }
 
-void HTTPRequest::WriteReply(HTTPStatusCode status, std::span<const std::byte> reply_body)
+std::string HTTPRequest::PrepareReplyHeaders(HTTPStatusCode status, std::optional<size_t> content_length, bool& keep_alive)
 {
     HTTPResponse res;
 
@@ -532,7 +532,7 @@ void HTTPRequest::WriteReply(HTTPStatusCode status, std::span<const std::byte> r
     bool needs_body{status != HTTP_NO_CONTENT && (status < 100 || status >= 200)};
     bool needs_content_length{false};
 
-    bool keep_alive{false};
+    keep_alive = false;
 
     // See libevent evhttp_make_header_response()
     // Expected response headers depend on protocol version
@@ -540,7 +540,9 @@ void HTTPRequest::WriteReply(HTTPStatusCode status, std::span<const std::byte> r
         // HTTP/1.0
         if (m_version.minor == 0) {
             auto connection_header{m_headers.FindFirst("Connection")};
-            if (connection_header && ToLower(connection_header.value()) == "keep-alive") {
+            // Without chunked transfer encoding, the end of a body of unknown
+            // length can only be signalled by closing the connection.
+            if (connection_header && ToLower(connection_header.value()) == "keep-alive" && content_length) {
                 res.m_headers.Write("Connection", "keep-alive");
                 keep_alive = true;
                 // HTTP/1.0 connections are closed by default so EOF is sufficient
@@ -563,7 +565,12 @@ void HTTPRequest::WriteReply(HTTPStatusCode status, std::span<const std::byte> r
     }
 
     if (needs_content_length) {
-        res.m_headers.Write("Content-Length", util::ToString(reply_body.size()));
+        if (content_length) {
+            res.m_headers.Write("Content-Length", util::ToString(*content_length));
+        } else {
+            res.m_headers.Write("Transfer-Encoding", "chunked");
+            m_chunked_encoding = true;
+        }
     }
 
     if (needs_body && !res.m_headers.FindFirst("Content-Type")) {
@@ -580,23 +587,28 @@ void HTTPRequest::WriteReply(HTTPStatusCode status, std::span<const std::byte> r
         keep_alive = false;
     }
 
-    m_client->m_keep_alive = keep_alive;
-
     // Serialize the response headers
-    const std::string headers{res.StringifyHeaders()};
-    const auto headers_bytes{std::as_bytes(std::span{headers})};
+    return res.StringifyHeaders();
+}
 
+void HTTPRequest::AppendToSendBuffer(std::span<const std::byte> headers, std::span<const std::byte> body, std::optional<bool> keep_alive)
+{
     bool send_buffer_was_empty{false};
-    // Fill the send buffer with the complete serialized response headers + body
+    // Fill the send buffer with the serialized response headers + body
     {
         LOCK(m_client->m_send_mutex);
         send_buffer_was_empty = m_client->m_send_buffer.empty();
-        m_client->m_send_buffer.insert(m_client->m_send_buffer.end(), headers_bytes.begin(), headers_bytes.end());
+        m_client->m_send_buffer.insert(m_client->m_send_buffer.end(), headers.begin(), headers.end());
 
         // We've been using std::span up until now but it is finally time to copy
         // data. The original data will go out of scope when WriteReply() returns.
         // This is analogous to the memcpy() in libevent's evbuffer_add()
-        m_client->m_send_buffer.insert(m_client->m_send_buffer.end(), reply_body.begin(), reply_body.end());
+        m_client->m_send_buffer.insert(m_client->m_send_buffer.end(), body.begin(), body.end());
+
+        // Only update the keep-alive flag while the buffer holds the data, so
+        // that the I/O thread cannot see the buffer drained and close the
+        // connection before the end of a chunked reply has been written.
+        if (keep_alive) m_client->m_keep_alive = *keep_alive;
 
         // If the buffer already held data, the I/O thread is (or soon will be)
         // draining it, so flag that there is more data to send. This must happen
@@ -609,6 +621,24 @@ void HTTPRequest::WriteReply(HTTPStatusCode status, std::span<const std::byte> r
         if (!send_buffer_was_empty) m_client->m_send_ready = true;
     }
 
+    // If the send buffer was empty before we wrote this reply, we can try an
+    // optimistic send akin to CConnman::PushMessage() in which we
+    // push the data directly out the socket to client right now, instead
+    // of waiting for the next iteration of the I/O loop.
+    if (send_buffer_was_empty) {
+        m_client->MaybeSendBytesFromBuffer();
+    }
+}
+
+void HTTPRequest::WriteReply(HTTPStatusCode status, std::span<const std::byte> reply_body)
+{
+    bool keep_alive;
+    const std::string headers{PrepareReplyHeaders(status, reply_body.size(), keep_alive)};
+    const auto headers_bytes{std::as_bytes(std::span{headers})};
+
+    m_client->m_keep_alive = keep_alive;
+    AppendToSendBuffer(headers_bytes, reply_body, std::nullopt);
+
     LogDebug(
         BCLog::HTTP,
         "HTTPResponse (status code: %d size: %lld) added to send buffer for client %s (id=%llu)",
@@ -617,18 +647,77 @@ void HTTPRequest::WriteReply(HTTPStatusCode status, std::span<const std::byte> r
         m_client->m_origin,
         m_client->m_id);
 
-    // If the send buffer was empty before we wrote this reply, we can try an
-    // optimistic send akin to CConnman::PushMessage() in which we
-    // push the data directly out the socket to client right now, instead
-    // of waiting for the next iteration of the I/O loop.
-    if (send_buffer_was_empty) {
+    // Signal to the I/O loop that we are ready to handle the next request.
+    m_client->m_req_busy = false;
+}
+
+void HTTPRequest::StartChunkedReply(HTTPStatusCode status)
+{
+    const std::string headers{PrepareReplyHeaders(status, std::nullopt, m_chunked_keep_alive)};
+
+    // Keep the connection open while the reply is incomplete, even if the
+    // send buffer runs empty in between.
+    m_client->m_keep_alive = true;
+    AppendToSendBuffer(std::as_bytes(std::span{headers}), {}, std::nullopt);
+
+    LogDebug(BCLog::HTTP, "Started chunked HTTPResponse (status code: %d) for client %s (id=%llu)",
+             status, m_client->m_origin, m_client->m_id);
+}
+
+bool HTTPRequest::WriteReplyChunk(std::span<const std::byte> data)
+{
+    // An empty chunk would mark the end of the body.
+    if (data.empty()) return !m_client->m_disconnect;
+
+    // Wait until the client has received enough of the previous data, so that
+    // a long reply is never held in memory as a whole.
+    const std::chrono::seconds timeout{g_http_server ? g_http_server->GetServerTimeout() : std::chrono::seconds{DEFAULT_HTTP_SERVER_TIMEOUT}};
+    while (WITH_LOCK(m_client->m_send_mutex, return m_client->m_send_buffer.size()) >= MAX_CHUNKED_REPLY_BUFFER) {
+        if (m_client->m_disconnect) return false;
+        if (timeout.count() > 0 && Now<SteadySeconds>() - m_client->m_idle_since.load() > timeout) {
+            LogDebug(BCLog::HTTP, "Timeout sending chunked HTTPResponse to client %s (id=%llu)",
+                     m_client->m_origin, m_client->m_id);
+            m_client->m_disconnect = true;
+            return false;
+        }
+        const auto sock{WITH_LOCK(m_client->m_sock_mutex, return m_client->m_sock)};
+        (void)sock->Wait(100ms, Sock::SendEvent);
         m_client->MaybeSendBytesFromBuffer();
     }
+    if (m_client->m_disconnect) return false;
+
+    const std::string chunk_header{m_chunked_encoding ? strprintf("%x\r\n", data.size()) : ""};
+    AppendToSendBuffer(std::as_bytes(std::span{chunk_header}), data, std::nullopt);
+    if (m_chunked_encoding) AppendToSendBuffer(std::as_bytes(std::span{"\r\n", 2}), {}, std::nullopt);
+    return true;
+}
+
+void HTTPRequest::EndChunkedReply()
+{
+    const std::string_view last_chunk{m_chunked_encoding ? "0\r\n\r\n" : ""};
+    AppendToSendBuffer(std::as_bytes(std::span{last_chunk}), {}, m_chunked_keep_alive);
+
+    // Without chunked transfer encoding, nothing may be in the send buffer
+    // any more, and the connection has to be closed to end the body.
+    if (!m_chunked_keep_alive && WITH_LOCK(m_client->m_send_mutex, return m_client->m_send_buffer.empty())) {
+        m_client->m_disconnect = true;
+    }
 
     // Signal to the I/O loop that we are ready to handle the next request.
     m_client->m_req_busy = false;
 }
 
+void HTTPRequest::AbortChunkedReply()
+{
+    LogDebug(BCLog::HTTP, "Aborting chunked HTTPResponse for client %s (id=%llu)",
+             m_client->m_origin, m_client->m_id);
+
+    // The client can only tell that the reply is incomplete if we close
+    // the connection before the end of the body.
+    m_client->m_disconnect = true;
+    m_client->m_req_busy = false;
+}
+
 CService HTTPRequest::GetPeer() const
 {
     return m_client->m_addr;
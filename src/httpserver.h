@@ -79,6 +79,10 @@ inline constexpr size_t MAX_HEADERS_SIZE{8192};
 //! Maximum size of an HTTP request body
 inline constexpr uint64_t MAX_BODY_SIZE{32_MiB};
 
+//! Amount of unsent data of a chunked reply at which writing more of it
+//! blocks until the client has received some
+inline constexpr size_t MAX_CHUNKED_REPLY_BUFFER{1_MiB};
+
 //! Thrown when a request body exceeds MAX_BODY_SIZE (or *will* exceed, in chunked transfer)
 //! so the server can reply with more specific code 413 (content too large) vs general 400 (bad request)
 struct ContentTooLargeError : std::runtime_error {
@@ -186,6 +190,30 @@ public:
         WriteReply(status, std::as_bytes(std::span{reply_body_view}));
     }
 
+    /**
+     * Methods to send a reply whose body is produced piece by piece, e.g.
+     * a large RPC result. The body is sent with chunked transfer encoding
+     * (or, for HTTP/1.0, until the connection is closed). After
+     * StartChunkedReply(), the reply must be completed with
+     * EndChunkedReply() or cut off with AbortChunkedReply().
+     */
+    /// @{
+    void StartChunkedReply(HTTPStatusCode status);
+    /**
+     * Send the next piece of the body. Blocks while MAX_CHUNKED_REPLY_BUFFER
+     * bytes or more are still waiting to be sent to the client.
+     * @returns false if the client is gone or does not receive the data
+     *          in time, in which case the reply must be aborted.
+     */
+    bool WriteReplyChunk(std::span<const std::byte> data);
+    bool WriteReplyChunk(std::string_view data)
+    {
+        return WriteReplyChunk(std::as_bytes(std::span{data}));
+    }
+    void EndChunkedReply();
+    void AbortChunkedReply();
+    /// @}
+
     // These methods reimplement the API from http_libevent::HTTPRequest
     // for downstream JSONRPC and REST modules.
     std::string GetURI() const { return m_target; }
@@ -195,6 +223,26 @@ public:
     std::pair<bool, std::string> GetHeader(std::string_view hdr) const;
     std::string ReadBody() const { return m_body; }
     void WriteHeader(std::string&& hdr, std::string&& value);
+
+private:
+    //! Whether the reply started with StartChunkedReply() uses chunked transfer encoding
+    bool m_chunked_encoding{false};
+    //! Whether to keep the connection alive after a chunked reply
+    bool m_chunked_keep_alive{false};
+
+    /**
+     * Build the serialized status line and headers of the reply.
+     * @param[in]  content_length  Size of the body, or nullopt if it is sent in chunks.
+     * @param[out] keep_alive      Whether to keep the connection alive after the reply.
+     */
+    std::string PrepareReplyHeaders(HTTPStatusCode status, std::optional<size_t> content_length, bool& keep_alive);
+
+    /**
+     * Append data to the client's send buffer and try to send it right away.
+     * @param[in] keep_alive  If set, the new value of the client's keep-alive flag,
+     *                        which is updated together with the buffer.
+     */
+    void AppendToSendBuffer(std::span<const std::byte> headers, std::span<const std::byte> body, std::optional<bool> keep_alive);
 };
 
 class HTTPServer
@@ -285,6 +333,7 @@ public:
      * Set the idle client timeout (-rpcservertimeout)
      */
     void SetServerTimeout(std::chrono::seconds seconds) { m_rpcservertimeout = seconds; }
+    std::chrono::seconds GetServerTimeout() const { return m_rpcservertimeout; }
 
     /**
      * Force-remove all remaining clients from m_connected without waiting for
@@ -16,6 +16,7 @@
 #include <node/database_args.h>
 #include <node/interface_ui.h>
 #include <primitives/block.h>
+#include <primitives/block_view.h>
 #include <sync.h>
 #include <tinyformat.h>
 #include <uint256.h>
@@ -26,13 +27,17 @@
 #include <util/string.h>
 #include <util/thread.h>
 #include <util/threadinterrupt.h>
+#include <util/threadpool.h>
 #include <util/time.h>
 #include <util/translation.h>
 #include <validation.h>
 #include <validationinterface.h>
 
 #include <compare>
+#include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <future>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -48,6 +53,8 @@ constexpr uint8_t DB_BEST_BLOCK{'B'};
 
 constexpr auto SYNC_LOG_INTERVAL{30s};
 constexpr auto SYNC_LOCATOR_WRITE_INTERVAL{30s};
+/// Number of blocks each sync worker thread may read ahead of the sync thread.
+constexpr size_t SYNC_READ_AHEAD_PER_THREAD{4};
 
 template <typename... Args>
 void BaseIndex::FatalErrorf(util::ConstevalFormatString<sizeof...(Args)> fmt, const Args&... args)
@@ -172,31 +179,68 @@ static const CBlockIndex* NextSyncBlock(const CBlockIndex* const pindex_prev, CC
     return chain.Next(*Assert(fork));
 }
 
-bool BaseIndex::ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data)
-{
-    interfaces::BlockInfo block_info = kernel::MakeBlockInfo(pindex, block_data);
-
+struct BaseIndex::BlockData {
+    /// The block, if not read as view. Points to block below if read from disk.
+    const CBlock* data{nullptr};
     CBlock block;
-    if (!block_data) { // disk lookup if block data wasn't provided
-        if (!m_chainstate->m_blockman.ReadBlock(block, *pindex)) {
-            FatalErrorf("Failed to read block %s from disk",
-                        pindex->GetBlockHash().ToString());
+    std::vector<std::byte> raw_block;
+    std::optional<BlockView> view;
+    std::optional<CBlockUndo> undo;
+    std::unique_ptr<PreparedBlock> prepared;
+    /// Why reading the block failed.
+    std::string error;
+
+    interfaces::BlockInfo Info(const CBlockIndex* pindex) const
+    {
+        interfaces::BlockInfo block_info = kernel::MakeBlockInfo(pindex, data);
+        if (view) block_info.view = &*view;
+        if (undo) block_info.undo_data = &*undo;
+        return block_info;
+    }
+};
+
+bool BaseIndex::ReadBlockData(const CBlockIndex* pindex, const CBlock* block_data, bool read_undo, BlockData& data) const
+{
+    data.data = block_data;
+    if (!block_data && AllowBlockView()) {
+        // Parse only what the index reads instead of the full block.
+        auto res{m_chainstate->m_blockman.ReadRawBlock(WITH_LOCK(::cs_main, return pindex->GetBlockPos()))};
+        if (res) {
+            data.raw_block = std::move(*res);
+            try {
+                data.view.emplace(data.raw_block);
+            } catch (const std::exception& e) {
+                LogError("Deserialize error - %s while reading block %s", e.what(), pindex->GetBlockHash().ToString());
+            }
+        }
+        if (!data.view || data.view->GetHeader().GetHash() != pindex->GetBlockHash()) {
+            data.error = strprintf("Failed to read block %s from disk", pindex->GetBlockHash().ToString());
+            return false;
+        }
+    } else if (!block_data) { // disk lookup if block data wasn't provided
+        if (!m_chainstate->m_blockman.ReadBlock(data.block, *pindex)) {
+            data.error = strprintf("Failed to read block %s from disk", pindex->GetBlockHash().ToString());
             return false;
         }
-        block_info.data = &block;
+        data.data = &data.block;
     }
 
-    CBlockUndo block_undo;
-    if (CustomOptions().connect_undo_data) {
-        if (pindex->nHeight > 0 && !m_chainstate->m_blockman.ReadBlockUndo(block_undo, *pindex)) {
-            FatalErrorf("Failed to read undo block data %s from disk",
-                        pindex->GetBlockHash().ToString());
+    if (read_undo) {
+        data.undo.emplace();
+        if (pindex->nHeight > 0 && !m_chainstate->m_blockman.ReadBlockUndo(*data.undo, *pindex)) {
+            data.error = strprintf("Failed to read undo block data %s from disk", pindex->GetBlockHash().ToString());
             return false;
         }
-        block_info.undo_data = &block_undo;
     }
 
-    if (!CustomAppend(block_info)) {
+    data.prepared = CustomPrepare(data.Info(pindex));
+    return true;
+}
+
+bool BaseIndex::AppendBlockData(const CBlockIndex* pindex, BlockData& data)
+{
+    const interfaces::BlockInfo block_info{data.Info(pindex)};
+    if (!(data.prepared ? CustomAppendPrepared(block_info, *data.prepared) : CustomAppend(block_info))) {
         FatalErrorf("Failed to write block %s to index database",
                     pindex->GetBlockHash().ToString());
         return false;
@@ -205,12 +249,38 @@ bool BaseIndex::ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data
     return true;
 }
 
+bool BaseIndex::ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data)
+{
+    BlockData data;
+    if (!ReadBlockData(pindex, block_data, CustomOptions().connect_undo_data, data)) {
+        FatalErrorf("%s", data.error);
+        return false;
+    }
+    return AppendBlockData(pindex, data);
+}
+
 void BaseIndex::Sync()
 {
     const CBlockIndex* pindex = m_best_block_index.load();
     if (!m_synced) {
         auto last_log_time{NodeClock::now()};
         auto last_locator_write_time{last_log_time};
+        const auto sync_start{SteadyClock::now()};
+        const int start_height{pindex ? pindex->nHeight : -1};
+
+        // Blocks are read from disk and prepared on the worker threads, and
+        // appended here in chain order.
+        const int sync_threads{m_sync_threads};
+        const bool read_undo{CustomOptions().connect_undo_data};
+        ThreadPool read_pool{m_thread_name + "read"};
+        if (sync_threads > 0) read_pool.Start(sync_threads);
+        std::deque<std::pair<const CBlockIndex*, std::future<std::unique_ptr<BlockData>>>> read_ahead;
+        const auto read_block{[this, read_undo](const CBlockIndex* block_index) {
+            auto data{std::make_unique<BlockData>()};
+            ReadBlockData(block_index, nullptr, read_undo, *data);
+            return data;
+        }};
+
         while (true) {
             if (m_interrupt) {
                 LogInfo("%s: m_interrupt set; exiting ThreadSync", GetName());
@@ -240,6 +310,10 @@ void BaseIndex::Sync()
                 pindex_next = NextSyncBlock(pindex, m_chainstate->m_chain);
                 if (!pindex_next) {
                     m_synced = true;
+                    if (pindex && pindex->nHeight > start_height) {
+                        LogInfo("%s: indexed %d blocks in %is with %d read threads", GetName(), pindex->nHeight - start_height,
+                                Ticks<std::chrono::seconds>(SteadyClock::now() - sync_start), sync_threads);
+                    }
                     break;
                 }
             }
@@ -249,8 +323,32 @@ void BaseIndex::Sync()
             }
             pindex = pindex_next;
 
+            std::unique_ptr<BlockData> data;
+            if (!read_ahead.empty() && read_ahead.front().first == pindex) {
+                data = read_ahead.front().second.get();
+                read_ahead.pop_front();
+            } else {
+                // The chain changed since the blocks were queued.
+                read_ahead.clear();
+            }
+            if (sync_threads > 0) {
+                LOCK(::cs_main);
+                const CBlockIndex* last{read_ahead.empty() ? pindex : read_ahead.back().first};
+                while (read_ahead.size() < static_cast<size_t>(sync_threads) * SYNC_READ_AHEAD_PER_THREAD) {
+                    last = m_chainstate->m_chain.Next(*last);
+                    if (!last) break;
+                    auto future{read_pool.Submit([read_block, last] { return read_block(last); })};
+                    if (!future) break;
+                    read_ahead.emplace_back(last, std::move(*future));
+                }
+            }
+            if (!data) data = read_block(pindex);
 
-            if (!ProcessBlock(pindex)) return; // error logged internally
+            if (!data->error.empty()) {
+                FatalErrorf("%s", data->error);
+                return;
+            }
+            if (!AppendBlockData(pindex, *data)) return; // error logged internally
 
             auto current_time{NodeClock::now()};
             if (current_time - last_log_time >= SYNC_LOG_INTERVAL) {
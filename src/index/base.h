@@ -27,6 +27,12 @@ class CBlockIndex;
 class Chainstate;
 
 struct CBlockLocator;
+
+/** Default for -indexsyncthreads, by default blocks are read on the sync thread.  */
+inline constexpr int DEFAULT_INDEX_SYNC_THREADS{0};
+/** Maximum number of threads reading blocks ahead for each index.  */
+inline constexpr int MAX_INDEX_SYNC_THREADS{16};
+
 struct IndexSummary {
     std::string name;
     bool synced{false};
@@ -94,6 +100,12 @@ private:
     std::thread m_thread_sync;
     CThreadInterrupt m_interrupt;
 
+    /// Number of threads that read and prepare blocks ahead during sync.
+    std::atomic<int> m_sync_threads{DEFAULT_INDEX_SYNC_THREADS};
+
+    /// A block read for appending to the index, see ReadBlockData.
+    struct BlockData;
+
     /// Write the current index state (eg. chain block locator and subclass-specific items) to disk.
     /// Will skip the commit if no block has been indexed yet or if the index's best block is
     /// ahead of the chainstate's last flushed block. This avoids persisting state an unclean shutdown
@@ -105,6 +117,14 @@ private:
 
     bool ProcessBlock(const CBlockIndex* pindex, const CBlock* block_data = nullptr);
 
+    /// Read the block (unless block_data is given) and its undo data from disk,
+    /// and call CustomPrepare on it. This does not depend on the index state, and
+    /// runs on the sync worker threads for blocks ahead of the best block.
+    bool ReadBlockData(const CBlockIndex* pindex, const CBlock* block_data, bool read_undo, BlockData& data) const;
+
+    /// Call CustomAppend (or CustomAppendPrepared) for a block read with ReadBlockData.
+    bool AppendBlockData(const CBlockIndex* pindex, BlockData& data);
+
     virtual bool AllowPrune() const = 0;
 
     template <typename... Args>
@@ -126,6 +146,25 @@ protected:
     /// Write update index entries for a newly connected block.
     [[nodiscard]] virtual bool CustomAppend(const interfaces::BlockInfo& block) { return true; }
 
+    /// Whether CustomAppend can work from a BlockView instead of a CBlock. If so,
+    /// blocks read from disk during sync are passed as view without data.
+    virtual bool AllowBlockView() const { return false; }
+
+    /// The part of indexing a block that depends on nothing but the block.
+    struct PreparedBlock {
+        virtual ~PreparedBlock() = default;
+    };
+
+    /// Compute what only depends on the block itself, like its filter or the
+    /// positions of its transactions. This may run concurrently for several
+    /// blocks and out of order, so it must not touch the index state. If it
+    /// returns non-null, CustomAppendPrepared is called instead of CustomAppend.
+    [[nodiscard]] virtual std::unique_ptr<PreparedBlock> CustomPrepare(const interfaces::BlockInfo& block) const { return nullptr; }
+
+    /// Write update index entries for a newly connected block from the result
+    /// of CustomPrepare.
+    [[nodiscard]] virtual bool CustomAppendPrepared(const interfaces::BlockInfo& block, const PreparedBlock& prepared) { return false; }
+
     /// Virtual method called internally by Commit that can be overridden to atomically
     /// commit more index state.
     virtual bool CustomCommit(CDBBatch& batch) { return true; }
@@ -165,6 +204,10 @@ public:
     /// Starts the initial sync process on a background thread.
     [[nodiscard]] bool StartBackgroundSync();
 
+    /// Set the number of threads that read and prepare blocks ahead of the
+    /// sync thread. With zero, the sync thread reads every block itself.
+    void SetSyncThreads(int threads) { m_sync_threads = threads; }
+
     /// \anchor index_sync
     /// Sync the index with the block index starting from the current best block.
     /// Intended to be run in its own thread, m_thread_sync, and can be
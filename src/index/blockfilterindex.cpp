@@ -27,6 +27,7 @@
 #include <cerrno>
 #include <exception>
 #include <map>
+#include <memory>
 #include <optional>
 #include <stdexcept>
 #include <string>
@@ -65,6 +66,7 @@ std::string BlockFilterThreadName(BlockFilterType filter_type)
 {
     switch (filter_type) {
     case BlockFilterType::BASIC: return "blkfltbscidx";
+    case BlockFilterType::NAMES: return "blkfltnmsidx";
     case BlockFilterType::INVALID: return "";
     } // no default case, so the compiler can warn about missing cases
     assert(false);
@@ -256,9 +258,21 @@ std::optional<uint256> BlockFilterIndex::ReadFilterHeader(int height, const uint
     return read_out.second.header;
 }
 
-bool BlockFilterIndex::CustomAppend(const interfaces::BlockInfo& block)
+struct BlockFilterIndex::PreparedFilter : public PreparedBlock {
+    BlockFilter filter;
+
+    explicit PreparedFilter(BlockFilter&& f) : filter{std::move(f)} {}
+};
+
+std::unique_ptr<BaseIndex::PreparedBlock> BlockFilterIndex::CustomPrepare(const interfaces::BlockInfo& block) const
+{
+    // Building the filter only depends on the block, unlike its header.
+    return std::make_unique<PreparedFilter>(BlockFilter(m_filter_type, *Assert(block.data), *Assert(block.undo_data)));
+}
+
+bool BlockFilterIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, const PreparedBlock& prepared)
 {
-    BlockFilter filter(m_filter_type, *Assert(block.data), *Assert(block.undo_data));
+    const BlockFilter& filter{static_cast<const PreparedFilter&>(prepared).filter};
     const uint256& header = filter.ComputeHeader(m_last_header);
     bool res = Write(filter, block.height, header);
     if (res) m_last_header = header; // update last header
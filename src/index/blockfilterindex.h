@@ -58,6 +58,9 @@ private:
 
     bool AllowPrune() const override { return true; }
 
+    /** The filter of a block, built ahead of appending it.  */
+    struct PreparedFilter;
+
     bool Write(const BlockFilter& filter, uint32_t block_height, const uint256& filter_header);
 
     std::optional<uint256> ReadFilterHeader(int height, const uint256& expected_block_hash);
@@ -67,7 +70,9 @@ protected:
 
     bool CustomCommit(CDBBatch& batch) override;
 
-    bool CustomAppend(const interfaces::BlockInfo& block) override;
+    std::unique_ptr<PreparedBlock> CustomPrepare(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, const PreparedBlock& prepared) override;
 
     bool CustomRemove(const interfaces::BlockInfo& block) override;
 
@@ -7,8 +7,14 @@
 #include <common/args.h>
 #include <hash.h>
 #include <primitives/block.h>
+#include <primitives/block_view.h>
 #include <script/names.h>
 
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <span>
 #include <utility>
 #include <vector>
 
@@ -31,10 +37,45 @@ public:
     return Read (std::make_pair (DB_HASH, hash), name);
   }
 
+  std::vector<std::optional<valtype>>
+    ReadPreimages (std::span<const uint256> hashes);
+
   void WritePreimages (const std::vector<std::pair<uint256, valtype>>& data);
 
 };
 
+std::vector<std::optional<valtype>>
+NameHashIndex::DB::ReadPreimages (const std::span<const uint256> hashes)
+{
+  /* Look the hashes up in key order, so that a single iterator moves
+     only forward through the database.  */
+  std::vector<size_t> order(hashes.size ());
+  std::iota (order.begin (), order.end (), 0);
+  std::sort (order.begin (), order.end (),
+             [&hashes] (const size_t a, const size_t b)
+               {
+                 return hashes[a] < hashes[b];
+               });
+
+  std::vector<std::optional<valtype>> res(hashes.size ());
+  std::unique_ptr<CDBIterator> it(NewIterator ());
+  for (const size_t i : order)
+    {
+      const auto key = std::make_pair (DB_HASH, hashes[i]);
+      it->Seek (key);
+
+      std::pair<uint8_t, uint256> found;
+      valtype name;
+      if (!it->Valid () || !it->GetKey (found) || found != key
+            || !it->GetValue (name))
+        continue;
+
+      res[i] = std::move (name);
+    }
+
+  return res;
+}
+
 void
 NameHashIndex::DB::WritePreimages (
     const std::vector<std::pair<uint256, valtype>>& data)
@@ -55,23 +96,55 @@ NameHashIndex::NameHashIndex (std::unique_ptr<interfaces::Chain> chain,
 
 NameHashIndex::~NameHashIndex () = default;
 
-bool
-NameHashIndex::CustomAppend (const interfaces::BlockInfo& block)
+struct NameHashIndex::PreparedNames : public PreparedBlock
 {
   std::vector<std::pair<uint256, valtype>> data;
-  for (const auto& tx : block.data->vtx)
-    for (const auto& out : tx->vout)
-      {
-        const CNameScript nameOp(out.scriptPubKey);
-        if (!nameOp.isNameOp () || nameOp.getNameOp () != OP_NAME_FIRSTUPDATE)
-          continue;
-
-        const valtype& name = nameOp.getOpName ();
-        const uint256 hash = Hash (name);
-        data.emplace_back (hash, name);
-      }
-
-  db->WritePreimages (data);
+};
+
+std::unique_ptr<BaseIndex::PreparedBlock>
+NameHashIndex::CustomPrepare (const interfaces::BlockInfo& block) const
+{
+  auto prepared = std::make_unique<PreparedNames> ();
+  auto& data = prepared->data;
+  const auto addOutput = [&data] (const std::span<const unsigned char> script)
+    {
+      /* Only copy the scripts that can be a name registration at all,
+         which avoids allocating a CScript for all other outputs.  */
+      if (script.empty () || script[0] != OP_NAME_FIRSTUPDATE)
+        return;
+
+      const CNameScript nameOp(CScript (script.begin (), script.end ()));
+      if (!nameOp.isNameOp () || nameOp.getNameOp () != OP_NAME_FIRSTUPDATE)
+        return;
+
+      const valtype& name = nameOp.getOpName ();
+      const uint256 hash = Hash (name);
+      data.emplace_back (hash, name);
+    };
+
+  if (block.view != nullptr)
+    {
+      for (const auto& tx : block.view->GetTransactions ())
+        tx.ForEachOutput ([&] (const TxView::Output& out)
+          {
+            addOutput (out.script_pub_key);
+          });
+    }
+  else
+    {
+      for (const auto& tx : block.data->vtx)
+        for (const auto& out : tx->vout)
+          addOutput (MakeUCharSpan (out.scriptPubKey));
+    }
+
+  return prepared;
+}
+
+bool
+NameHashIndex::CustomAppendPrepared (const interfaces::BlockInfo& block,
+                                     const PreparedBlock& prepared)
+{
+  db->WritePreimages (static_cast<const PreparedNames&> (prepared).data);
   return true;
 }
 
@@ -87,4 +160,10 @@ NameHashIndex::FindNamePreimage (const uint256& hash, valtype& name) const
   return db->ReadPreimage (hash, name);
 }
 
+std::vector<std::optional<valtype>>
+NameHashIndex::FindNamePreimages (const std::span<const uint256> hashes) const
+{
+  return db->ReadPreimages (hashes);
+}
+
 std::unique_ptr<NameHashIndex> g_name_hash_index;
@@ -10,6 +10,9 @@
 #include <uint256.h>
 
 #include <memory>
+#include <optional>
+#include <span>
+#include <vector>
 
 /** Default value for the -namehashindex argument.  */
 static constexpr bool DEFAULT_NAMEHASHINDEX = false;
@@ -39,10 +42,17 @@ private:
   const std::unique_ptr<DB> db;
 
   bool AllowPrune() const override { return false; }
+  bool AllowBlockView() const override { return true; }
+
+  /** The hashes and names registered in a block.  */
+  struct PreparedNames;
 
 protected:
 
-    bool CustomAppend (const interfaces::BlockInfo& block) override;
+    std::unique_ptr<PreparedBlock>
+      CustomPrepare (const interfaces::BlockInfo& block) const override;
+    bool CustomAppendPrepared (const interfaces::BlockInfo& block,
+                               const PreparedBlock& prepared) override;
 
     BaseIndex::DB& GetDB () const override;
 
@@ -62,6 +72,13 @@ public:
      */
     bool FindNamePreimage (const uint256& hash, valtype& name) const;
 
+    /**
+     * Looks up many names by hash at once.  The result has an entry for
+     * each of the hashes, which is empty if the hash is not known.
+     */
+    std::vector<std::optional<valtype>>
+      FindNamePreimages (std::span<const uint256> hashes) const;
+
 };
 
 /** The global name-hash index.  May be null.  */
@@ -15,6 +15,7 @@
 #include <interfaces/chain.h>
 #include <node/blockstorage.h>
 #include <primitives/block.h>
+#include <primitives/block_view.h>
 #include <primitives/transaction.h>
 #include <random.h>
 #include <serialize.h>
@@ -60,7 +61,7 @@ public:
     explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
 
     /// Write a block of transaction positions to the DB.
-    void WriteTxs(const interfaces::BlockInfo& block);
+    void WriteTxs(const interfaces::BlockInfo& block, const std::vector<std::pair<Txid, uint32_t>>& txs);
 
     /// Used to hash the txid to compute the prefix.
     const SipHasher13UJ m_hasher;
@@ -108,7 +109,7 @@ void TxIndex::DB::WriteBestBlock(CDBBatch& batch, const CBlockLocator& locator)
     batch.Write(txindex::DB_BEST_BLOCK_V2, locator);
 }
 
-void TxIndex::DB::WriteTxs(const interfaces::BlockInfo& block)
+void TxIndex::DB::WriteTxs(const interfaces::BlockInfo& block, const std::vector<std::pair<Txid, uint32_t>>& txs)
 {
     // A block may be submitted again after it was already indexed, e.g. when it
     // reconnects after a reorg or is re-processed after an unclean shutdown. It
@@ -122,16 +123,10 @@ void TxIndex::DB::WriteTxs(const interfaces::BlockInfo& block)
     batch.Write(txindex::BlockHashKey{block.hash}, block_seq);
     batch.Write(txindex::BlockSeqKey{block_seq}, block.hash);
     batch.Write(txindex::DB_NEXT_BLOCK_SEQ, block_seq + 1);
-    /* auxpow: the header may include a variable-size CAuxPow, so compute its
-       actual serialized size instead of assuming a fixed 80-byte header
-       (as is done in upstream Bitcoin code).  */
-    const uint32_t header_size{static_cast<uint32_t>(GetSerializeSize(static_cast<const CBlockHeader&>(*block.data)))};
-    uint32_t tx_offset_in_block{header_size + GetSizeOfCompactSize(block.data->vtx.size())};
-    for (const auto& tx : block.data->vtx) {
-        const txindex::DBKey key{txindex::CreateKeyPrefix(m_hasher, tx->GetHash()),
+    for (const auto& [txid, tx_offset_in_block] : txs) {
+        const txindex::DBKey key{txindex::CreateKeyPrefix(m_hasher, txid),
                                  txindex::BlockTxPosition{block_seq, tx_offset_in_block}};
         batch.Write(key, txindex::EMPTY_VALUE);
-        tx_offset_in_block += tx->ComputeTotalSize();
     }
     WriteBatch(batch);
 }
@@ -148,13 +143,43 @@ TxIndex::TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size,
 
 TxIndex::~TxIndex() = default;
 
-bool TxIndex::CustomAppend(const interfaces::BlockInfo& block)
+struct TxIndex::PreparedTxs : public PreparedBlock {
+    std::vector<std::pair<Txid, uint32_t>> txs;
+};
+
+std::unique_ptr<BaseIndex::PreparedBlock> TxIndex::CustomPrepare(const interfaces::BlockInfo& block) const
 {
     // Exclude genesis block transaction because outputs are not spendable.
-    if (block.height == 0) return true;
+    if (block.height == 0) return nullptr;
+
+    assert(block.data || block.view);
+    auto prepared{std::make_unique<PreparedTxs>()};
+    /* auxpow: the header may include a variable-size CAuxPow, so compute its
+       actual serialized size instead of assuming a fixed 80-byte header
+       (as is done in upstream Bitcoin code).  */
+    if (block.view) {
+        const auto& txs{block.view->GetTransactions()};
+        prepared->txs.reserve(txs.size());
+        uint32_t tx_offset_in_block{static_cast<uint32_t>(block.view->GetHeaderSize() + GetSizeOfCompactSize(txs.size()))};
+        for (const TxView& tx : txs) {
+            prepared->txs.emplace_back(tx.GetHash(), tx_offset_in_block);
+            tx_offset_in_block += tx.GetTotalSize();
+        }
+    } else {
+        prepared->txs.reserve(block.data->vtx.size());
+        const uint32_t header_size{static_cast<uint32_t>(GetSerializeSize(static_cast<const CBlockHeader&>(*block.data)))};
+        uint32_t tx_offset_in_block{header_size + GetSizeOfCompactSize(block.data->vtx.size())};
+        for (const auto& tx : block.data->vtx) {
+            prepared->txs.emplace_back(tx->GetHash(), tx_offset_in_block);
+            tx_offset_in_block += tx->ComputeTotalSize();
+        }
+    }
+    return prepared;
+}
 
-    assert(block.data);
-    m_db->WriteTxs(block);
+bool TxIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, const PreparedBlock& prepared)
+{
+    m_db->WriteTxs(block, static_cast<const PreparedTxs&>(prepared).txs);
     return true;
 }
 
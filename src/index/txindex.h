@@ -44,11 +44,18 @@ private:
 
     bool AllowPrune() const override { return false; }
 
+    bool AllowBlockView() const override { return true; }
+
+    /// The txids of a block and their offsets in it.
+    struct PreparedTxs;
+
     /// Look up a transaction among the legacy (full-txid) entries.
     std::optional<TxIndexResult> FindLegacyTx(const Txid& tx_hash) const;
 
 protected:
-    bool CustomAppend(const interfaces::BlockInfo& block) override;
+    std::unique_ptr<PreparedBlock> CustomPrepare(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, const PreparedBlock& prepared) override;
 
     BaseIndex::DB& GetDB() const override;
 
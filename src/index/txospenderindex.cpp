@@ -14,6 +14,7 @@
 #include <logging.h>
 #include <node/blockstorage.h>
 #include <primitives/block.h>
+#include <primitives/block_view.h>
 #include <primitives/transaction.h>
 #include <random.h>
 #include <serialize.h>
@@ -27,6 +28,7 @@
 #include <cstdio>
 #include <exception>
 #include <ios>
+#include <memory>
 #include <span>
 #include <string>
 #include <utility>
@@ -113,8 +115,23 @@ void TxoSpenderIndex::EraseSpenderInfos(const std::vector<std::pair<COutPoint, C
 static std::vector<std::pair<COutPoint, CDiskTxPos>> BuildSpenderPositions(const interfaces::BlockInfo& block)
 {
     std::vector<std::pair<COutPoint, CDiskTxPos>> items;
-    items.reserve(block.data->vtx.size());
+    if (block.view) {
+        const auto& txs{block.view->GetTransactions()};
+        items.reserve(txs.size());
+        CDiskTxPos pos({block.file_number, block.data_pos}, GetSizeOfCompactSize(txs.size()));
+        for (size_t i{0}; i < txs.size(); ++i) {
+            // The first transaction of a block is the only coinbase.
+            if (i > 0) {
+                txs[i].ForEachInput([&](const TxView::Input& input) {
+                    items.emplace_back(input.prevout, pos);
+                });
+            }
+            pos.nTxOffset += txs[i].GetTotalSize();
+        }
+        return items;
+    }
 
+    items.reserve(block.data->vtx.size());
     CDiskTxPos pos({block.file_number, block.data_pos}, GetSizeOfCompactSize(block.data->vtx.size()));
     for (const auto& tx : block.data->vtx) {
         if (!tx->IsCoinBase()) {
@@ -129,9 +146,20 @@ static std::vector<std::pair<COutPoint, CDiskTxPos>> BuildSpenderPositions(const
 }
 
 
-bool TxoSpenderIndex::CustomAppend(const interfaces::BlockInfo& block)
+struct TxoSpenderIndex::PreparedSpenders : public PreparedBlock {
+    std::vector<std::pair<COutPoint, CDiskTxPos>> items;
+};
+
+std::unique_ptr<BaseIndex::PreparedBlock> TxoSpenderIndex::CustomPrepare(const interfaces::BlockInfo& block) const
+{
+    auto prepared{std::make_unique<PreparedSpenders>()};
+    prepared->items = BuildSpenderPositions(block);
+    return prepared;
+}
+
+bool TxoSpenderIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, const PreparedBlock& prepared)
 {
-    WriteSpenderInfos(BuildSpenderPositions(block));
+    WriteSpenderInfos(static_cast<const PreparedSpenders&>(prepared).items);
     return true;
 }
 
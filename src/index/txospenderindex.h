@@ -39,6 +39,11 @@ private:
     std::unique_ptr<BaseIndex::DB> m_db;
     std::pair<uint64_t, uint64_t> m_siphash_key;
     bool AllowPrune() const override { return false; }
+
+    bool AllowBlockView() const override { return true; }
+
+    /// The outpoints spent in a block, with the positions of their spenders.
+    struct PreparedSpenders;
     void WriteSpenderInfos(const std::vector<std::pair<COutPoint, CDiskTxPos>>& items);
     void EraseSpenderInfos(const std::vector<std::pair<COutPoint, CDiskTxPos>>& items);
     util::Expected<TxoSpender, std::string> ReadTransaction(const CDiskTxPos& pos) const;
@@ -46,7 +51,9 @@ private:
 protected:
     interfaces::Chain::NotifyOptions CustomOptions() override;
 
-    bool CustomAppend(const interfaces::BlockInfo& block) override;
+    std::unique_ptr<PreparedBlock> CustomPrepare(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, const PreparedBlock& prepared) override;
 
     bool CustomRemove(const interfaces::BlockInfo& block) override;
 
@@ -9,6 +9,7 @@
 
 #include <iostream>
 
+class BlockView;
 class CBlock;
 class CBlockIndex;
 class CBlockUndo;
@@ -23,6 +24,8 @@ struct BlockInfo {
     int file_number = -1;
     unsigned data_pos = 0;
     const CBlock* data = nullptr;
+    //! Raw block data, set instead of data for indexes that read blocks as BlockView.
+    const BlockView* view = nullptr;
     const CBlockUndo* undo_data = nullptr;
     // The maximum time in the chain up to and including this block.
     // A timestamp that can only move forward.
@@ -184,14 +184,14 @@ private:
     void* ptr;
 };
 
-template<typename X, typename Y>
-static inline size_t DynamicUsage(const std::unordered_set<X, Y>& s)
+template<typename X, typename Y, typename E>
+static inline size_t DynamicUsage(const std::unordered_set<X, Y, E>& s)
 {
     return MallocUsage(sizeof(unordered_node<X>)) * s.size() + MallocUsage(sizeof(void*) * s.bucket_count());
 }
 
-template<typename X, typename Y, typename Z>
-static inline size_t DynamicUsage(const std::unordered_map<X, Y, Z>& m)
+template<typename X, typename Y, typename Z, typename E>
+static inline size_t DynamicUsage(const std::unordered_map<X, Y, Z, E>& m)
 {
     return MallocUsage(sizeof(unordered_node<std::pair<const X, Y> >)) * m.size() + MallocUsage(sizeof(void*) * m.bucket_count());
 }
@@ -7,8 +7,11 @@
 #include <names/encoding.h>
 
 #include <regex>
+#include <string_view>
+#include <vector>
 
 #include <univalue.h>
+#include <univalue_escapes.h>
 
 #include <logging.h>
 
@@ -182,32 +185,179 @@ DescFromName (const valtype& name, NameNamespace ns)
     }
 }
 
+namespace
+{
+
+/** Maximum nesting depth of JSON values, as in univalue_read.cpp.  */
+constexpr size_t MAX_JSON_DEPTH = 512;
+
+/**
+ * Checks if the raw text of a string token (including the quotes) is how
+ * UniValue::write would escape its value.
+ */
 bool
-IsValidJSONOrEmptyString (const std::string& text){
-    UniValue v;
+IsCanonicalJSONString (std::string_view raw, const std::string& value)
+{
+    raw.remove_prefix (1);
+    raw.remove_suffix (1);
+
+    for (const char c : value) {
+        const char* esc = escapes[static_cast<unsigned char> (c)];
+        const std::string_view expected = esc != nullptr ? std::string_view (esc) : std::string_view (&c, 1);
+        if (!raw.starts_with (expected))
+            return false;
+        raw.remove_prefix (expected.size ());
+    }
 
-    return text.empty() || v.read(text);
+    return raw.empty ();
+}
+
+/**
+ * Checks if the text is valid JSON, accepting exactly what UniValue::read
+ * accepts, but without building up a UniValue.  If minimal is true, the
+ * text must also be exactly what UniValue::write (without indentation)
+ * produces for it, i.e. have no whitespace between tokens and only
+ * canonically escaped strings.
+ */
+bool
+CheckJSON (const std::string& text, const bool minimal)
+{
+    /* This follows the state machine of UniValue::read, except that the
+       stack only holds whether each open value is an object.  */
+    enum : unsigned {
+        EXP_OBJ_NAME = (1U << 0),
+        EXP_COLON = (1U << 1),
+        EXP_ARR_VALUE = (1U << 2),
+        EXP_VALUE = (1U << 3),
+        EXP_NOT_VALUE = (1U << 4),
+    };
+    unsigned expectMask = 0;
+    std::vector<bool> stack;
+
+    std::string tokenVal;
+    unsigned int consumed;
+    jtokentype tok = JTOK_NONE;
+    jtokentype lastTok = JTOK_NONE;
+    const char* raw = text.data ();
+    const char* const end = raw + text.size ();
+    do {
+        lastTok = tok;
+
+        tok = getJsonToken (tokenVal, consumed, raw, end);
+        if (tok == JTOK_NONE || tok == JTOK_ERR)
+            return false;
+        if (minimal) {
+            if (json_isspace (*raw))
+                return false;
+            if (tok == JTOK_STRING && !IsCanonicalJSONString (std::string_view (raw, consumed), tokenVal))
+                return false;
+        }
+        raw += consumed;
+
+        const bool isValueOpen = jsonTokenIsValue (tok) || tok == JTOK_OBJ_OPEN || tok == JTOK_ARR_OPEN;
+
+        if (expectMask & EXP_VALUE) {
+            if (!isValueOpen)
+                return false;
+            expectMask &= ~EXP_VALUE;
+        } else if (expectMask & EXP_ARR_VALUE) {
+            if (!isValueOpen && tok != JTOK_ARR_CLOSE)
+                return false;
+            expectMask &= ~EXP_ARR_VALUE;
+        } else if (expectMask & EXP_OBJ_NAME) {
+            if (tok != JTOK_OBJ_CLOSE && tok != JTOK_STRING)
+                return false;
+        } else if (expectMask & EXP_COLON) {
+            if (tok != JTOK_COLON)
+                return false;
+            expectMask &= ~EXP_COLON;
+        } else if (tok == JTOK_COLON) {
+            return false;
+        }
+
+        if (expectMask & EXP_NOT_VALUE) {
+            if (isValueOpen)
+                return false;
+            expectMask &= ~EXP_NOT_VALUE;
+        }
+
+        switch (tok) {
+            case JTOK_OBJ_OPEN:
+            case JTOK_ARR_OPEN:
+                stack.push_back (tok == JTOK_OBJ_OPEN);
+                if (stack.size () > MAX_JSON_DEPTH)
+                    return false;
+                expectMask |= (tok == JTOK_OBJ_OPEN ? EXP_OBJ_NAME : EXP_ARR_VALUE);
+                break;
+
+            case JTOK_OBJ_CLOSE:
+            case JTOK_ARR_CLOSE:
+                if (stack.empty () || lastTok == JTOK_COMMA)
+                    return false;
+                if (stack.back () != (tok == JTOK_OBJ_CLOSE))
+                    return false;
+                stack.pop_back ();
+                expectMask &= ~EXP_OBJ_NAME;
+                expectMask |= EXP_NOT_VALUE;
+                break;
+
+            case JTOK_COLON:
+                if (stack.empty () || !stack.back ())
+                    return false;
+                expectMask |= EXP_VALUE;
+                break;
+
+            case JTOK_COMMA:
+                if (stack.empty () || lastTok == JTOK_COMMA || lastTok == JTOK_ARR_OPEN)
+                    return false;
+                expectMask |= (stack.back () ? EXP_OBJ_NAME : EXP_ARR_VALUE);
+                break;
+
+            case JTOK_KW_NULL:
+            case JTOK_KW_TRUE:
+            case JTOK_KW_FALSE:
+            case JTOK_NUMBER:
+                expectMask |= EXP_NOT_VALUE;
+                break;
+
+            case JTOK_STRING:
+                if (expectMask & EXP_OBJ_NAME) {
+                    expectMask &= ~EXP_OBJ_NAME;
+                    expectMask |= EXP_COLON;
+                }
+                expectMask |= EXP_NOT_VALUE;
+                break;
+
+            default:
+                return false;
+        }
+    } while (!stack.empty ());
+
+    /* Check that nothing follows the initial value, not even whitespace
+       for minimal JSON.  */
+    if (minimal)
+        return raw == end;
+    return getJsonToken (tokenVal, consumed, raw, end) == JTOK_NONE;
+}
+
+} // anonymous namespace
+
+bool
+IsValidJSONOrEmptyString (const std::string& text){
+    return text.empty() || CheckJSON(text, false);
 }
 
 bool
 IsMinimalJSONOrEmptyString (const std::string& text){
-    UniValue v;
-    if(text.empty()){
+    if(text.empty() || CheckJSON(text, true)){
         return true;
     }
 
-    if(!v.read(text)){
-        return false;
-    }
-
-    const std::string minimalJSON = GetMinimalJSON(text);
-    const bool isMinimal = (text == minimalJSON);
-
-    if(!isMinimal){
-        LogDebug(BCLog::NAMES, "Minimalised JSON string is: %s \n", minimalJSON);
+    if(CheckJSON(text, false)){
+        LogDebug(BCLog::NAMES, "Minimalised JSON string is: %s \n", GetMinimalJSON(text));
     }
 
-    return isMinimal;
+    return false;
 }
 
 std::string
@@ -6,6 +6,8 @@
 
 #include <script/names.h>
 
+#include <algorithm>
+
 bool fNameHistory = false;
 
 /* ************************************************************************** */
@@ -39,6 +41,9 @@ class CCacheNameIterator : public CNameIterator
 
 private:
 
+  /** Type of the cache's entries.  */
+  typedef std::pair<const CNameCache::NameKey, CNameData> Entry;
+
   /** Reference to cache object that is used.  */
   const CNameCache& cache;
 
@@ -52,8 +57,15 @@ private:
   /** "Next" data of the base iterator.  */
   CNameData baseData;
 
-  /** Iterator of the cache's entries.  */
-  CNameCache::EntryMap::const_iterator cacheIter;
+  /**
+   * The cache's entries sorted in database order.  The cache itself
+   * keeps them in a hash map, so they are sorted once when the iterator
+   * is constructed.
+   */
+  std::vector<const Entry*> sortedEntries;
+
+  /** Position of the "next" entry of the cache in sortedEntries.  */
+  std::vector<const Entry*>::const_iterator cacheIter;
 
   /* Call the base iterator's next() routine to fill in the internal
      "cache" for the next entry.  This already skips entries that are
@@ -81,6 +93,17 @@ public:
 CCacheNameIterator::CCacheNameIterator (const CNameCache& c, CNameIterator* b)
   : cache(c), base(b)
 {
+  sortedEntries.reserve (cache.entries.size ());
+  for (const auto& entry : cache.entries)
+    sortedEntries.push_back (&entry);
+
+  const CNameCache::NameComparator cmp;
+  std::sort (sortedEntries.begin (), sortedEntries.end (),
+             [&cmp] (const Entry* a, const Entry* b)
+               {
+                 return cmp (a->first, b->first);
+               });
+
   /* Add a seek-to-start to ensure that everything is consistent.  This call
      may be superfluous if we seek to another position afterwards anyway,
      but it should also not hurt too much.  */
@@ -104,7 +127,13 @@ CCacheNameIterator::advanceBaseIterator ()
 void
 CCacheNameIterator::seek (const valtype& start)
 {
-  cacheIter = cache.entries.lower_bound (start);
+  const CNameCache::NameComparator cmp;
+  cacheIter = std::lower_bound (sortedEntries.begin (), sortedEntries.end (),
+                                start,
+                                [&cmp] (const Entry* a, const valtype& b)
+                                  {
+                                    return cmp (a->first, b);
+                                  });
   base->seek (start);
 
   baseHasMore = true;
@@ -116,21 +145,24 @@ CCacheNameIterator::next (valtype& name, CNameData& data)
 {
   /* Exit early if no more data is available in either the cache
      nor the base iterator.  */
-  if (!baseHasMore && cacheIter == cache.entries.end ())
+  if (!baseHasMore && cacheIter == sortedEntries.end ())
     return false;
 
   /* Determine which source to use for the next.  */
   bool useBase;
   if (!baseHasMore)
     useBase = false;
-  else if (cacheIter == cache.entries.end ())
+  else if (cacheIter == sortedEntries.end ())
     useBase = true;
   else
     {
+      const CNameCache::NameKey& cacheName = (*cacheIter)->first;
+      const CNameCache::NameComparator cmp;
+
       /* A special case is when both iterators are equal.  In this case,
          we want to use the cached version.  We also have to advance
          the base iterator.  */
-      if (baseName == cacheIter->first)
+      if (!cmp (baseName, cacheName) && !cmp (cacheName, baseName))
         advanceBaseIterator ();
 
       /* Due to advancing the base iterator above, it may happen that
@@ -139,10 +171,8 @@ CCacheNameIterator::next (valtype& name, CNameData& data)
         useBase = false;
       else
         {
-          assert (baseName != cacheIter->first);
-
-          CNameCache::NameComparator cmp;
-          useBase = cmp (baseName, cacheIter->first);
+          assert (cmp (baseName, cacheName) || cmp (cacheName, baseName));
+          useBase = cmp (baseName, cacheName);
         }
     }
 
@@ -155,8 +185,8 @@ CCacheNameIterator::next (valtype& name, CNameData& data)
     }
   else
     {
-      name = cacheIter->first;
-      data = cacheIter->second;
+      name.assign ((*cacheIter)->first.begin (), (*cacheIter)->first.end ());
+      data = (*cacheIter)->second;
       ++cacheIter;
     }
 
@@ -166,10 +196,27 @@ CCacheNameIterator::next (valtype& name, CNameData& data)
 /* ************************************************************************** */
 /* CNameCache.  */
 
+CNameCache::CNameCache ()
+  : CNameCache (NameHasher (SaltedSipHasher ()))
+{}
+
+CNameCache::CNameCache (const NameHasher& hasher)
+  : entries(0, hasher), deleted(0, hasher), history(0, hasher)
+{}
+
+size_t
+CNameCache::DynamicMemoryUsage () const
+{
+  return memusage::DynamicUsage (entries) + memusage::DynamicUsage (deleted)
+          + memusage::DynamicUsage (history)
+          + memusage::DynamicUsage (expireIndex)
+          + cachedUsage;
+}
+
 bool
 CNameCache::get (const valtype& name, CNameData& data) const
 {
-  const EntryMap::const_iterator i = entries.find (name);
+  const auto i = entries.find (name);
   if (i == entries.end ())
     return false;
 
@@ -177,28 +224,60 @@ CNameCache::get (const valtype& name, CNameData& data) const
   return true;
 }
 
-void
-CNameCache::set (const valtype& name, const CNameData& data)
+template<typename Name>
+  void
+  CNameCache::setEntry (const Name& name, const CNameData& data)
 {
-  const std::set<valtype>::iterator di = deleted.find (name);
+  const auto di = deleted.find (name);
   if (di != deleted.end ())
-    deleted.erase (di);
+    {
+      cachedUsage -= memusage::DynamicUsage (*di);
+      deleted.erase (di);
+    }
 
-  const EntryMap::iterator ei = entries.find (name);
+  auto ei = entries.find (name);
   if (ei != entries.end ())
-    ei->second = data;
+    {
+      cachedUsage -= ei->second.DynamicMemoryUsage ();
+      ei->second = data;
+    }
   else
-    entries.insert (std::make_pair (name, data));
+    {
+      ei = entries.emplace (NameKey (name.begin (), name.end ()), data).first;
+      cachedUsage += memusage::DynamicUsage (ei->first);
+    }
+  cachedUsage += ei->second.DynamicMemoryUsage ();
 }
 
 void
-CNameCache::remove (const valtype& name)
+CNameCache::set (const valtype& name, const CNameData& data)
+{
+  setEntry (name, data);
+}
+
+template<typename Name>
+  void
+  CNameCache::removeEntry (const Name& name)
 {
-  const EntryMap::iterator ei = entries.find (name);
+  const auto ei = entries.find (name);
   if (ei != entries.end ())
-    entries.erase (ei);
+    {
+      cachedUsage -= memusage::DynamicUsage (ei->first)
+                      + ei->second.DynamicMemoryUsage ();
+      entries.erase (ei);
+    }
+
+  if (!deleted.contains (name))
+    {
+      const auto di = deleted.emplace (name.begin (), name.end ()).first;
+      cachedUsage += memusage::DynamicUsage (*di);
+    }
+}
 
-  deleted.insert (name);
+void
+CNameCache::remove (const valtype& name)
+{
+  removeEntry (name);
 }
 
 CNameIterator*
@@ -212,7 +291,7 @@ CNameCache::getHistory (const valtype& name, CNameHistory& res) const
 {
   assert (fNameHistory);
 
-  const std::map<valtype, CNameHistory>::const_iterator i = history.find (name);
+  const auto i = history.find (name);
   if (i == history.end ())
     return false;
 
@@ -220,72 +299,143 @@ CNameCache::getHistory (const valtype& name, CNameHistory& res) const
   return true;
 }
 
-void
-CNameCache::setHistory (const valtype& name, const CNameHistory& data)
+template<typename Name>
+  void
+  CNameCache::setHistoryEntry (const Name& name, const CNameHistory& data)
 {
   assert (fNameHistory);
 
-  const std::map<valtype, CNameHistory>::iterator ei = history.find (name);
+  auto ei = history.find (name);
   if (ei != history.end ())
-    ei->second = data;
+    {
+      cachedUsage -= ei->second.DynamicMemoryUsage ();
+      ei->second = data;
+    }
   else
-    history.insert (std::make_pair (name, data));
+    {
+      ei = history.emplace (NameKey (name.begin (), name.end ()), data).first;
+      cachedUsage += memusage::DynamicUsage (ei->first);
+    }
+  cachedUsage += ei->second.DynamicMemoryUsage ();
+}
+
+void
+CNameCache::setHistory (const valtype& name, const CNameHistory& data)
+{
+  setHistoryEntry (name, data);
 }
 
 void
 CNameCache::updateNamesForHeight (unsigned nHeight,
                                   std::set<valtype>& names) const
 {
-  /* Seek in the map of cached entries to the first one corresponding
-     to our height.  */
+  const auto it = expireIndex.find (nHeight);
+  if (it == expireIndex.end ())
+    return;
 
-  const ExpireEntry seekEntry(nHeight, valtype ());
-  std::map<ExpireEntry, bool>::const_iterator it;
+  for (const auto& [name, add] : it->second)
+    {
+      valtype nm(name.begin (), name.end ());
+      if (add)
+        names.insert (std::move (nm));
+      else
+        names.erase (nm);
+    }
+}
 
-  for (it = expireIndex.lower_bound (seekEntry); it != expireIndex.end (); ++it)
+void
+CNameCache::setExpireIndex (const unsigned height, const NameKey& name,
+                            const bool add)
+{
+  ExpireChanges& changes = expireIndex[height];
+  const auto it = std::lower_bound (changes.begin (), changes.end (), name,
+                                    [] (const auto& entry, const NameKey& n)
+                                      {
+                                        return entry.first < n;
+                                      });
+  if (it != changes.end () && it->first == name)
     {
-      const ExpireEntry& cur = it->first;
-      assert (cur.nHeight >= nHeight);
-      if (cur.nHeight > nHeight)
-        break;
+      it->second = add;
+      return;
+    }
+
+  cachedUsage -= memusage::DynamicUsage (changes);
+  changes.emplace (it, name, add);
+  cachedUsage += memusage::DynamicUsage (changes)
+                  + memusage::DynamicUsage (name);
+}
 
-      if (it->second)
-        names.insert (cur.name);
+void
+CNameCache::mergeExpireIndex (const unsigned height,
+                              const ExpireChanges& changes)
+{
+  ExpireChanges& mine = expireIndex[height];
+  if (mine.empty ())
+    {
+      cachedUsage -= memusage::DynamicUsage (mine);
+      mine = changes;
+      cachedUsage += memusage::DynamicUsage (mine);
+      for (const auto& entry : mine)
+        cachedUsage += memusage::DynamicUsage (entry.first);
+      return;
+    }
+
+  ExpireChanges merged;
+  merged.reserve (mine.size () + changes.size ());
+  auto a = mine.begin ();
+  auto b = changes.begin ();
+  while (a != mine.end () || b != changes.end ())
+    {
+      if (b == changes.end () || (a != mine.end () && a->first < b->first))
+        {
+          merged.push_back (std::move (*a));
+          ++a;
+          continue;
+        }
+
+      /* The other cache's change wins over ours for the same name.  */
+      if (a != mine.end () && a->first == b->first)
+        {
+          merged.emplace_back (std::move (a->first), b->second);
+          ++a;
+        }
       else
-        names.erase (cur.name);
+        {
+          merged.push_back (*b);
+          cachedUsage += memusage::DynamicUsage (b->first);
+        }
+      ++b;
     }
+
+  cachedUsage -= memusage::DynamicUsage (mine);
+  mine = std::move (merged);
+  cachedUsage += memusage::DynamicUsage (mine);
 }
 
 void
 CNameCache::addExpireIndex (const valtype& name, unsigned height)
 {
-  const ExpireEntry entry(height, name);
-  expireIndex[entry] = true;
+  setExpireIndex (height, NameKey (name.begin (), name.end ()), true);
 }
 
 void
 CNameCache::removeExpireIndex (const valtype& name, unsigned height)
 {
-  const ExpireEntry entry(height, name);
-  expireIndex[entry] = false;
+  setExpireIndex (height, NameKey (name.begin (), name.end ()), false);
 }
 
 void
 CNameCache::apply (const CNameCache& cache)
 {
-  for (EntryMap::const_iterator i = cache.entries.begin ();
-       i != cache.entries.end (); ++i)
-    set (i->first, i->second);
+  for (const auto& [name, data] : cache.entries)
+    setEntry (name, data);
 
-  for (std::set<valtype>::const_iterator i = cache.deleted.begin ();
-       i != cache.deleted.end (); ++i)
-    remove (*i);
+  for (const auto& name : cache.deleted)
+    removeEntry (name);
 
-  for (std::map<valtype, CNameHistory>::const_iterator i
-        = cache.history.begin (); i != cache.history.end (); ++i)
-    setHistory (i->first, i->second);
+  for (const auto& [name, data] : cache.history)
+    setHistoryEntry (name, data);
 
-  for (std::map<ExpireEntry, bool>::const_iterator i
-        = cache.expireIndex.begin (); i != cache.expireIndex.end (); ++i)
-    expireIndex[i->first] = i->second;
+  for (const auto& [height, changes] : cache.expireIndex)
+    mergeExpireIndex (height, changes);
 }
@@ -6,12 +6,21 @@
 #define H_BITCOIN_NAMES_COMMON
 
 #include <compat/endian.h>
+#include <memusage.h>
+#include <prevector.h>
 #include <primitives/transaction.h>
 #include <script/script.h>
 #include <serialize.h>
+#include <util/hasher.h>
 
+#include <algorithm>
 #include <map>
 #include <set>
+#include <span>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 class CNameScript;
 class CDBBatch;
@@ -105,6 +114,16 @@ public:
     return addr;
   }
 
+  /**
+   * Get the memory used by the data on the heap.
+   * @return The dynamic memory usage in bytes.
+   */
+  inline size_t
+  DynamicMemoryUsage () const
+  {
+    return memusage::DynamicUsage (value) + memusage::DynamicUsage (addr);
+  }
+
   /**
    * Check if the name is expired at the given height.
    * @param h The height at which to check.
@@ -165,6 +184,19 @@ public:
     return data;
   }
 
+  /**
+   * Get the memory used by the stack on the heap.
+   * @return The dynamic memory usage in bytes.
+   */
+  inline size_t
+  DynamicMemoryUsage () const
+  {
+    size_t res = memusage::DynamicUsage (data);
+    for (const auto& entry : data)
+      res += entry.DynamicMemoryUsage ();
+    return res;
+  }
+
   /**
    * Push a new entry onto the data stack.  The new entry's height should
    * be at least as high as the stack top entry's.  If not, fail.
@@ -226,30 +258,100 @@ public:
  * Cache / record of updates to the name database.  In addition to
  * new names (or updates to them), this also keeps track of deleted names
  * (when rolling back changes).
+ *
+ * The records are kept in hash maps, since they are looked up for every
+ * name operation when connecting blocks.  Iteration in database order
+ * sorts the cached entries on demand.
  */
 class CNameCache
 {
 
-private:
+public:
 
   /**
    * Special comparator class for names that compares by length first.
-   * This is used to sort the cache entry map in the same way as the
-   * database is sorted.
+   * This is used to sort the cached entries in the same way as the
+   * database is sorted.  It accepts all kinds of byte ranges.
    */
   class NameComparator
   {
   public:
-    inline bool
-    operator() (const valtype& a, const valtype& b) const
+    template<typename A, typename B>
+      inline bool
+      operator() (const A& a, const B& b) const
     {
       if (a.size () != b.size ())
         return a.size () < b.size ();
 
-      return a < b;
+      return std::lexicographical_compare (a.begin (), a.end (),
+                                           b.begin (), b.end ());
+    }
+  };
+
+  /**
+   * Type for names as stored in the cache.  Most names are short enough to
+   * be kept inline, without a separate heap allocation.
+   */
+  typedef prevector<32, unsigned char> NameKey;
+
+private:
+
+  /**
+   * Salted hasher for the names in the cache.  It accepts valtype as well
+   * as NameKey, so that lookups do not need to convert the name.
+   */
+  class NameHasher
+  {
+  private:
+    SaltedSipHasher hasher;
+  public:
+    using is_transparent = void;
+
+    explicit NameHasher (const SaltedSipHasher& h)
+      : hasher(h)
+    {}
+
+    inline size_t
+    operator() (const NameKey& name) const
+    {
+      return hasher (std::span<const unsigned char> (name.data (),
+                                                     name.size ()));
+    }
+
+    inline size_t
+    operator() (const valtype& name) const
+    {
+      return hasher (name);
+    }
+  };
+
+  /** Equality comparison matching NameHasher.  */
+  class NameEqual
+  {
+  public:
+    using is_transparent = void;
+
+    template<typename A, typename B>
+      inline bool
+      operator() (const A& a, const B& b) const
+    {
+      return std::equal (a.begin (), a.end (), b.begin (), b.end ());
     }
   };
 
+  template<typename T>
+    using NameMap = std::unordered_map<NameKey, T, NameHasher, NameEqual>;
+  typedef std::unordered_set<NameKey, NameHasher, NameEqual> NameSet;
+
+  /**
+   * Changes to the expire index at one height.  Each name is mapped to
+   * either "true" (meaning to add the entry) or "false" (delete).  Only the
+   * names updated in a single block end up in the same list, so it is short
+   * and kept as flat vector, sorted by name so that single changes can be
+   * found by binary search and whole lists merged in linear time.
+   */
+  typedef std::vector<std::pair<NameKey, bool>> ExpireChanges;
+
 public:
 
   /**
@@ -324,43 +426,78 @@ public:
   };
 
   /**
-   * Type of name entry map.  This is public because it is also used
-   * by the unit tests.
+   * Ordered map of names to their data, sorted in the same way as the
+   * database.  This is used by the unit tests.
    */
   typedef std::map<valtype, CNameData, NameComparator> EntryMap;
 
 private:
 
   /** New or updated names.  */
-  EntryMap entries;
+  NameMap<CNameData> entries;
   /** Deleted names.  */
-  std::set<valtype> deleted;
+  NameSet deleted;
 
   /**
    * New or updated history stacks.  If they are empty, the corresponding
    * database entry is deleted instead.
    */
-  std::map<valtype, CNameHistory> history;
+  NameMap<CNameHistory> history;
+
+  /** Changes to be performed to the expire index, by height.  */
+  std::unordered_map<unsigned, ExpireChanges> expireIndex;
 
   /**
-   * Changes to be performed to the expire index.  The entry is mapped
-   * to either "true" (meaning to add it) or "false" (delete).
+   * Heap memory used by the names and data stored in the maps above (not
+   * counting their nodes, which is derived from their sizes).  This is
+   * kept up-to-date on every change, so that DynamicMemoryUsage is cheap.
    */
-  std::map<ExpireEntry, bool> expireIndex;
+  size_t cachedUsage = 0;
 
   friend class CCacheNameIterator;
 
+  explicit CNameCache (const NameHasher& hasher);
+
+  /* Implementations of set, remove and setHistory, which also accept
+     names as NameKey (e.g. when applying another cache).  */
+  template<typename Name>
+    void setEntry (const Name& name, const CNameData& data);
+  template<typename Name>
+    void removeEntry (const Name& name);
+  template<typename Name>
+    void setHistoryEntry (const Name& name, const CNameHistory& data);
+
+  /* Set an expire-index entry to be added or deleted.  */
+  void setExpireIndex (unsigned height, const NameKey& name, bool add);
+  /* Merge the sorted expire-index changes of another cache for a height.  */
+  void mergeExpireIndex (unsigned height, const ExpireChanges& changes);
+
 public:
 
+  CNameCache ();
+
   inline void
   clear ()
   {
+    /* The maps are also rehashed, so that their bucket arrays shrink back
+       and the usage is that of an empty cache.  */
     entries.clear ();
+    entries.rehash (0);
     deleted.clear ();
+    deleted.rehash (0);
     history.clear ();
+    history.rehash (0);
     expireIndex.clear ();
+    expireIndex.rehash (0);
+    cachedUsage = 0;
   }
 
+  /**
+   * Get the total memory used by the cached changes.
+   * @return The dynamic memory usage in bytes.
+   */
+  size_t DynamicMemoryUsage () const;
+
   /**
    * Check if the cache is "clean" (no cached changes).  This also
    * performs internal checks and fails with an assertion if the
@@ -383,7 +520,7 @@ public:
   inline bool
   isDeleted (const valtype& name) const
   {
-    return (deleted.count (name) > 0);
+    return deleted.contains (name);
   }
 
   /* Try to get a name's associated data.  This looks only
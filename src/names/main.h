@@ -11,6 +11,7 @@
 #include <script/verify_flags.h>
 #include <serialize.h>
 
+#include <cassert>
 #include <set>
 
 class CBlockUndo;
@@ -53,6 +54,20 @@ private:
 
 public:
 
+  CNameTxUndo () = default;
+
+  /**
+   * Construct undo data restoring the given old state of a name.
+   * @param nm The name this concerns.
+   * @param old The name's old data, or nullptr if it did not exist before.
+   */
+  CNameTxUndo (const valtype& nm, const CNameData* old)
+    : name(nm), isNew(old == nullptr)
+  {
+    if (old != nullptr)
+      oldData = *old;
+  }
+
   SERIALIZE_METHODS (CNameTxUndo, obj)
   {
     READWRITE (obj.name, obj.isNew);
@@ -60,6 +75,29 @@ public:
       READWRITE (obj.oldData);
   }
 
+  inline const valtype&
+  getName () const
+  {
+    return name;
+  }
+
+  inline bool
+  isNewName () const
+  {
+    return isNew;
+  }
+
+  /**
+   * Return the old name data.  Only valid if this is not a new name.
+   * @return The data that is restored by the undo.
+   */
+  inline const CNameData&
+  getOldData () const
+  {
+    assert (!isNew);
+    return oldData;
+  }
+
   /**
    * Set the data for an update/registration of the given name.  The CCoinsView
    * is used to find out all the necessary information.
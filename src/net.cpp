@@ -2137,8 +2137,12 @@ void CConnman::SocketHandler()
         // listening sockets in one call ("readiness" as in poll(2) or
         // select(2)). If none are ready, wait for a short while and return
         // empty sets.
+        //
+        // The sockets to wait for are collected from all nodes on every
+        // iteration, and all nodes are serviced below. m_sock_poller only
+        // keeps the kernel from scanning every socket on each wait.
         events_per_sock = GenerateWaitSockets(snap.Nodes());
-        if (events_per_sock.empty() || !events_per_sock.begin()->first->WaitMany(timeout, events_per_sock)) {
+        if (events_per_sock.empty() || !events_per_sock.begin()->first->WaitManyPersistent(timeout, events_per_sock, m_sock_poller)) {
             m_interrupt_net->sleep_for(timeout);
         }
 
@@ -2282,9 +2286,9 @@ void CConnman::WakeMessageHandler()
 {
     {
         LOCK(mutexMsgProc);
-        fMsgProcWake = true;
+        ++m_msgproc_wakeups;
     }
-    condMsgProc.notify_one();
+    condMsgProc.notify_all();
 }
 
 void CConnman::ThreadDNSAddressSeed()
@@ -3213,11 +3217,12 @@ std::optional<Proxy> CConnman::PrivateBroadcast::ProxyForIPv4or6() const
 
 Mutex NetEventsInterface::g_msgproc_mutex;
 
-void CConnman::ThreadMessageHandler()
+void CConnman::ThreadMessageHandler(int shard)
 {
     AssertLockNotHeld(m_nodes_mutex);
+    AssertLockNotHeld(NetEventsInterface::g_msgproc_mutex);
 
-    LOCK(NetEventsInterface::g_msgproc_mutex);
+    uint64_t wakeups_seen{WITH_LOCK(mutexMsgProc, return m_msgproc_wakeups)};
 
     while (!flagInterruptMsgProc)
     {
@@ -3230,9 +3235,15 @@ void CConnman::ThreadMessageHandler()
             const NodesSnapshot snap{*this, /*shuffle=*/true};
 
             for (CNode* pnode : snap.Nodes()) {
-                if (pnode->fDisconnect)
+                if (pnode->fDisconnect || pnode->GetId() % m_msghandler_threads != shard)
                     continue;
 
+                // Decode the next message before taking g_msgproc_mutex, so
+                // that the other shards can process their peers meanwhile.
+                m_msgproc->PrepareMessages(*pnode);
+
+                LOCK(NetEventsInterface::g_msgproc_mutex);
+
                 // Receive messages
                 bool fMoreNodeWork{m_msgproc->ProcessMessages(*pnode, flagInterruptMsgProc)};
                 fMoreWork |= (fMoreNodeWork && !pnode->fPauseSend);
@@ -3248,9 +3259,9 @@ void CConnman::ThreadMessageHandler()
 
         WAIT_LOCK(mutexMsgProc, lock);
         if (!fMoreWork) {
-            condMsgProc.wait_until(lock, std::chrono::steady_clock::now() + std::chrono::milliseconds(100), [this]() EXCLUSIVE_LOCKS_REQUIRED(mutexMsgProc) { return fMsgProcWake; });
+            condMsgProc.wait_until(lock, std::chrono::steady_clock::now() + std::chrono::milliseconds(100), [&]() EXCLUSIVE_LOCKS_REQUIRED(mutexMsgProc) { return m_msgproc_wakeups != wakeups_seen; });
         }
-        fMsgProcWake = false;
+        wakeups_seen = m_msgproc_wakeups;
     }
 }
 
@@ -3612,10 +3623,6 @@ bool CConnman::Start(CScheduler& scheduler, const Options& connOptions)
     m_interrupt_net->reset();
     flagInterruptMsgProc = false;
 
-    {
-        LOCK(mutexMsgProc);
-        fMsgProcWake = false;
-    }
 
     // Send and receive from sockets, accept connections
     threadSocketHandler = std::thread(&util::TraceThread, "net", [this] { ThreadSocketHandler(); });
@@ -3643,7 +3650,13 @@ bool CConnman::Start(CScheduler& scheduler, const Options& connOptions)
     }
 
     // Process messages
-    threadMessageHandler = std::thread(&util::TraceThread, "msghand", [this] { ThreadMessageHandler(); });
+    if (m_msghandler_threads == 1) {
+        m_message_handler_threads.emplace_back(&util::TraceThread, "msghand", [this] { ThreadMessageHandler(/*shard=*/0); });
+    } else {
+        for (int shard = 0; shard < m_msghandler_threads; ++shard) {
+            m_message_handler_threads.emplace_back(&util::TraceThread, strprintf("msghand.%i", shard), [this, shard] { ThreadMessageHandler(shard); });
+        }
+    }
 
     if (m_i2p_sam_session) {
         threadI2PAcceptIncoming =
@@ -3717,8 +3730,10 @@ void CConnman::StopThreads()
     if (threadI2PAcceptIncoming.joinable()) {
         threadI2PAcceptIncoming.join();
     }
-    if (threadMessageHandler.joinable())
-        threadMessageHandler.join();
+    for (std::thread& thread : m_message_handler_threads) {
+        thread.join();
+    }
+    m_message_handler_threads.clear();
     if (threadOpenConnections.joinable())
         threadOpenConnections.join();
     if (threadOpenAddedConnections.joinable())
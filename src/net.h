@@ -93,6 +93,10 @@ inline const std::string DEFAULT_MAX_UPLOAD_TARGET{"0M"};
 inline constexpr bool DEFAULT_BLOCKSONLY = false;
 /** -peertimeout default */
 inline constexpr int64_t DEFAULT_PEER_CONNECT_TIMEOUT = 60;
+/** Default number of message handler threads (-msghandlerthreads). */
+inline constexpr int DEFAULT_MSGHANDLER_THREADS{1};
+/** Maximum number of message handler threads. */
+inline constexpr int MAX_MSGHANDLER_THREADS{16};
 /** Default for -privatebroadcast. */
 inline constexpr bool DEFAULT_PRIVATE_BROADCAST{false};
 /** Number of file descriptors required for message capture **/
@@ -1061,6 +1065,16 @@ public:
      */
     virtual bool HasAllDesirableServiceFlags(ServiceFlags services) const = 0;
 
+    /**
+     * Take the next protocol message received from a given node off its queue
+     * and do the part of processing it that needs no shared state, so that
+     * this can run for different nodes in parallel. ProcessMessages() picks
+     * it up from there.
+     *
+     * @param[in]   node            The node which we have received messages from.
+     */
+    virtual void PrepareMessages(CNode& node) EXCLUSIVE_LOCKS_REQUIRED(!g_msgproc_mutex) = 0;
+
     /**
      * Process protocol messages received from a given node
      *
@@ -1103,6 +1117,7 @@ public:
         unsigned int nReceiveFloodSize = 0;
         uint64_t nMaxOutboundLimit = 0;
         int64_t m_peer_connect_timeout = DEFAULT_PEER_CONNECT_TIMEOUT;
+        int m_msghandler_threads = DEFAULT_MSGHANDLER_THREADS;
         std::vector<std::string> vSeedNodes;
         std::vector<NetWhitelistPermissions> vWhitelistedRangeIncoming;
         std::vector<NetWhitelistPermissions> vWhitelistedRangeOutgoing;
@@ -1139,6 +1154,7 @@ public:
         nSendBufferMaxSize = connOptions.nSendBufferMaxSize;
         nReceiveFloodSize = connOptions.nReceiveFloodSize;
         m_peer_connect_timeout = std::chrono::seconds{connOptions.m_peer_connect_timeout};
+        m_msghandler_threads = std::clamp(connOptions.m_msghandler_threads, 1, MAX_MSGHANDLER_THREADS);
         {
             LOCK(m_total_bytes_sent_mutex);
             nMaxOutboundLimit = connOptions.nMaxOutboundLimit;
@@ -1478,7 +1494,13 @@ private:
                                  !m_unused_i2p_sessions_mutex);
 
     /// \anchor msghand
-    void ThreadMessageHandler() EXCLUSIVE_LOCKS_REQUIRED(!m_nodes_mutex, !mutexMsgProc);
+    /**
+     * Process the messages of the nodes pinned to the given shard, see
+     * m_msghandler_threads. PrepareMessages() runs in parallel across the
+     * shards, while ProcessMessages() and SendMessages() take turns on
+     * g_msgproc_mutex one node at a time.
+     */
+    void ThreadMessageHandler(int shard) EXCLUSIVE_LOCKS_REQUIRED(!m_nodes_mutex, !mutexMsgProc, !NetEventsInterface::g_msgproc_mutex);
     /// \anchor i2paccept
     void ThreadI2PAcceptIncoming() EXCLUSIVE_LOCKS_REQUIRED(!m_nodes_mutex);
     void ThreadPrivateBroadcast() EXCLUSIVE_LOCKS_REQUIRED(!m_nodes_mutex, !m_unused_i2p_sessions_mutex);
@@ -1644,6 +1666,12 @@ private:
     // P2P timeout in seconds
     std::chrono::seconds m_peer_connect_timeout;
 
+    /**
+     * Number of message handler threads. Nodes are pinned to one of them by
+     * their id, so that the messages of a node are handled in order.
+     */
+    int m_msghandler_threads{DEFAULT_MSGHANDLER_THREADS};
+
     // Whitelisted ranges. Any node connecting from these is automatically
     // whitelisted (as well as those connecting to whitelisted binds).
     std::vector<NetWhitelistPermissions> vWhitelistedRangeIncoming;
@@ -1757,8 +1785,8 @@ private:
     /** SipHasher seeds for deterministic randomness */
     const uint64_t nSeed0, nSeed1;
 
-    /** flag for waking the message processor. */
-    bool fMsgProcWake GUARDED_BY(mutexMsgProc);
+    /** Counter of wakeups of the message processor, so that each of its threads sees all of them. */
+    uint64_t m_msgproc_wakeups GUARDED_BY(mutexMsgProc){0};
 
     std::condition_variable condMsgProc;
     Mutex mutexMsgProc;
@@ -1777,11 +1805,18 @@ private:
      */
     std::unique_ptr<i2p::sam::Session> m_i2p_sam_session;
 
+    /**
+     * Keeps the sockets of the connections and the listening sockets registered
+     * with the kernel between the iterations of SocketHandler(), the only user.
+     * SocketHandler() itself still visits every node on each iteration.
+     */
+    SockPoller m_sock_poller;
+
     std::thread threadDNSAddressSeed;
     std::thread threadSocketHandler;
     std::thread threadOpenAddedConnections;
     std::thread threadOpenConnections;
-    std::thread threadMessageHandler;
+    std::vector<std::thread> m_message_handler_threads;
     std::thread threadI2PAcceptIncoming;
     std::thread threadPrivateBroadcast;
 
@@ -59,6 +59,7 @@
 #include <util/check.h>
 #include <util/hasher.h>
 #include <util/strencodings.h>
+#include <util/threadpool.h>
 #include <util/time.h>
 #include <util/tokenbucket.h>
 #include <util/trace.h>
@@ -206,6 +207,38 @@ static constexpr auto PRIVATE_BROADCAST_MAX_CONNECTION_LIFETIME{3min};
 
 // Internal stuff
 namespace {
+/** A block that is read from disk to answer a peer's getdata request. */
+struct PendingBlockRead {
+    const CInv inv;
+    const CBlockIndex* const pindex;
+    const FlatFilePos pos;
+    /** Active chain tip when the request was processed, for the continuation inv. */
+    const uint256 tip_hash;
+    /** Set by the reading thread once m_data is filled in. */
+    std::atomic<bool> m_done{false};
+    node::BlockManager::ReadServedBlockResult m_data{util::Unexpected{node::ReadRawError::IO}};
+
+    PendingBlockRead(const CInv& inv_in, const CBlockIndex* pindex_in, const FlatFilePos& pos_in, const uint256& tip_hash_in)
+        : inv{inv_in}, pindex{pindex_in}, pos{pos_in}, tip_hash{tip_hash_in} {}
+};
+
+/**
+ * Payload of a message that has been deserialized ahead of processing,
+ * for the message types where that is costly and needs no shared state.
+ */
+struct DecodedPayload {
+    CTransactionRef tx;
+    std::shared_ptr<CBlock> block;
+};
+
+/** A message that PrepareMessages() took off a peer's receive queue. */
+struct PreparedMessage {
+    CNetMessage msg;
+    /** Whether there were more messages left in the queue. */
+    bool more;
+    DecodedPayload decoded;
+};
+
 /** Blocks that are in flight, and that are in the queue to be downloaded. */
 struct QueuedBlock {
     /** BlockIndex. We must have this since we only request blocks when we've already validated the header. */
@@ -271,8 +304,9 @@ struct Peer {
      * Most peers use headers-first syncing, which doesn't use this mechanism */
     uint256 m_continuation_block GUARDED_BY(m_block_inv_mutex) {};
 
-    /** Set to true once initial VERSION message was sent (only relevant for outbound peers). */
-    bool m_outbound_version_message_sent GUARDED_BY(NetEventsInterface::g_msgproc_mutex){false};
+    /** Set to true once initial VERSION message was sent (only relevant for outbound peers).
+     * Atomic, as PrepareMessages() reads it without g_msgproc_mutex. */
+    std::atomic<bool> m_outbound_version_message_sent{false};
 
     /** The pong reply we're expecting, or 0 if no pong expected. */
     std::atomic<uint64_t> m_ping_nonce_sent{0};
@@ -394,6 +428,13 @@ struct Peer {
     Mutex m_getdata_requests_mutex;
     /** Work queue of items requested by this peer **/
     std::deque<CInv> m_getdata_requests GUARDED_BY(m_getdata_requests_mutex);
+    /** Block read that has to complete before further getdata items are served **/
+    std::shared_ptr<PendingBlockRead> m_pending_block_read GUARDED_BY(m_getdata_requests_mutex);
+
+    /** Protects m_prepared_msg **/
+    Mutex m_prepared_msg_mutex;
+    /** Next message to process, if already taken off the receive queue by PrepareMessages() **/
+    std::optional<PreparedMessage> m_prepared_msg GUARDED_BY(m_prepared_msg_mutex);
 
     /** Time of the last getheaders message to this peer */
     NodeClock::time_point m_last_getheaders_timestamp GUARDED_BY(NetEventsInterface::g_msgproc_mutex){};
@@ -589,6 +630,7 @@ public:
     void InitializeNode(const CNode& node, ServiceFlags our_services) override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_tx_download_mutex);
     void FinalizeNode(const CNode& node) override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_headers_presync_mutex, !m_tx_download_mutex);
     bool HasAllDesirableServiceFlags(ServiceFlags services) const override;
+    void PrepareMessages(CNode& node) override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !g_msgproc_mutex);
     bool ProcessMessages(CNode& node, std::atomic<bool>& interrupt) override
         EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_most_recent_block_mutex, !m_headers_presync_mutex, g_msgproc_mutex, !m_tx_download_mutex, !m_inv_to_send_mutex);
     bool SendMessages(CNode& node) override
@@ -618,7 +660,7 @@ public:
 
 private:
     void ProcessMessage(Peer& peer, CNode& pfrom, const std::string& msg_type, DataStream& vRecv, NodeClock::time_point time_received,
-                        const std::atomic<bool>& interruptMsgProc)
+                        const std::atomic<bool>& interruptMsgProc, DecodedPayload decoded = {})
         EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_most_recent_block_mutex, !m_headers_presync_mutex, g_msgproc_mutex, !m_tx_download_mutex, !m_inv_to_send_mutex);
 
     /** Consider evicting an outbound peer based on the amount of time they've been behind our tip */
@@ -1115,7 +1157,13 @@ private:
     bool BlockRequestAllowed(const CBlockIndex& block_index) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     bool AlreadyHaveBlock(const uint256& block_hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     void ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv& inv)
-        EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex, !m_most_recent_block_mutex);
+        EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex, peer.m_getdata_requests_mutex, !m_most_recent_block_mutex);
+    /** Send a block read on the block read pool (or synchronously) to the peer. */
+    void FinishBlockRead(CNode& pfrom, Peer& peer, const PendingBlockRead& read)
+        EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex);
+    /** Announce our tip after the peer got the last block of a getblocks batch. */
+    void MaybeSendContinuationInv(CNode& pfrom, Peer& peer, const uint256& block_hash, const uint256& tip_hash)
+        EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex);
 
     /**
      * Validation logic for compact filters request handling.
@@ -1199,6 +1247,11 @@ private:
     std::optional<NodeClock::time_point> m_next_inv_bucket_heartbeat GUARDED_BY(m_inv_to_send_mutex);
 
     void ProcessInvBacklog(NodeClock::time_point now, bool backlog_bumped=false) EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_inv_to_send_mutex);
+
+    /** Threads reading blocks requested by peers from disk, so that the
+     *  message handler does not wait for the I/O.  Declared last, so that
+     *  it is stopped before anything its tasks use is destroyed. */
+    ThreadPool m_block_read_pool{"blockread"};
 };
 
 const CNodeState* PeerManagerImpl::State(NodeId pnode) const
@@ -2163,6 +2216,10 @@ void PeerManagerImpl::StartScheduledTasks(CScheduler& scheduler)
     static_assert(EXTRA_PEER_CHECK_INTERVAL < STALE_CHECK_INTERVAL, "peer eviction timer should be less than stale tip check timer");
     scheduler.scheduleEvery([this] { this->CheckForStaleTipAndEvictPeers(); }, std::chrono::seconds{EXTRA_PEER_CHECK_INTERVAL});
 
+    if (m_opts.block_read_threads > 0) {
+        m_block_read_pool.Start(m_opts.block_read_threads);
+    }
+
     // schedule next run for 10-15 minutes in the future
     const auto delta = 10min + FastRandomContext().randrange<std::chrono::milliseconds>(5min);
     scheduler.scheduleFromNow([&] { ReattemptInitialBroadcast(scheduler); }, delta);
@@ -2649,19 +2706,28 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv&
         pblock = a_recent_block;
     } else if (inv.IsMsgWitnessBlk()) {
         // Fast-path: in this case it is possible to serve the block directly from disk,
-        // as the network format matches the format on disk
-        if (const auto block_data{m_chainman.m_blockman.ReadRawBlock(block_pos)}) {
-            MakeAndPushMessage(pfrom, NetMsgType::BLOCK, std::span{*block_data});
-        } else {
-            if (WITH_LOCK(m_chainman.GetMutex(), return m_chainman.m_blockman.IsBlockPruned(*pindex))) {
-                LogDebug(BCLog::NET, "Block was pruned before it could be read, %s", pfrom.DisconnectMsg());
-            } else {
-                LogError("Cannot load block from disk, %s", pfrom.DisconnectMsg());
+        // as the network format matches the format on disk.  The read is done on the
+        // block read pool if possible, and ProcessGetData sends the block once it is done.
+        auto read{std::make_shared<PendingBlockRead>(inv, pindex, block_pos, tip->GetBlockHash())};
+        const auto read_block{[this, read] {
+            try {
+                read->m_data = m_chainman.m_blockman.ReadServedBlock(read->inv.hash, read->pos);
+            } catch (const std::exception& e) {
+                LogError("Failed to read block %s: %s", read->inv.hash.ToString(), e.what());
             }
-            pfrom.fDisconnect = true;
-            return;
+            read->m_done = true;
+        }};
+        if (m_block_read_pool.Submit([this, read_block] {
+                read_block();
+                m_connman.WakeMessageHandler();
+            })) {
+            peer.m_pending_block_read = std::move(read);
+        } else {
+            read_block();
+            FinishBlockRead(pfrom, peer, *read);
         }
-        // Don't set pblock as we've sent the block
+        // The block (and continuation) is sent by FinishBlockRead
+        return;
     } else {
         // Send block from disk
         std::shared_ptr<CBlock> pblockRead = std::make_shared<CBlock>();
@@ -2722,18 +2788,36 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv&
         }
     }
 
-    {
-        LOCK(peer.m_block_inv_mutex);
-        // Trigger the peer node to send a getblocks request for the next batch of inventory
-        if (inv.hash == peer.m_continuation_block) {
-            // Send immediately. This must send even if redundant,
-            // and we want it right after the last block so they don't
-            // wait for other stuff first.
-            std::vector<CInv> vInv;
-            vInv.emplace_back(MSG_BLOCK, tip->GetBlockHash());
-            MakeAndPushMessage(pfrom, NetMsgType::INV, vInv);
-            peer.m_continuation_block.SetNull();
+    MaybeSendContinuationInv(pfrom, peer, inv.hash, tip->GetBlockHash());
+}
+
+void PeerManagerImpl::FinishBlockRead(CNode& pfrom, Peer& peer, const PendingBlockRead& read)
+{
+    if (!read.m_data) {
+        if (WITH_LOCK(m_chainman.GetMutex(), return m_chainman.m_blockman.IsBlockPruned(*read.pindex))) {
+            LogDebug(BCLog::NET, "Block was pruned before it could be read, %s", pfrom.DisconnectMsg());
+        } else {
+            LogError("Cannot load block from disk, %s", pfrom.DisconnectMsg());
         }
+        pfrom.fDisconnect = true;
+        return;
+    }
+    MakeAndPushMessage(pfrom, NetMsgType::BLOCK, std::span{**read.m_data});
+    MaybeSendContinuationInv(pfrom, peer, read.inv.hash, read.tip_hash);
+}
+
+void PeerManagerImpl::MaybeSendContinuationInv(CNode& pfrom, Peer& peer, const uint256& block_hash, const uint256& tip_hash)
+{
+    LOCK(peer.m_block_inv_mutex);
+    // Trigger the peer node to send a getblocks request for the next batch of inventory
+    if (block_hash == peer.m_continuation_block) {
+        // Send immediately. This must send even if redundant,
+        // and we want it right after the last block so they don't
+        // wait for other stuff first.
+        std::vector<CInv> vInv;
+        vInv.emplace_back(MSG_BLOCK, tip_hash);
+        MakeAndPushMessage(pfrom, NetMsgType::INV, vInv);
+        peer.m_continuation_block.SetNull();
     }
 }
 
@@ -2767,6 +2851,15 @@ void PeerManagerImpl::ProcessGetData(CNode& pfrom, Peer& peer, const std::atomic
 
     auto tx_relay = peer.GetTxRelay();
 
+    // A block read that is still in flight completes first, so that the
+    // responses stay in the order of the requests.
+    if (peer.m_pending_block_read) {
+        if (!peer.m_pending_block_read->m_done) return;
+        FinishBlockRead(pfrom, peer, *peer.m_pending_block_read);
+        peer.m_pending_block_read.reset();
+        if (pfrom.fDisconnect) return;
+    }
+
     std::deque<CInv>::iterator it = peer.m_getdata_requests.begin();
     std::vector<CInv> vNotFound;
 
@@ -3843,7 +3936,7 @@ void PeerManagerImpl::PushPrivateBroadcastTx(CNode& node)
 
 void PeerManagerImpl::ProcessMessage(Peer& peer, CNode& pfrom, const std::string& msg_type, DataStream& vRecv,
                                      const NodeClock::time_point time_received,
-                                     const std::atomic<bool>& interruptMsgProc)
+                                     const std::atomic<bool>& interruptMsgProc, DecodedPayload decoded)
 {
     AssertLockHeld(g_msgproc_mutex);
 
@@ -4764,8 +4857,8 @@ void PeerManagerImpl::ProcessMessage(Peer& peer, CNode& pfrom, const std::string
         // is not considered a protocol violation, so don't punish the peer.
         if (m_chainman.IsInitialBlockDownload()) return;
 
-        CTransactionRef ptx;
-        vRecv >> TX_WITH_WITNESS(ptx);
+        CTransactionRef ptx{std::move(decoded.tx)};
+        if (!ptx) vRecv >> TX_WITH_WITNESS(ptx);
 
         const Txid& txid = ptx->GetHash();
         const Wtxid& wtxid = ptx->GetWitnessHash();
@@ -5161,8 +5254,11 @@ void PeerManagerImpl::ProcessMessage(Peer& peer, CNode& pfrom, const std::string
             return;
         }
 
-        std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
-        vRecv >> TX_WITH_WITNESS(*pblock);
+        std::shared_ptr<CBlock> pblock{std::move(decoded.block)};
+        if (!pblock) {
+            pblock = std::make_shared<CBlock>();
+            vRecv >> TX_WITH_WITNESS(*pblock);
+        }
 
         LogDebug(BCLog::NET, "received block %s peer=%d\n", pblock->GetHash().ToString(), pfrom.GetId());
 
@@ -5462,6 +5558,55 @@ bool PeerManagerImpl::MaybeDisconnectForTxRelayCapacity(CNode& node, const std::
     return true;
 }
 
+void PeerManagerImpl::PrepareMessages(CNode& node)
+{
+    AssertLockNotHeld(g_msgproc_mutex);
+
+    PeerRef peer{GetPeerRef(node.GetId())};
+    if (peer == nullptr || node.fDisconnect) return;
+
+    // Leave the message on the receive queue in all cases where
+    // ProcessMessages() would not take it either, so that the queue keeps
+    // pausing the reads from a peer that we do not keep up with.
+    if (!node.IsInboundConn() && !peer->m_outbound_version_message_sent) return;
+    if (node.fPauseSend) return;
+    {
+        LOCK(peer->m_getdata_requests_mutex);
+        if (!peer->m_getdata_requests.empty() || peer->m_pending_block_read) return;
+    }
+
+    LOCK(peer->m_prepared_msg_mutex);
+    if (peer->m_prepared_msg) return;
+
+    auto poll_result{node.PollMessage()};
+    if (!poll_result) return;
+    PreparedMessage& prepared{peer->m_prepared_msg.emplace(std::move(poll_result->first), poll_result->second)};
+
+    // Deserializing transactions and blocks hashes all their transactions,
+    // which does not need to wait for g_msgproc_mutex. The payload is left
+    // untouched, so that if it fails to decode here, ProcessMessage() hits
+    // and reports the same error.
+    //
+    // Messages that ProcessMessage() drops before decoding them are not
+    // decoded here either, so that they cost no more than before.
+    if (!node.fSuccessfullyConnected) return;
+    if (prepared.msg.m_type == NetMsgType::TX && (RejectIncomingTxs(node) || m_chainman.IsInitialBlockDownload())) return;
+    if (prepared.msg.m_type == NetMsgType::BLOCK && m_chainman.m_blockman.LoadingBlocks()) return;
+
+    try {
+        SpanReader payload{MakeUCharSpan(prepared.msg.m_recv)};
+        if (prepared.msg.m_type == NetMsgType::TX) {
+            payload >> TX_WITH_WITNESS(prepared.decoded.tx);
+        } else if (prepared.msg.m_type == NetMsgType::BLOCK) {
+            auto block{std::make_shared<CBlock>()};
+            payload >> TX_WITH_WITNESS(*block);
+            prepared.decoded.block = std::move(block);
+        }
+    } catch (const std::exception&) {
+        prepared.decoded = {};
+    }
+}
+
 bool PeerManagerImpl::ProcessMessages(CNode& node, std::atomic<bool>& interruptMsgProc)
 {
     AssertLockNotHeld(m_tx_download_mutex);
@@ -5477,7 +5622,7 @@ bool PeerManagerImpl::ProcessMessages(CNode& node, std::atomic<bool>& interruptM
 
     {
         LOCK(peer.m_getdata_requests_mutex);
-        if (!peer.m_getdata_requests.empty()) {
+        if (!peer.m_getdata_requests.empty() || peer.m_pending_block_read) {
             ProcessGetData(node, peer, interruptMsgProc);
         }
     }
@@ -5493,20 +5638,26 @@ bool PeerManagerImpl::ProcessMessages(CNode& node, std::atomic<bool>& interruptM
     // and prevents m_getdata_requests to grow unbounded
     {
         LOCK(peer.m_getdata_requests_mutex);
+        // The block read pool wakes us up once a pending read is done.
+        if (peer.m_pending_block_read) return false;
         if (!peer.m_getdata_requests.empty()) return true;
     }
 
     // Don't bother if send buffer is too full to respond anyway
     if (node.fPauseSend) return false;
 
-    auto poll_result{node.PollMessage()};
-    if (!poll_result) {
-        // No message to process
-        return false;
+    std::optional<PreparedMessage> prepared{WITH_LOCK(peer.m_prepared_msg_mutex, return std::exchange(peer.m_prepared_msg, std::nullopt))};
+    if (!prepared) {
+        auto poll_result{node.PollMessage()};
+        if (!poll_result) {
+            // No message to process
+            return false;
+        }
+        prepared.emplace(std::move(poll_result->first), poll_result->second);
     }
 
-    CNetMessage& msg{poll_result->first};
-    bool fMoreWork = poll_result->second;
+    CNetMessage& msg{prepared->msg};
+    bool fMoreWork = prepared->more;
 
     TRACEPOINT(net, inbound_message,
         node.GetId(),
@@ -5522,7 +5673,7 @@ bool PeerManagerImpl::ProcessMessages(CNode& node, std::atomic<bool>& interruptM
     }
 
     try {
-        ProcessMessage(peer, node, msg.m_type, msg.m_recv, msg.m_time, interruptMsgProc);
+        ProcessMessage(peer, node, msg.m_type, msg.m_recv, msg.m_time, interruptMsgProc, std::move(prepared->decoded));
         if (interruptMsgProc) return false;
         {
             LOCK(peer.m_getdata_requests_mutex);
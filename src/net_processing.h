@@ -44,6 +44,8 @@ inline constexpr bool DEFAULT_TXRECONCILIATION_ENABLE{false};
 inline constexpr uint32_t DEFAULT_BLOCK_RECONSTRUCTION_EXTRA_TXN{100};
 /** Default maximum per-second rate for sending transaction inventory to peers. */
 inline constexpr unsigned int DEFAULT_TX_SEND_RATE{14};
+/** Default number of threads reading blocks requested by peers from disk. */
+inline constexpr int DEFAULT_BLOCK_READ_THREADS{2};
 inline constexpr bool DEFAULT_PEERBLOOMFILTERS = false;
 inline constexpr bool DEFAULT_PEERBLOCKFILTERS = false;
 /** Maximum number of outstanding CMPCTBLOCK requests for the same block. */
@@ -124,6 +126,9 @@ public:
         bool private_broadcast{DEFAULT_PRIVATE_BROADCAST};
         //! Maximum per-second rate for sending transaction inventory to peers.
         unsigned int tx_send_rate{DEFAULT_TX_SEND_RATE};
+        //! Number of threads reading blocks for peers from disk (0 reads them
+        //! on the message handler thread).
+        int block_read_threads{DEFAULT_BLOCK_READ_THREADS};
     };
 
     static std::unique_ptr<PeerManager> make(CConnman& connman, AddrMan& addrman,
@@ -987,7 +987,11 @@ bool BlockManager::WriteBlockUndo(const CBlockUndo& blockundo, BlockValidationSt
     // Write undo information to disk
     if (block.GetUndoPos().IsNull()) {
         FlatFilePos pos;
-        const auto blockundo_size{static_cast<uint32_t>(GetSerializeSize(blockundo))};
+        // Serialize only once, as the compact encoding of the name undo data
+        // has to parse the spent coins' scripts.
+        DataStream blockundo_data{};
+        blockundo_data << blockundo;
+        const auto blockundo_size{static_cast<uint32_t>(blockundo_data.size())};
         if (!FindUndoPos(state, block.nFile, pos, blockundo_size + UNDO_DATA_DISK_OVERHEAD)) {
             LogError("FindUndoPos failed for %s while writing block undo", pos.ToString());
             return false;
@@ -1008,9 +1012,11 @@ bool BlockManager::WriteBlockUndo(const CBlockUndo& blockundo, BlockValidationSt
             {
                 // Calculate checksum
                 HashWriter hasher{};
-                hasher << block.pprev->GetBlockHash() << blockundo;
+                hasher << block.pprev->GetBlockHash();
+                hasher.write(blockundo_data);
                 // Write undo data & checksum
-                fileout << blockundo << hasher.GetHash();
+                fileout.write(blockundo_data);
+                fileout << hasher.GetHash();
             }
             // BufferedWriter will flush pending data to file when fileout goes out of scope.
         }
@@ -1170,6 +1176,36 @@ BlockManager::ReadRawBlockResult BlockManager::ReadRawBlock(const FlatFilePos& p
     }
 }
 
+BlockManager::ReadServedBlockResult BlockManager::ReadServedBlock(const uint256& hash, const FlatFilePos& pos, std::optional<std::pair<size_t, size_t>> block_part) const
+{
+    if (!block_part) {
+        LOCK(m_served_blocks_mutex);
+        if (const auto it{m_served_blocks_index.find(hash)}; it != m_served_blocks_index.end()) {
+            m_served_blocks.splice(m_served_blocks.begin(), m_served_blocks, it->second);
+            return it->second->second;
+        }
+    }
+
+    auto res{ReadRawBlock(pos, block_part)};
+    if (!res) return util::Unexpected{res.error()};
+    auto data{std::make_shared<const std::vector<std::byte>>(std::move(*res))};
+    if (block_part || data->size() > SERVED_BLOCK_CACHE_BYTES) return data;
+
+    LOCK(m_served_blocks_mutex);
+    // Another thread may have read the same block in the meantime.
+    if (m_served_blocks_index.contains(hash)) return data;
+    m_served_blocks.emplace_front(hash, data);
+    m_served_blocks_index.emplace(hash, m_served_blocks.begin());
+    m_served_blocks_bytes += data->size();
+    while (m_served_blocks_bytes > SERVED_BLOCK_CACHE_BYTES) {
+        const auto& [old_hash, old_data]{m_served_blocks.back()};
+        m_served_blocks_bytes -= old_data->size();
+        m_served_blocks_index.erase(old_hash);
+        m_served_blocks.pop_back();
+    }
+    return data;
+}
+
 FlatFilePos BlockManager::WriteBlock(const CBlock& block, int nHeight)
 {
     AssertLockHeld(::cs_main);
@@ -34,6 +34,7 @@
 #include <functional>
 #include <iosfwd>
 #include <limits>
+#include <list>
 #include <map>
 #include <memory>
 #include <optional>
@@ -185,6 +186,9 @@ enum class ReadRawError {
     BadPartRange,
 };
 
+/** Size of the cache of raw blocks recently served to peers. */
+static constexpr size_t SERVED_BLOCK_CACHE_BYTES{16_MiB};
+
 /**
  * Maintains a tree of blocks (stored in `m_block_index`) which is consulted
  * to determine where the most-work tip is.
@@ -295,6 +299,17 @@ private:
 
     const Obfuscation m_obfuscation;
 
+    /**
+     * LRU cache of raw blocks recently served by ReadServedBlock.  Peers in
+     * IBD tend to request the same historical blocks at about the same time,
+     * so this saves most of the disk reads when serving several of them.
+     */
+    mutable Mutex m_served_blocks_mutex;
+    using ServedBlock = std::pair<uint256, std::shared_ptr<const std::vector<std::byte>>>;
+    mutable std::list<ServedBlock> m_served_blocks GUARDED_BY(m_served_blocks_mutex);
+    mutable std::unordered_map<uint256, std::list<ServedBlock>::iterator, SaltedUint256Hasher> m_served_blocks_index GUARDED_BY(m_served_blocks_mutex);
+    mutable size_t m_served_blocks_bytes GUARDED_BY(m_served_blocks_mutex){0};
+
     /**
      * Map from external index name to oldest block that must not be pruned.
      *
@@ -322,6 +337,7 @@ protected:
 public:
     using Options = kernel::BlockManagerOpts;
     using ReadRawBlockResult = util::Expected<std::vector<std::byte>, ReadRawError>;
+    using ReadServedBlockResult = util::Expected<std::shared_ptr<const std::vector<std::byte>>, ReadRawError>;
 
     explicit BlockManager(const util::SignalInterrupt& interrupt, Options opts);
 
@@ -481,6 +497,13 @@ public:
     bool ReadBlock(CBlock& block, const CBlockIndex& index) const;
     bool ReadBlockHeader(CBlockHeader& block, const CBlockIndex& pindex) const;
     ReadRawBlockResult ReadRawBlock(const FlatFilePos& pos, std::optional<std::pair<size_t, size_t>> block_part = std::nullopt) const;
+    /**
+     * Read a raw block for sending it to a peer.  Full blocks are kept in a
+     * small LRU cache (keyed by the block hash), partial reads always go to
+     * disk.  This is safe to call from any thread.
+     */
+    ReadServedBlockResult ReadServedBlock(const uint256& hash, const FlatFilePos& pos, std::optional<std::pair<size_t, size_t>> block_part = std::nullopt) const
+        EXCLUSIVE_LOCKS_REQUIRED(!m_served_blocks_mutex);
 
     bool ReadBlockUndo(CBlockUndo& blockundo, const CBlockIndex& index) const;
 
@@ -114,6 +114,13 @@ static ChainstateLoadResult CompleteChainstateInitialization(
                                                                      "rebuild the chainstate database.")};
         }
 
+        // The name database is a separate LevelDB instance, which could be
+        // left behind the coin database if a flush was interrupted.
+        if (!chainstate->CoinsDB().NamesConsistent()) {
+            return {ChainstateLoadStatus::FAILURE, _("The name database is not consistent with the chainstate database. "
+                                                     "Please restart with -reindex-chainstate to rebuild it.")};
+        }
+
         // ReplayBlocks is a no-op if we cleared the coinsviewdb with -reindex or -reindex-chainstate
         if (!chainstate->ReplayBlocks()) {
             return {ChainstateLoadStatus::FAILURE, _("Unable to replay blocks. You will need to rebuild the database using -reindex-chainstate.")};
@@ -4,8 +4,10 @@
 
 #include <node/mempool_persist.h>
 
+#include <chain.h>
 #include <clientversion.h>
 #include <consensus/amount.h>
+#include <policy/policy.h>
 #include <primitives/transaction.h>
 #include <random.h>
 #include <serialize.h>
@@ -38,7 +40,10 @@ using fsbridge::FopenFn;
 namespace node {
 
 static const uint64_t MEMPOOL_DUMP_VERSION_NO_XOR_KEY{1};
-static const uint64_t MEMPOOL_DUMP_VERSION{2};
+static const uint64_t MEMPOOL_DUMP_VERSION_NO_TIP{2};
+/** Also records the chain tip the mempool was consistent with, the policy and consensus script
+ *  flags it was validated with, and the wtxid of each transaction. */
+static const uint64_t MEMPOOL_DUMP_VERSION{3};
 
 bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active_chainstate, ImportMempoolOptions&& opts)
 {
@@ -63,7 +68,7 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
 
         if (version == MEMPOOL_DUMP_VERSION_NO_XOR_KEY) {
             file.SetObfuscation({});
-        } else if (version == MEMPOOL_DUMP_VERSION) {
+        } else if (version == MEMPOOL_DUMP_VERSION_NO_TIP || version == MEMPOOL_DUMP_VERSION) {
             Obfuscation obfuscation;
             file >> obfuscation;
             file.SetObfuscation(obfuscation);
@@ -71,6 +76,31 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
             return false;
         }
 
+        // The transactions passed all checks against the tip the file was
+        // written at. As long as that is still our tip and both the policy
+        // and consensus script flags are the same, the result of their script
+        // checks cannot have changed, so they are not run again. The dump
+        // is only trusted if it is our own (not for importmempool), and each
+        // transaction only if it still hashes to the wtxid recorded for it,
+        // so that a corrupted file cannot skip the checks.
+        uint256 dump_tip;
+        uint64_t consensus_flags{0};
+        if (version == MEMPOOL_DUMP_VERSION) {
+            uint64_t policy_flags;
+            file >> dump_tip;
+            file >> policy_flags;
+            file >> consensus_flags;
+            if (!opts.trust_dump_tip || policy_flags != STANDARD_SCRIPT_VERIFY_FLAGS.as_int()) dump_tip.SetNull();
+        }
+        const auto is_dump_tip{[&]() EXCLUSIVE_LOCKS_REQUIRED(cs_main) {
+            const CBlockIndex* tip{active_chainstate.m_chain.Tip()};
+            return !dump_tip.IsNull() && tip != nullptr && tip->GetBlockHash() == dump_tip &&
+                   GetBlockScriptFlags(*tip, active_chainstate.m_chainman).as_int() == consensus_flags;
+        }};
+        if (WITH_LOCK(cs_main, return is_dump_tip())) {
+            LogInfo("Mempool file was written at the current chain tip, skipping the script checks\n");
+        }
+
         uint64_t total_txns_to_load;
         file >> total_txns_to_load;
         uint64_t txns_tried = 0;
@@ -88,7 +118,9 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
             CTransactionRef tx;
             int64_t nTime;
             int64_t nFeeDelta;
+            Wtxid wtxid;
             file >> TX_WITH_WITNESS(tx);
+            if (version == MEMPOOL_DUMP_VERSION) file >> wtxid;
             file >> nTime;
             file >> nFeeDelta;
 
@@ -102,7 +134,8 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
             }
             if (nTime > TicksSinceEpoch<std::chrono::seconds>(now - pool.m_opts.expiry)) {
                 LOCK(cs_main);
-                const auto& accepted = AcceptToMemoryPool(active_chainstate, tx, nTime, /*bypass_limits=*/false, /*test_accept=*/false);
+                const auto& accepted = AcceptToMemoryPool(active_chainstate, tx, nTime, /*bypass_limits=*/false, /*test_accept=*/false,
+                                                          /*skip_script_checks=*/tx->GetWitnessHash() == wtxid && is_dump_tip());
                 if (accepted.m_result_type == MempoolAcceptResult::ResultType::VALID) {
                     ++count;
                 } else {
@@ -150,24 +183,31 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
     return true;
 }
 
-bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path, FopenFn mockable_fopen_function, bool skip_file_commit)
+bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path, const Chainstate& active_chainstate,
+                 FopenFn mockable_fopen_function, bool skip_file_commit)
 {
     auto start = SteadyClock::now();
 
     std::map<Txid, CAmount> mapDeltas;
     std::vector<TxMempoolInfo> vinfo;
     std::set<Txid> unbroadcast_txids;
+    uint256 tip_hash;
+    uint64_t consensus_flags{0};
 
     static Mutex dump_mutex;
     LOCK(dump_mutex);
 
     {
-        LOCK(pool.cs);
+        LOCK2(cs_main, pool.cs);
         for (const auto &i : pool.mapDeltas) {
             mapDeltas[i.first] = i.second;
         }
         vinfo = pool.infoAll();
         unbroadcast_txids = pool.GetUnbroadcastTxs();
+        if (const CBlockIndex* tip{active_chainstate.m_chain.Tip()}) {
+            tip_hash = tip->GetBlockHash();
+            consensus_flags = GetBlockScriptFlags(*tip, active_chainstate.m_chainman).as_int();
+        }
     }
 
     auto mid = SteadyClock::now();
@@ -186,6 +226,9 @@ bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path, FopenFn mock
             const Obfuscation obfuscation{FastRandomContext{}.randbytes<Obfuscation::KEY_SIZE>()};
             file << obfuscation;
             file.SetObfuscation(obfuscation);
+            file << tip_hash;
+            file << uint64_t{STANDARD_SCRIPT_VERIFY_FLAGS.as_int()};
+            file << consensus_flags;
         } else {
             file.SetObfuscation({});
         }
@@ -195,6 +238,7 @@ bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path, FopenFn mock
         LogInfo("Writing %u mempool transactions to file...\n", mempool_transactions_to_write);
         for (const auto& i : vinfo) {
             file << TX_WITH_WITNESS(*(i.tx));
+            if (!pool.m_opts.persist_v1_dat) file << i.tx->GetWitnessHash();
             file << int64_t{count_seconds(i.m_time)};
             file << int64_t{i.nFeeDelta};
             mapDeltas.erase(i.tx->GetHash());
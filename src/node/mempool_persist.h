@@ -12,8 +12,13 @@ class CTxMemPool;
 
 namespace node {
 
-/** Dump the mempool to a file. */
+/**
+ * Dump the mempool to a file, along with the chain tip it is consistent with.
+ * When loaded at that same tip, the scripts of its transactions are not
+ * verified again.
+ */
 bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path,
+                 const Chainstate& active_chainstate,
                  fsbridge::FopenFn mockable_fopen_function = fsbridge::fopen,
                  bool skip_file_commit = false);
 
@@ -22,6 +27,8 @@ struct ImportMempoolOptions {
     bool use_current_time{false};
     bool apply_fee_delta_priority{true};
     bool apply_unbroadcast_set{true};
+    /** Skip the script checks if the file was written by us at the current chain tip. */
+    bool trust_dump_tip{true};
 };
 /** Import the file and attempt to add its contents to the mempool. */
 bool LoadMempool(CTxMemPool& pool, const fs::path& load_path,
@@ -29,6 +29,10 @@ void ApplyArgsManOptions(const ArgsManager& argsman, PeerManager::Options& optio
     }
 
     if (auto value{argsman.GetBoolArg("-privatebroadcast")}) options.private_broadcast = *value;
+
+    if (auto value{argsman.GetIntArg("-blockreadthreads")}) {
+        options.block_read_threads = int(std::clamp<int64_t>(*value, 0, 16));
+    }
 }
 
 } // namespace node
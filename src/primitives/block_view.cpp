@@ -0,0 +1,137 @@
+// Copyright (c) 2026 The Namecoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <primitives/block_view.h>
+
+#include <hash.h>
+#include <serialize.h>
+
+#include <algorithm>
+#include <ios>
+
+TxView TxView::Parse(std::span<const std::byte> data)
+{
+    TxView tx;
+    tx.m_raw = data;
+
+    // This follows UnserializeTransaction with witness allowed.
+    size_t pos{0};
+    tx.ReadBytesAt(pos, VERSION_SIZE);
+    tx.m_inputs_begin = pos;
+    uint64_t num_inputs{tx.SkipInputsAt(pos)};
+    uint8_t flags{0};
+    if (num_inputs == 0) {
+        SpanReader{tx.ReadBytesAt(pos, sizeof(flags))} >> flags;
+        if (flags != 0) {
+            tx.m_inputs_begin = pos;
+            num_inputs = tx.SkipInputsAt(pos);
+            tx.m_outputs_begin = pos;
+            tx.SkipOutputsAt(pos);
+        } else {
+            // No inputs and no flags, the byte read as flags is the
+            // (empty) output vector.
+            tx.m_outputs_begin = pos - sizeof(flags);
+        }
+    } else {
+        tx.m_outputs_begin = pos;
+        tx.SkipOutputsAt(pos);
+    }
+    tx.m_outputs_end = pos;
+
+    if (flags & 1) {
+        flags ^= 1;
+        bool has_witness{false};
+        for (uint64_t i{0}; i < num_inputs; ++i) {
+            const uint64_t stack_size{tx.ReadCompactSizeAt(pos)};
+            has_witness |= stack_size > 0;
+            for (uint64_t j{0}; j < stack_size; ++j) {
+                const uint64_t item_size{tx.ReadCompactSizeAt(pos)};
+                tx.ReadBytesAt(pos, item_size);
+            }
+        }
+        if (!has_witness) {
+            throw std::ios_base::failure("Superfluous witness record");
+        }
+    }
+    if (flags) {
+        throw std::ios_base::failure("Unknown transaction optional data");
+    }
+    tx.ReadBytesAt(pos, LOCK_TIME_SIZE);
+
+    tx.m_raw = data.first(pos);
+    return tx;
+}
+
+Txid TxView::GetHash() const
+{
+    if (!HasWitness()) {
+        return Txid::FromUint256(Hash(m_raw));
+    }
+    HashWriter hasher;
+    hasher.write(m_raw.first(VERSION_SIZE));
+    hasher.write(m_raw.subspan(m_inputs_begin, m_outputs_end - m_inputs_begin));
+    hasher.write(m_raw.last(LOCK_TIME_SIZE));
+    return Txid::FromUint256(hasher.GetHash());
+}
+
+Wtxid TxView::GetWitnessHash() const
+{
+    return Wtxid::FromUint256(Hash(m_raw));
+}
+
+uint64_t TxView::ReadCompactSizeAt(size_t& pos) const
+{
+    SpanReader reader{m_raw.subspan(pos)};
+    const uint64_t res{ReadCompactSize(reader)};
+    pos = m_raw.size() - reader.size();
+    return res;
+}
+
+std::span<const std::byte> TxView::ReadBytesAt(size_t& pos, const uint64_t len) const
+{
+    if (len > m_raw.size() - pos) {
+        throw std::ios_base::failure("TxView: end of data");
+    }
+    const auto res{m_raw.subspan(pos, len)};
+    pos += len;
+    return res;
+}
+
+uint64_t TxView::SkipInputsAt(size_t& pos) const
+{
+    const uint64_t count{ReadCompactSizeAt(pos)};
+    for (uint64_t i{0}; i < count; ++i) {
+        ReadBytesAt(pos, OUTPOINT_SIZE);
+        const uint64_t script_size{ReadCompactSizeAt(pos)};
+        ReadBytesAt(pos, script_size + sizeof(uint32_t));
+    }
+    return count;
+}
+
+void TxView::SkipOutputsAt(size_t& pos) const
+{
+    const uint64_t count{ReadCompactSizeAt(pos)};
+    for (uint64_t i{0}; i < count; ++i) {
+        ReadBytesAt(pos, sizeof(CAmount));
+        const uint64_t script_size{ReadCompactSizeAt(pos)};
+        ReadBytesAt(pos, script_size);
+    }
+}
+
+BlockView::BlockView(std::span<const std::byte> data)
+{
+    SpanReader reader{data};
+    reader >> m_header;
+    const uint64_t num_txs{ReadCompactSize(reader)};
+    size_t pos{data.size() - reader.size()};
+    m_header_size = pos - GetSizeOfCompactSize(num_txs);
+
+    // Every transaction takes at least ten bytes, which bounds the
+    // allocation for a bogus count.
+    m_txs.reserve(std::min<uint64_t>(num_txs, (data.size() - pos) / 10));
+    for (uint64_t i{0}; i < num_txs; ++i) {
+        m_txs.push_back(TxView::Parse(data.subspan(pos)));
+        pos += m_txs.back().GetTotalSize();
+    }
+}
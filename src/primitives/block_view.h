@@ -0,0 +1,145 @@
+// Copyright (c) 2026 The Namecoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_PRIMITIVES_BLOCK_VIEW_H
+#define BITCOIN_PRIMITIVES_BLOCK_VIEW_H
+
+#include <attributes.h>
+#include <consensus/amount.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <primitives/transaction_identifier.h>
+#include <span.h>
+#include <streams.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * Read-only view of a serialized transaction, as part of a raw block.
+ *
+ * Unlike a CTransaction, it does not copy the inputs, outputs and scripts
+ * out of the serialized data, but decodes them on the fly when they are
+ * iterated over.  The hashes are computed only when asked for.  The data
+ * must outlive the view.
+ */
+class TxView
+{
+public:
+    struct Input {
+        COutPoint prevout;
+        std::span<const unsigned char> script_sig;
+        uint32_t sequence;
+    };
+
+    struct Output {
+        CAmount value;
+        std::span<const unsigned char> script_pub_key;
+    };
+
+    /**
+     * Parses the transaction (with witness) at the start of @p data.  Throws
+     * std::ios_base::failure for malformed data, like deserializing a
+     * CTransaction does.
+     */
+    static TxView Parse(std::span<const std::byte> data LIFETIMEBOUND);
+
+    /** The serialized transaction, including its witness.  */
+    std::span<const std::byte> GetRaw() const { return m_raw; }
+    size_t GetTotalSize() const { return m_raw.size(); }
+
+    bool HasWitness() const { return m_inputs_begin != VERSION_SIZE; }
+
+    Txid GetHash() const;
+    Wtxid GetWitnessHash() const;
+
+    /** Calls @p fn with each Input of the transaction, in order.  */
+    template <typename Fn>
+    void ForEachInput(Fn&& fn) const
+    {
+        size_t pos{m_inputs_begin};
+        const uint64_t count{ReadCompactSizeAt(pos)};
+        for (uint64_t i{0}; i < count; ++i) {
+            Input in;
+            SpanReader{ReadBytesAt(pos, OUTPOINT_SIZE)} >> in.prevout;
+            const uint64_t script_size{ReadCompactSizeAt(pos)};
+            in.script_sig = UCharSpanCast(ReadBytesAt(pos, script_size));
+            SpanReader{ReadBytesAt(pos, sizeof(in.sequence))} >> in.sequence;
+            fn(in);
+        }
+    }
+
+    /** Calls @p fn with each Output of the transaction, in order.  */
+    template <typename Fn>
+    void ForEachOutput(Fn&& fn) const
+    {
+        size_t pos{m_outputs_begin};
+        const uint64_t count{ReadCompactSizeAt(pos)};
+        for (uint64_t i{0}; i < count; ++i) {
+            Output out;
+            SpanReader{ReadBytesAt(pos, sizeof(out.value))} >> out.value;
+            const uint64_t script_size{ReadCompactSizeAt(pos)};
+            out.script_pub_key = UCharSpanCast(ReadBytesAt(pos, script_size));
+            fn(out);
+        }
+    }
+
+private:
+    static constexpr size_t VERSION_SIZE{4};
+    static constexpr size_t LOCK_TIME_SIZE{4};
+    static constexpr size_t OUTPOINT_SIZE{36};
+
+    std::span<const std::byte> m_raw;
+
+    /**
+     * Offsets of the input vector, the output vector and the end of the
+     * latter.  Together with the version and lock time, the range from
+     * m_inputs_begin to m_outputs_end is the serialization without witness.
+     */
+    uint32_t m_inputs_begin{0};
+    uint32_t m_outputs_begin{0};
+    uint32_t m_outputs_end{0};
+
+    TxView() = default;
+
+    /** Reads a compact size at @p pos of the data, and advances @p pos past it.  */
+    uint64_t ReadCompactSizeAt(size_t& pos) const;
+    /** Returns @p len bytes at @p pos of the data, and advances @p pos past them.  */
+    std::span<const std::byte> ReadBytesAt(size_t& pos, uint64_t len) const;
+    /** Skips over an input or output vector and returns its size.  */
+    uint64_t SkipInputsAt(size_t& pos) const;
+    void SkipOutputsAt(size_t& pos) const;
+};
+
+/**
+ * Read-only view of a serialized block, e.g. as returned by
+ * BlockManager::ReadRawBlock.  Only the header (with its auxpow) is
+ * deserialized, the transactions are TxViews into the data.  This is meant
+ * for consumers that only read parts of every transaction, like indexes,
+ * and saves all the allocations of a full CBlock.
+ */
+class BlockView
+{
+public:
+    /**
+     * Parses the block in @p data, which must outlive the view.  Throws
+     * std::ios_base::failure for malformed data.
+     */
+    explicit BlockView(std::span<const std::byte> data LIFETIMEBOUND);
+
+    const CBlockHeader& GetHeader() const { return m_header; }
+    /** Size of the serialized header including the auxpow.  */
+    size_t GetHeaderSize() const { return m_header_size; }
+
+    const std::vector<TxView>& GetTransactions() const { return m_txs; }
+
+private:
+    CBlockHeader m_header;
+    size_t m_header_size;
+    std::vector<TxView> m_txs;
+};
+
+#endif // BITCOIN_PRIMITIVES_BLOCK_VIEW_H
@@ -8,10 +8,12 @@
 #include <blockfilter.h>
 #include <chain.h>
 #include <chainparams.h>
+#include <common/args.h>
 #include <core_io.h>
 #include <flatfile.h>
 #include <httpserver.h>
 #include <index/blockfilterindex.h>
+#include <index/namehash.h>
 #include <index/txindex.h>
 #include <names/common.h>
 #include <names/encoding.h>
@@ -46,6 +48,7 @@ using node::NodeContext;
 using util::SplitString;
 
 static const size_t MAX_GETUTXOS_OUTPOINTS = 15; //allow a max of 15 outpoints to be queried at once
+static constexpr size_t MAX_REST_NAMEHASHES = 100; //allow a max of 100 name hashes to be looked up at once
 static constexpr unsigned int MAX_REST_HEADERS_RESULTS = 2000;
 
 // Cache-Control values for REST responses.
@@ -1291,6 +1294,64 @@ static bool rest_name(const std::any& context, HTTPRequest* req, const std::stri
     return true; // continue to process further HTTP reqs on this cxn
 }
 
+static bool rest_namehashes(const std::any& context, HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+    std::string param;
+    const RESTResponseFormat rf = ParseDataFormat(param, strURIPart);
+    if (rf != RESTResponseFormat::JSON) {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: json)");
+    }
+
+    if (g_name_hash_index == nullptr) {
+        return RESTERR(req, HTTP_SERVICE_UNAVAILABLE, "-namehashindex is not enabled");
+    }
+    if (!g_name_hash_index->BlockUntilSyncedToCurrentChain()) {
+        return RESTERR(req, HTTP_SERVICE_UNAVAILABLE, "The name-hash index is not caught up yet");
+    }
+
+    // The hashes are given as hex of their raw bytes, like the identifiers
+    // of name_show with byHash=sha256d and nameEncoding=hex.
+    const std::vector<std::string> path = SplitString(param, '/');
+    if (path.empty() || path.size() > MAX_REST_NAMEHASHES) {
+        return RESTERR(req, HTTP_BAD_REQUEST, strprintf("Number of name hashes must be between 1 and %u", MAX_REST_NAMEHASHES));
+    }
+    std::vector<uint256> hashes;
+    hashes.reserve(path.size());
+    for (const auto& hex : path) {
+        const auto bytes{TryParseHex<unsigned char>(hex)};
+        if (!bytes || bytes->size() != uint256::size()) {
+            return RESTERR(req, HTTP_BAD_REQUEST, "Invalid name hash: " + hex);
+        }
+        hashes.emplace_back(*bytes);
+    }
+
+    ChainstateManager* maybe_chainman = GetChainman(context, req);
+    if (!maybe_chainman) return false;
+    ChainstateManager& chainman = *maybe_chainman;
+
+    const bool allow_expired{gArgs.GetBoolArg("-allowexpired", DEFAULT_ALLOWEXPIRED)};
+    const auto found{LookupNamesByHash(chainman, hashes, allow_expired)};
+
+    const UniValue NO_OPTIONS(UniValue::VOBJ);
+    UniValue result(UniValue::VARR);
+    {
+        LOCK(cs_main);
+        for (const auto& entry : found) {
+            if (entry) {
+                result.push_back(getNameInfo(chainman, NO_OPTIONS, entry->first, entry->second));
+            } else {
+                result.push_back(NullUniValue);
+            }
+        }
+    }
+
+    req->WriteHeader("Content-Type", "application/json");
+    req->WriteReply(HTTP_OK, result.write() + "\n");
+    return true;
+}
+
 static const struct {
     const char* prefix;
     bool (*handler)(const std::any& context, HTTPRequest* req, const std::string& strReq);
@@ -1310,6 +1371,7 @@ static const struct {
     {"/rest/blockhashbyheight/", rest_blockhash_by_height},
     {"/rest/spenttxouts/", rest_spent_txouts},
     {"/rest/name/", rest_name},
+    {"/rest/namehashes/", rest_namehashes},
 };
 
 void StartREST(const std::any& context)
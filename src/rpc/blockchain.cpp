@@ -3701,6 +3701,8 @@ const std::vector<RPCResult> RPCHelpForChainstate{
     {RPCResult::Type::STR_HEX, "snapshot_blockhash", /*optional=*/true, "the base block of the snapshot this chainstate is based on, if any"},
     {RPCResult::Type::NUM, "coins_db_cache_bytes", "size of the coinsdb cache"},
     {RPCResult::Type::NUM, "coins_tip_cache_bytes", "size of the coinstip cache"},
+    {RPCResult::Type::NUM, "coins_tip_cache_usage", "memory currently used by the coinstip cache, including cached name changes"},
+    {RPCResult::Type::NUM, "names_tip_cache_usage", "memory currently used by name changes in the coinstip cache"},
     {RPCResult::Type::BOOL, "validated", "whether the chainstate is fully validated. True if all blocks in the chainstate were validated, false if the chain is based on a snapshot and the snapshot has not yet been validated."},
 };
 
@@ -3727,7 +3729,7 @@ return RPCMethod{
 
     ChainstateManager& chainman = EnsureAnyChainman(request.context);
 
-    auto make_chain_data = [&](const Chainstate& cs) EXCLUSIVE_LOCKS_REQUIRED(::cs_main) {
+    auto make_chain_data = [&](Chainstate& cs) EXCLUSIVE_LOCKS_REQUIRED(::cs_main) {
         AssertLockHeld(::cs_main);
         UniValue data(UniValue::VOBJ);
         if (!cs.m_chain.Tip()) {
@@ -3744,6 +3746,8 @@ return RPCMethod{
         data.pushKV("verificationprogress",  chainman.GuessVerificationProgress(tip));
         data.pushKV("coins_db_cache_bytes",  cs.m_coinsdb_cache_size_bytes);
         data.pushKV("coins_tip_cache_bytes", cs.m_coinstip_cache_size_bytes);
+        data.pushKV("coins_tip_cache_usage", cs.CoinsTip().DynamicMemoryUsage());
+        data.pushKV("names_tip_cache_usage", cs.CoinsTip().NameCacheMemoryUsage());
         if (cs.m_from_snapshot_blockhash) {
             data.pushKV("snapshot_blockhash", cs.m_from_snapshot_blockhash->ToString());
         }
@@ -3753,7 +3757,7 @@ return RPCMethod{
 
     obj.pushKV("headers", chainman.m_best_header ? chainman.m_best_header->nHeight : -1);
     UniValue obj_chainstates{UniValue::VARR};
-    if (const Chainstate * cs{chainman.HistoricalChainstate()}) {
+    if (Chainstate * cs{chainman.HistoricalChainstate()}) {
         obj_chainstates.push_back(make_chain_data(*cs));
     }
     obj_chainstates.push_back(make_chain_data(chainman.CurrentChainstate()));
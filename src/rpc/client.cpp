@@ -346,6 +346,8 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "createwalletdescriptor", 1, "internal" },
 
     { "name_show", 1, "options" },
+    { "name_show_many", 0, "names" },
+    { "name_show_many", 1, "options" },
     { "name_history", 1, "options" },
     { "name_scan", 1, "count" },
     { "name_scan", 2, "options" },
@@ -354,7 +356,11 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "name_new", 1, "options" },
     { "name_firstupdate", 4, "options" },
     { "name_firstupdate", 5, "allow_active" },
+    { "name_register_batch", 0, "names" },
+    { "name_register_batch", 1, "options" },
     { "name_update", 2, "options" },
+    { "name_update_batch", 0, "names" },
+    { "name_update_batch", 1, "options" },
     { "namerawtransaction", 1, "vout" },
     { "namerawtransaction", 2, "nameop" },
     { "namepsbt", 1, "vout" },
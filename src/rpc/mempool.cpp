@@ -1186,6 +1186,8 @@ static RPCMethod importmempool()
                 .use_current_time = use_current_time.isNull() ? true : use_current_time.get_bool(),
                 .apply_fee_delta_priority = apply_fee_delta.isNull() ? false : apply_fee_delta.get_bool(),
                 .apply_unbroadcast_set = apply_unbroadcast.isNull() ? false : apply_unbroadcast.get_bool(),
+                // The file may come from another node, verify everything.
+                .trust_dump_tip = false,
             };
 
             if (!node::LoadMempool(mempool, load_path, chainstate, std::move(opts))) {
@@ -1224,7 +1226,7 @@ static RPCMethod savemempool()
 
     const fs::path& dump_path = MempoolPath(args);
 
-    if (!DumpMempool(mempool, dump_path)) {
+    if (!DumpMempool(mempool, dump_path, EnsureAnyChainman(request.context).ActiveChainstate())) {
         throw JSONRPCError(RPC_MISC_ERROR, "Unable to dump mempool to disk");
     }
 
@@ -37,8 +37,12 @@
 
 #include <algorithm>
 #include <cassert>
+#include <limits>
 #include <memory>
+#include <optional>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace
 {
@@ -78,15 +82,19 @@ getNameInfo (const UniValue& options,
              const valtype& name, const valtype& value,
              const COutPoint& outp, const CScript& addr)
 {
+  /* The keys are all distinct, so they are appended without looking for
+     an existing one first.  Room is left for the expiration and ownership
+     info that callers add.  */
   UniValue obj(UniValue::VOBJ);
+  obj.reserve (12);
   AddEncodedNameToUniv (obj, "name", name,
                         EncodingFromOptionsJson (options, "nameEncoding",
                                                  ConfiguredNameEncoding ()));
   AddEncodedNameToUniv (obj, "value", value,
                         EncodingFromOptionsJson (options, "valueEncoding",
                                                  ConfiguredValueEncoding ()));
-  obj.pushKV ("txid", outp.hash.GetHex ());
-  obj.pushKV ("vout", static_cast<int> (outp.n));
+  obj.pushKVEnd ("txid", outp.hash.GetHex ());
+  obj.pushKVEnd ("vout", static_cast<int> (outp.n));
 
   /* Try to extract the address.  May fail if we can't parse the script
      as a "standard" script.  */
@@ -96,7 +104,7 @@ getNameInfo (const UniValue& options,
     addrStr = EncodeDestination (dest);
   else
     addrStr = "<nonstandard>";
-  obj.pushKV ("address", addrStr);
+  obj.pushKVEnd ("address", std::move (addrStr));
 
   return obj;
 }
@@ -130,9 +138,66 @@ addExpirationInfo (const ChainstateManager& chainman,
   const int expireHeight = height + expireDepth;
   const int expiresIn = expireHeight - curHeight;
   const bool expired = (expiresIn <= 0);
-  data.pushKV ("height", height);
-  data.pushKV ("expires_in", expiresIn);
-  data.pushKV ("expired", expired);
+  data.pushKVEnd ("height", height);
+  data.pushKVEnd ("expires_in", expiresIn);
+  data.pushKVEnd ("expired", expired);
+}
+
+namespace
+{
+
+/**
+ * Number of entries of a streamed name_scan or name_history result that are
+ * produced at a time, while holding the locks.
+ */
+constexpr size_t NAME_STREAM_BATCH_SIZE = 1'000;
+
+/** Maximum number of name hashes that name_show_many looks up at once.  */
+constexpr size_t MAX_NAME_SHOW_MANY_HASHES = 100;
+
+/**
+ * Returns whether a name last updated at the given height is expired at the
+ * current tip, in the same way as addExpirationInfo reports it.
+ */
+bool
+IsExpiredAtTip (const ChainstateManager& chainman, const unsigned height)
+  EXCLUSIVE_LOCKS_REQUIRED (cs_main)
+{
+  const int curHeight = chainman.ActiveHeight ();
+  const Consensus::Params& params = Params ().GetConsensus ();
+  return static_cast<int> (height)
+            + static_cast<int> (params.rules->NameExpirationDepth (curHeight))
+          <= curHeight;
+}
+
+} // anonymous namespace
+
+std::vector<std::optional<std::pair<valtype, CNameData>>>
+LookupNamesByHash (const ChainstateManager& chainman,
+                   const std::span<const uint256> hashes,
+                   const bool allowExpired)
+{
+  assert (g_name_hash_index != nullptr);
+  auto preimages = g_name_hash_index->FindNamePreimages (hashes);
+
+  std::vector<std::optional<std::pair<valtype, CNameData>>> res(hashes.size ());
+  LOCK (cs_main);
+  const auto& view = chainman.ActiveChainstate ().CoinsTip ();
+  for (size_t i = 0; i < hashes.size (); ++i)
+    {
+      if (!preimages[i])
+        continue;
+
+      CNameData data;
+      if (!view.GetName (*preimages[i], data))
+        continue;
+      if (!allowExpired && IsExpiredAtTip (chainman, data.getHeight ()))
+        continue;
+
+      res[i].emplace (std::move (*preimages[i]), std::move (data));
+    }
+
+  return res;
 }
 
 #ifdef ENABLE_WALLET
@@ -193,14 +258,13 @@ namespace
 {
 
 /**
- * Decodes the identifier for a name lookup according to the nameEncoding,
- * and also looks up the preimage if we look up by hash.
+ * Checks the byHash option of a name lookup.  Returns true if the
+ * identifiers are SHA-256d hashes of the names, in which case the name-hash
+ * index is available and synced.
  */
-valtype
-GetNameForLookup (const UniValue& val, const UniValue& opt)
+bool
+IsLookupByHash (const UniValue& opt)
 {
-  const valtype identifier = DecodeNameFromRPCOrThrow (val, opt);
-
   RPCTypeCheckObj (opt,
     {
       {"byHash", UniValueType (UniValue::VSTR)},
@@ -208,11 +272,11 @@ GetNameForLookup (const UniValue& val, const UniValue& opt)
     true, false);
 
   if (!opt.exists ("byHash"))
-    return identifier;
+    return false;
 
   const std::string byHashType = opt["byHash"].get_str ();
   if (byHashType == "direct")
-    return identifier;
+    return false;
 
   if (g_name_hash_index == nullptr)
     throw std::runtime_error ("-namehashindex is not enabled");
@@ -226,11 +290,34 @@ GetNameForLookup (const UniValue& val, const UniValue& opt)
       throw JSONRPCError (RPC_INVALID_PARAMETER, msg.str ());
     }
 
+  return true;
+}
+
+/**
+ * Converts a decoded identifier for lookup by hash to the hash.
+ */
+uint256
+NameHashFromIdentifier (const valtype& identifier)
+{
   if (identifier.size () != 32)
     throw JSONRPCError (RPC_INVALID_PARAMETER,
                         "SHA-256d hash must be 32 bytes long");
 
-  const uint256 hash(identifier);
+  return uint256(identifier);
+}
+
+/**
+ * Decodes the identifier for a name lookup according to the nameEncoding,
+ * and also looks up the preimage if we look up by hash.
+ */
+valtype
+GetNameForLookup (const UniValue& val, const UniValue& opt)
+{
+  const valtype identifier = DecodeNameFromRPCOrThrow (val, opt);
+  if (!IsLookupByHash (opt))
+    return identifier;
+
+  const uint256 hash = NameHashFromIdentifier (identifier);
   valtype name;
   if (!g_name_hash_index->FindNamePreimage (hash, name))
     {
@@ -573,6 +660,125 @@ name_show ()
 
 /* ************************************************************************** */
 
+RPCMethod
+name_show_many ()
+{
+  NameOptionsHelp optHelp;
+  optHelp
+      .withNameEncoding ()
+      .withValueEncoding ()
+      .withByHash ()
+      .withArg ("allowExpired", RPCArg::Type::BOOL, "depends on -allowexpired",
+                "Whether to return expired names");
+
+  return RPCMethod ("name_show_many",
+      "Looks up the current data for many names at once.  When looking up"
+      " by hash, all hashes are looked up in the name-hash index as a batch,"
+      " and at most " + std::to_string (MAX_NAME_SHOW_MANY_HASHES)
+        + " hashes can be given.\n",
+      {
+          {"names", RPCArg::Type::ARR, RPCArg::Optional::NO, "The names to query for",
+              {
+                  {"name", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "A name"},
+              }},
+          optHelp.buildRpcArg (),
+      },
+      RPCResult {RPCResult::Type::ARR, "",
+          "The data of each name, in the order of the request, or null if the"
+          " name does not exist (or is expired and allowExpired is false)",
+          {
+              NameInfoHelp ()
+                .withExpiration ()
+                .finish ()
+          },
+          /* The entries may be null.  */
+          {.skip_type_check = true}},
+      RPCExamples {
+          HelpExampleCli ("name_show_many", R"('["d/abc", "d/def"]')")
+        + HelpExampleRpc ("name_show_many", R"(["d/abc", "d/def"])")
+      },
+      [&] (const RPCMethod& self, const JSONRPCRequest& request) -> UniValue
+{
+  auto& chainman = EnsureChainman (EnsureAnyNodeContext (request));
+
+  if (chainman.IsInitialBlockDownload ())
+    throw JSONRPCError(RPC_CLIENT_IN_INITIAL_DOWNLOAD,
+                       "Namecoin is downloading blocks...");
+
+  UniValue options(UniValue::VOBJ);
+  if (request.params.size () >= 2)
+    options = request.params[1].get_obj ();
+
+  RPCTypeCheckObj(options,
+    {
+      {"allowExpired", UniValueType(UniValue::VBOOL)},
+    },
+    true, false);
+
+  bool allow_expired = gArgs.GetBoolArg("-allowexpired", DEFAULT_ALLOWEXPIRED);
+  if (options.exists("allowExpired"))
+    allow_expired = options["allowExpired"].get_bool();
+
+  const UniValue& identifiers = request.params[0].get_array ();
+  if (IsLookupByHash (options)
+        && identifiers.size () > MAX_NAME_SHOW_MANY_HASHES)
+    throw JSONRPCError (RPC_INVALID_PARAMETER,
+                        strprintf ("at most %u name hashes can be looked up"
+                                   " at once", MAX_NAME_SHOW_MANY_HASHES));
+
+  std::vector<valtype> names;
+  for (const auto& id : identifiers.getValues ())
+    names.push_back (DecodeNameFromRPCOrThrow (id, options));
+
+  std::vector<std::optional<std::pair<valtype, CNameData>>> found;
+  if (IsLookupByHash (options))
+    {
+      std::vector<uint256> hashes;
+      hashes.reserve (names.size ());
+      for (const auto& id : names)
+        hashes.push_back (NameHashFromIdentifier (id));
+      found = LookupNamesByHash (chainman, hashes, allow_expired);
+    }
+  else
+    {
+      LOCK (cs_main);
+      const auto& view = chainman.ActiveChainstate ().CoinsTip ();
+      for (auto& name : names)
+        {
+          CNameData data;
+          if (view.GetName (name, data))
+            found.emplace_back (std::make_pair (std::move (name), std::move (data)));
+          else
+            found.emplace_back ();
+        }
+    }
+
+  MaybeWalletForRequest wallet(request);
+  LOCK2 (wallet.getLock (), cs_main);
+  UniValue res(UniValue::VARR);
+  for (const auto& entry : found)
+    {
+      if (!entry)
+        {
+          res.push_back (NullUniValue);
+          continue;
+        }
+
+      UniValue name_object
+          = getNameInfo (chainman, options, entry->first, entry->second, wallet);
+      if (!allow_expired && name_object["expired"].get_bool ())
+        res.push_back (NullUniValue);
+      else
+        res.push_back (std::move (name_object));
+    }
+
+  return res;
+}
+  );
+}
+
+/* ************************************************************************** */
+
 RPCMethod
 name_history ()
 {
@@ -583,7 +789,11 @@ name_history ()
       .withByHash ();
 
   return RPCMethod ("name_history",
-      "Looks up the current and all past data for the given name.  -namehistory must be enabled.\n",
+      "Looks up the current and all past data for the given name.  -namehistory must be enabled.\n"
+      "When the result is streamed over HTTP, the locks are released after"
+      " every " + std::to_string (NAME_STREAM_BATCH_SIZE) + " entries, so"
+      " that the expiration data of a single result can be based on different"
+      " chain tips.\n",
       {
           {"name", RPCArg::Type::STR, RPCArg::Optional::NO, "The name to query for"},
           optHelp.buildRpcArg (),
@@ -635,20 +845,98 @@ name_history ()
   }
 
   MaybeWalletForRequest wallet(request);
-  LOCK2 (wallet.getLock (), cs_main);
-
-  UniValue res(UniValue::VARR);
-  for (const auto& entry : history.getData ())
-    res.push_back (getNameInfo (chainman, options, name, entry, wallet));
-  res.push_back (getNameInfo (chainman, options, name, data, wallet));
+  RPCResultWriter res(request, UniValue::VARR);
+
+  /* When the result is streamed, the locks are not held while the entries
+     are sent out.  */
+  std::vector<CNameData> entries = history.getData ();
+  entries.push_back (std::move (data));
+  const size_t batchSize
+      = res.IsStreaming () ? NAME_STREAM_BATCH_SIZE : entries.size ();
+  for (size_t start = 0; start < entries.size (); start += batchSize)
+    {
+      std::vector<UniValue> batch;
+      {
+        LOCK2 (wallet.getLock (), cs_main);
+        const size_t end = std::min (start + batchSize, entries.size ());
+        for (size_t i = start; i < end; ++i)
+          batch.push_back (getNameInfo (chainman, options, name, entries[i],
+                                        wallet));
+      }
+      for (auto& entry : batch)
+        res.push_back (std::move (entry));
+    }
 
-  return res;
+  return res.finish ();
 }
   );
 }
 
 /* ************************************************************************** */
 
+namespace
+{
+
+/**
+ * Scans the name database for name_scan, starting at the given name, until
+ * maxCount matching names have been found or the end is reached.  The latter
+ * is signalled by returning true.  name is set to the last name seen, so that
+ * the scan can be continued from there (with skipFirst set) in a later batch.
+ */
+bool
+ScanNamesBatch (const ChainstateManager& chainman, const UniValue& options,
+                const MaybeWalletForRequest& wallet, valtype& name,
+                const bool skipFirst, const size_t maxCount,
+                const int minHeight, const int maxHeight,
+                const valtype& prefix, const boost::xpressive::sregex* regexp,
+                std::vector<UniValue>& result)
+  EXCLUSIVE_LOCKS_REQUIRED (cs_main)
+{
+  const valtype seekName = name;
+  CNameData data;
+  const auto& coinsTip = chainman.ActiveChainstate ().CoinsTip ();
+  std::unique_ptr<CNameIterator> iter(coinsTip.IterateNames ());
+  for (iter->seek (seekName); result.size () < maxCount; )
+    {
+      if (!iter->next (name, data))
+        return true;
+      if (skipFirst && name == seekName)
+        continue;
+
+      const int height = data.getHeight ();
+      if (height > maxHeight)
+        continue;
+      if (minHeight >= 0 && height < minHeight)
+        continue;
+
+      if (name.size () < prefix.size ())
+        continue;
+      if (!std::equal (prefix.begin (), prefix.end (), name.begin ()))
+        continue;
+
+      if (regexp != nullptr)
+        {
+          try
+            {
+              const std::string nameStr = EncodeName (name, NameEncoding::UTF8);
+              boost::xpressive::smatch matches;
+              if (!boost::xpressive::regex_search (nameStr, matches, *regexp))
+                continue;
+            }
+          catch (const InvalidNameString& exc)
+            {
+              continue;
+            }
+        }
+
+      result.push_back (getNameInfo (chainman, options, name, data, wallet));
+    }
+
+  return false;
+}
+
+} // anonymous namespace
+
 RPCMethod
 name_scan ()
 {
@@ -666,7 +954,11 @@ name_scan ()
                 "Filter for names matching the regexp");
 
   return RPCMethod ("name_scan",
-      "Lists names in the database.\n",
+      "Lists names in the database.\n"
+      "When the result is streamed over HTTP, the locks are released after"
+      " every " + std::to_string (NAME_STREAM_BATCH_SIZE) + " names, so that"
+      " a single result can span different chain tips if blocks are"
+      " connected or disconnected in the meantime.\n",
       {
           {"start", RPCArg::Type::STR, RPCArg::Default{""}, "Skip initially to this name"},
           {"count", RPCArg::Type::NUM, RPCArg::Default{500}, "Stop after this many names"},
@@ -742,56 +1034,47 @@ name_scan ()
       regexp = boost::xpressive::sregex::compile (options["regexp"].get_str ());
     }
 
-  /* Iterate over names and produce the result.  */
-  UniValue res(UniValue::VARR);
+  /* Iterate over names and produce the result.  If the result is streamed,
+     this is done in batches, and the locks are released while each batch is
+     sent out.  The next batch continues after the last name seen.  */
+  RPCResultWriter res(request, UniValue::VARR);
   if (count <= 0)
-    return res;
+    return res.finish ();
 
   MaybeWalletForRequest wallet(request);
-  LOCK2 (wallet.getLock (), cs_main);
-
-  const int maxHeight = chainman.ActiveHeight () - minConf + 1;
+  const int tipHeight = WITH_LOCK (cs_main, return chainman.ActiveHeight ());
+  const int maxHeight = tipHeight - minConf + 1;
   int minHeight = -1;
   if (maxConf >= 0)
-    minHeight = chainman.ActiveHeight () - maxConf + 1;
-
-  valtype name;
-  CNameData data;
-  const auto& coinsTip = chainman.ActiveChainstate ().CoinsTip ();
-  std::unique_ptr<CNameIterator> iter(coinsTip.IterateNames ());
-  for (iter->seek (start); count > 0 && iter->next (name, data); )
+    minHeight = tipHeight - maxConf + 1;
+
+  const size_t batchSize = res.IsStreaming ()
+                              ? NAME_STREAM_BATCH_SIZE
+                              : std::numeric_limits<size_t>::max ();
+  valtype name = start;
+  bool skipSeekName = false;
+  bool done = false;
+  while (!done)
     {
-      const int height = data.getHeight ();
-      if (height > maxHeight)
-        continue;
-      if (minHeight >= 0 && height < minHeight)
-        continue;
-
-      if (name.size () < prefix.size ())
-        continue;
-      if (!std::equal (prefix.begin (), prefix.end (), name.begin ()))
-        continue;
+      std::vector<UniValue> batch;
+      {
+        LOCK2 (wallet.getLock (), cs_main);
+        done = ScanNamesBatch (chainman, options, wallet, name, skipSeekName,
+                               std::min<size_t> (count, batchSize),
+                               minHeight, maxHeight, prefix,
+                               haveRegexp ? &regexp : nullptr, batch);
+      }
 
-      if (haveRegexp)
-        {
-          try
-            {
-              const std::string nameStr = EncodeName (name, NameEncoding::UTF8);
-              boost::xpressive::smatch matches;
-              if (!boost::xpressive::regex_search (nameStr, matches, regexp))
-                continue;
-            }
-          catch (const InvalidNameString& exc)
-            {
-              continue;
-            }
-        }
+      count -= batch.size ();
+      if (count <= 0)
+        done = true;
+      skipSeekName = true;
 
-      res.push_back (getNameInfo (chainman, options, name, data, wallet));
-      --count;
+      for (auto& entry : batch)
+        res.push_back (std::move (entry));
     }
 
-  return res;
+  return res.finish ();
 }
   );
 }
@@ -1133,6 +1416,7 @@ static const CRPCCommand commands[] =
 { //  category               actor (function)
   //  ---------------------  -----------------------
     { "names",               &name_show,               },
+    { "names",               &name_show_many,          },
     { "names",               &name_history,            },
     { "names",               &name_scan,               },
     { "names",               &name_pending,            },
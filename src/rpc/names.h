@@ -12,7 +12,9 @@
 #include <script/script.h>
 #include <span.h>
 
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 /** Default value for the -allowexpired argument.  */
@@ -24,6 +26,7 @@ class COutPoint;
 class CRPCCommand;
 class CScript;
 class UniValue;
+class uint256;
 
 UniValue getNameInfo (const UniValue& options,
                       const valtype& name, const valtype& value,
@@ -34,6 +37,16 @@ UniValue getNameInfo (const ChainstateManager& chainman,
 void addExpirationInfo (const ChainstateManager& chainman,
                         int height, UniValue& data);
 
+/**
+ * Looks up the current data of names by the SHA-256d hashes of the names,
+ * with a single batch lookup in the name-hash index (which must be enabled).
+ * The result holds the name and its data for each hash, or is empty if the
+ * name is unknown or (unless allowExpired is set) expired.
+ */
+std::vector<std::optional<std::pair<valtype, CNameData>>>
+  LookupNamesByHash (const ChainstateManager& chainman,
+                     std::span<const uint256> hashes, bool allowExpired);
+
 std::span<const CRPCCommand> GetNameRPCCommands ();
 
 #ifdef ENABLE_WALLET
@@ -13,6 +13,7 @@
 #include <util/fs_helpers.h>
 #include <util/strencodings.h>
 
+#include <cassert>
 #include <fstream>
 #include <stdexcept>
 #include <string>
@@ -67,6 +68,45 @@ UniValue JSONRPCReplyObj(UniValue result, UniValue error, std::optional<UniValue
     return reply;
 }
 
+RPCResultWriter::RPCResultWriter(const JSONRPCRequest& request, UniValue::VType type)
+    : m_stream{request.m_result_stream}, m_result{type}
+{
+    assert(type == UniValue::VARR || type == UniValue::VOBJ);
+}
+
+void RPCResultWriter::push_back(UniValue value)
+{
+    assert(m_result.isArray());
+    if (!m_stream) {
+        m_result.push_back(std::move(value));
+        return;
+    }
+    if (!m_started) {
+        m_stream->Begin(UniValue::VARR);
+        m_started = true;
+    }
+    m_stream->Push(value);
+}
+
+void RPCResultWriter::pushKV(std::string key, UniValue value)
+{
+    assert(m_result.isObject());
+    if (!m_stream) {
+        m_result.pushKV(std::move(key), std::move(value));
+        return;
+    }
+    if (!m_started) {
+        m_stream->Begin(UniValue::VOBJ);
+        m_started = true;
+    }
+    m_stream->PushKV(key, value);
+}
+
+UniValue RPCResultWriter::finish()
+{
+    return std::move(m_result);
+}
+
 UniValue JSONRPCError(int code, const std::string& message)
 {
     UniValue error(UniValue::VOBJ);
@@ -49,6 +49,25 @@ void DeleteAuthCookie();
 /** Parse JSON-RPC batch reply into a vector */
 std::vector<UniValue> JSONRPCProcessBatchReply(const UniValue& in);
 
+/**
+ * Receives the entries of an RPC result while the RPC method produces them,
+ * so that a large result can be sent out without being held as a whole.
+ * Only the top-level array or object of a result can be streamed.
+ * RPC methods use this through RPCResultWriter.
+ */
+class JSONRPCResultStream
+{
+public:
+    virtual ~JSONRPCResultStream() = default;
+
+    /** Starts the result, which has the given type (VARR or VOBJ). */
+    virtual void Begin(UniValue::VType type) = 0;
+    /** Adds the next element of an array result. */
+    virtual void Push(const UniValue& value) = 0;
+    /** Adds the next entry of an object result. */
+    virtual void PushKV(const std::string& key, const UniValue& value) = 0;
+};
+
 class JSONRPCRequest
 {
 public:
@@ -62,9 +81,37 @@ public:
     std::any context;
     std::any context2;
     JSONRPCVersion m_json_version = JSONRPCVersion::V1_LEGACY;
+    //! If set, RPC methods that support it send their result here instead of returning it.
+    JSONRPCResultStream* m_result_stream{nullptr};
 
     void parse(const UniValue& valRequest);
     [[nodiscard]] bool IsNotification() const { return !id.has_value() && m_json_version == JSONRPCVersion::V2; };
 };
 
+/**
+ * Builds the top-level array or object result of an RPC method. If the
+ * request has a result stream, the entries are passed on to it right away
+ * and the returned result is only an empty placeholder. Otherwise they are
+ * collected into the result as usual.
+ */
+class RPCResultWriter
+{
+public:
+    RPCResultWriter(const JSONRPCRequest& request, UniValue::VType type);
+
+    /** Whether the entries are streamed rather than collected. */
+    bool IsStreaming() const { return m_stream != nullptr; }
+
+    void push_back(UniValue value);
+    void pushKV(std::string key, UniValue value);
+
+    /** Returns the value to return from the RPC method. */
+    UniValue finish();
+
+private:
+    JSONRPCResultStream* const m_stream;
+    bool m_started{false};
+    UniValue m_result;
+};
+
 #endif // BITCOIN_RPC_REQUEST_H
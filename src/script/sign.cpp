@@ -7,6 +7,7 @@
 
 #include <addresstype.h>
 #include <coins.h>
+#include <common/system.h>
 #include <consensus/amount.h>
 #include <hash.h>
 #include <key.h>
@@ -24,6 +25,7 @@
 #include <serialize.h>
 #include <uint256.h>
 #include <util/check.h>
+#include <util/threadpool.h>
 #include <util/translation.h>
 #include <util/vector.h>
 
@@ -31,7 +33,9 @@
 #include <array>
 #include <cstddef>
 #include <functional>
+#include <future>
 #include <iterator>
+#include <optional>
 #include <span>
 #include <string>
 
@@ -1021,6 +1025,11 @@ bool IsSegWitOutput(const SigningProvider& provider, const CScript& script)
     return false;
 }
 
+/** Minimum number of inputs for which SignTransaction signs them in parallel. */
+static constexpr size_t PARALLEL_SIGN_MIN_INPUTS{32};
+/** Maximum number of threads used by SignTransaction. */
+static constexpr int MAX_SIGN_THREADS{16};
+
 bool SignTransaction(CMutableTransaction& mtx, const SigningProvider* keystore, const std::map<COutPoint, Coin>& coins, const SignOptions& options, std::map<int, bilingual_str>& input_errors)
 {
     bool fHashSingle = ((options.sighash_type & ~SIGHASH_ANYONECANPAY) == SIGHASH_SINGLE);
@@ -1045,22 +1054,67 @@ bool SignTransaction(CMutableTransaction& mtx, const SigningProvider* keystore,
         txdata.Init(txConst, std::move(spent_outputs), true);
     }
 
-    // Sign what we can:
-    for (unsigned int i = 0; i < mtx.vin.size(); ++i) {
-        CTxIn& txin = mtx.vin[i];
-        auto coin = coins.find(txin.prevout);
+    // Produce the signatures for all inputs before updating any of them.
+    // Signing an input does not depend on the others' scriptSig and witness,
+    // so this allows signing the inputs of large transactions in parallel,
+    // all sharing the same txdata.
+    std::vector<std::optional<SignatureData>> sigdatas(mtx.vin.size());
+    const auto sign_input{[&](const unsigned int i) {
+        auto coin = coins.find(mtx.vin[i].prevout);
         if (coin == coins.end() || coin->second.IsSpent()) {
-            input_errors[i] = _("Input not found or already spent");
-            continue;
+            return;
         }
-        const CScript& prevPubKey = coin->second.out.scriptPubKey;
-        const CAmount& amount = coin->second.out.nValue;
-
         SignatureData sigdata = DataFromTransaction(mtx, i, coin->second.out);
         // Only sign SIGHASH_SINGLE if there's a corresponding output:
         if (!fHashSingle || (i < mtx.vout.size())) {
-            ProduceSignature(*keystore, MutableTransactionSignatureCreator(mtx, i, amount, &txdata, options), prevPubKey, sigdata);
+            ProduceSignature(*keystore, MutableTransactionSignatureCreator(mtx, i, coin->second.out.nValue, &txdata, options), coin->second.out.scriptPubKey, sigdata);
+        }
+        sigdatas[i] = std::move(sigdata);
+    }};
+
+    // MuSig2 signing keeps session state in the provider, so it is only
+    // done sequentially.
+    int num_threads{1};
+    if (mtx.vin.size() >= PARALLEL_SIGN_MIN_INPUTS && keystore->GetAllMuSig2ParticipantPubkeys().empty()) {
+        num_threads = std::min<int>({GetNumCores(), MAX_SIGN_THREADS, static_cast<int>(mtx.vin.size() / (PARALLEL_SIGN_MIN_INPUTS / 2))});
+    }
+    if (num_threads > 1) {
+        ThreadPool sign_pool{"sign"};
+        sign_pool.Start(num_threads);
+        std::vector<std::future<void>> futures;
+        for (int t = 0; t < num_threads; ++t) {
+            const auto sign_inputs{[&, t] {
+                for (unsigned int i = t; i < mtx.vin.size(); i += num_threads) {
+                    sign_input(i);
+                }
+            }};
+            auto future{sign_pool.Submit(sign_inputs)};
+            if (future) {
+                futures.push_back(std::move(*future));
+            } else {
+                sign_inputs();
+            }
+        }
+        for (auto& future : futures) {
+            future.get();
+        }
+    } else {
+        for (unsigned int i = 0; i < mtx.vin.size(); ++i) {
+            sign_input(i);
+        }
+    }
+
+    // Sign what we can:
+    for (unsigned int i = 0; i < mtx.vin.size(); ++i) {
+        CTxIn& txin = mtx.vin[i];
+        if (!sigdatas[i]) {
+            input_errors[i] = _("Input not found or already spent");
+            continue;
         }
+        const CTxOut& prevout = coins.at(txin.prevout).out;
+        const CScript& prevPubKey = prevout.scriptPubKey;
+        const CAmount& amount = prevout.nValue;
+        const SignatureData& sigdata = *sigdatas[i];
 
         UpdateInput(txin, sigdata);
 
@@ -0,0 +1,126 @@
+// Copyright (c) 2026 The Namecoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <auxpow.h>
+#include <primitives/block.h>
+#include <primitives/block_view.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <serialize.h>
+#include <streams.h>
+#include <test/util/common.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <ios>
+#include <vector>
+
+namespace
+{
+
+CMutableTransaction BuildTransaction(const size_t num_inputs, const size_t num_outputs, const bool witness)
+{
+    CMutableTransaction mtx;
+    mtx.version = 2;
+    mtx.nLockTime = 42;
+    for (size_t i{0}; i < num_inputs; ++i) {
+        mtx.vin.emplace_back(COutPoint{Txid::FromUint256(uint256{static_cast<uint8_t>(i + 1)}), static_cast<uint32_t>(i)},
+                             CScript{} << std::vector<unsigned char>(i + 10, 'x'), static_cast<uint32_t>(1000 + i));
+        if (witness) mtx.vin.back().scriptWitness.stack = {{1, 2, 3}, std::vector<unsigned char>(100, 'w')};
+    }
+    for (size_t i{0}; i < num_outputs; ++i) {
+        mtx.vout.emplace_back(static_cast<CAmount>(1000 * (i + 1)), CScript{} << OP_2 << std::vector<unsigned char>(i + 1, 'n') << OP_2DROP << OP_TRUE);
+    }
+    return mtx;
+}
+
+std::vector<std::byte> SerializeBlock(const CBlock& block)
+{
+    DataStream stream;
+    stream << TX_WITH_WITNESS(block);
+    return {stream.begin(), stream.end()};
+}
+
+void CheckMatches(const BlockView& view, const CBlock& block)
+{
+    BOOST_CHECK_EQUAL(view.GetHeader().GetHash(), block.GetHash());
+    BOOST_CHECK_EQUAL(view.GetHeaderSize(), GetSerializeSize(static_cast<const CBlockHeader&>(block)));
+    BOOST_REQUIRE_EQUAL(view.GetTransactions().size(), block.vtx.size());
+
+    for (size_t i{0}; i < block.vtx.size(); ++i) {
+        const TxView& tx_view{view.GetTransactions()[i]};
+        const CTransaction& tx{*block.vtx[i]};
+        BOOST_CHECK_EQUAL(tx_view.GetHash(), tx.GetHash());
+        BOOST_CHECK_EQUAL(tx_view.GetWitnessHash(), tx.GetWitnessHash());
+        BOOST_CHECK_EQUAL(tx_view.HasWitness(), tx.HasWitness());
+        BOOST_CHECK_EQUAL(tx_view.GetTotalSize(), tx.ComputeTotalSize());
+
+        size_t n{0};
+        tx_view.ForEachInput([&](const TxView::Input& in) {
+            BOOST_REQUIRE(n < tx.vin.size());
+            BOOST_CHECK(in.prevout == tx.vin[n].prevout);
+            BOOST_CHECK(CScript(in.script_sig.begin(), in.script_sig.end()) == tx.vin[n].scriptSig);
+            BOOST_CHECK_EQUAL(in.sequence, tx.vin[n].nSequence);
+            ++n;
+        });
+        BOOST_CHECK_EQUAL(n, tx.vin.size());
+
+        n = 0;
+        tx_view.ForEachOutput([&](const TxView::Output& out) {
+            BOOST_REQUIRE(n < tx.vout.size());
+            BOOST_CHECK_EQUAL(out.value, tx.vout[n].nValue);
+            BOOST_CHECK(CScript(out.script_pub_key.begin(), out.script_pub_key.end()) == tx.vout[n].scriptPubKey);
+            ++n;
+        });
+        BOOST_CHECK_EQUAL(n, tx.vout.size());
+    }
+}
+
+} // anonymous namespace
+
+BOOST_FIXTURE_TEST_SUITE(block_view_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(matches_deserialized_block)
+{
+    CBlock block;
+    block.nVersion = 4;
+    block.nTime = 1234;
+    block.vtx.push_back(MakeTransactionRef(BuildTransaction(1, 1, false)));
+    block.vtx.push_back(MakeTransactionRef(BuildTransaction(3, 2, true)));
+    block.vtx.push_back(MakeTransactionRef(BuildTransaction(2, 5, false)));
+    block.vtx.push_back(MakeTransactionRef(BuildTransaction(0, 0, false)));
+
+    const auto raw{SerializeBlock(block)};
+    CheckMatches(BlockView{raw}, block);
+
+    // A merge-mined block has a variable-size header.
+    block.SetAuxpowVersion(true);
+    CAuxPow::initAuxPow(block);
+    const auto raw_auxpow{SerializeBlock(block)};
+    const BlockView view{raw_auxpow};
+    BOOST_CHECK(view.GetHeader().auxpow != nullptr);
+    CheckMatches(view, block);
+}
+
+BOOST_AUTO_TEST_CASE(malformed_data)
+{
+    CBlock block;
+    block.vtx.push_back(MakeTransactionRef(BuildTransaction(2, 2, true)));
+    const auto raw{SerializeBlock(block)};
+
+    for (size_t len{0}; len < raw.size(); ++len) {
+        BOOST_CHECK_THROW(BlockView{std::span{raw}.first(len)}, std::ios_base::failure);
+    }
+
+    // A witness flag without any witness is rejected like for CTransaction.
+    CMutableTransaction mtx{BuildTransaction(1, 1, false)};
+    DataStream stream;
+    stream << mtx.version << uint8_t{0} << uint8_t{1} << mtx.vin << mtx.vout << uint8_t{0} << mtx.nLockTime;
+    const std::vector<std::byte> tx_raw{stream.begin(), stream.end()};
+    BOOST_CHECK_EXCEPTION(TxView::Parse(tx_raw), std::ios_base::failure, HasReason{"Superfluous witness record"});
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -8,6 +8,7 @@
 #include <blockfilter.h>
 #include <core_io.h>
 #include <primitives/block.h>
+#include <script/names.h>
 #include <serialize.h>
 #include <streams.h>
 #include <undo.h>
@@ -127,6 +128,44 @@ BOOST_AUTO_TEST_CASE(blockfilter_basic_test)
     BOOST_CHECK(default_ctor_block_filter_1.GetEncodedFilter() == default_ctor_block_filter_2.GetEncodedFilter());
 }
 
+BOOST_AUTO_TEST_CASE(blockfilter_name_scripts)
+{
+    CScript output_addr, spent_addr, other_addr;
+    output_addr << OP_0 << std::vector<unsigned char>(20, 1);
+    spent_addr << OP_0 << std::vector<unsigned char>(32, 2);
+    other_addr << OP_0 << std::vector<unsigned char>(20, 3);
+
+    const valtype name{'d', '/', 'x'};
+    const valtype value{'{', '}'};
+    const CScript output_script = CNameScript::buildNameUpdate(output_addr, name, value);
+    const CScript spent_script = CNameScript::buildNameFirstupdate(spent_addr, name, value, valtype(20, 4));
+
+    CMutableTransaction tx;
+    tx.vout.emplace_back(COIN / 100, output_script);
+    CBlock block;
+    block.vtx.push_back(MakeTransactionRef(tx));
+    CBlockUndo block_undo;
+    block_undo.vtxundo.emplace_back();
+    block_undo.vtxundo.back().vprevout.emplace_back(CTxOut(COIN / 100, spent_script), 100, false);
+
+    // The BASIC filter is exactly as in BIP 158, with only the full scripts.
+    const BlockFilter basic_filter(BlockFilterType::BASIC, block, block_undo);
+    for (const CScript& script : {output_script, spent_script}) {
+        BOOST_CHECK(basic_filter.GetFilter().Match(GCSFilter::Element(script.begin(), script.end())));
+    }
+    for (const CScript& script : {output_addr, spent_addr}) {
+        BOOST_CHECK(!basic_filter.GetFilter().Match(GCSFilter::Element(script.begin(), script.end())));
+    }
+
+    // In the NAMES filter, both the full name scripts and their address parts match.
+    const BlockFilter names_filter(BlockFilterType::NAMES, block, block_undo);
+    const GCSFilter& filter = names_filter.GetFilter();
+    for (const CScript& script : {output_script, spent_script, output_addr, spent_addr}) {
+        BOOST_CHECK(filter.Match(GCSFilter::Element(script.begin(), script.end())));
+    }
+    BOOST_CHECK(!filter.Match(GCSFilter::Element(other_addr.begin(), other_addr.end())));
+}
+
 BOOST_AUTO_TEST_CASE(blockfilters_json_test)
 {
     UniValue json;
@@ -179,11 +218,14 @@ BOOST_AUTO_TEST_CASE(blockfilters_json_test)
 BOOST_AUTO_TEST_CASE(blockfilter_type_names)
 {
     BOOST_CHECK_EQUAL(BlockFilterTypeName(BlockFilterType::BASIC), "basic");
+    BOOST_CHECK_EQUAL(BlockFilterTypeName(BlockFilterType::NAMES), "names");
     BOOST_CHECK_EQUAL(BlockFilterTypeName(static_cast<BlockFilterType>(255)), "");
 
     BlockFilterType filter_type;
     BOOST_CHECK(BlockFilterTypeByName("basic", filter_type));
     BOOST_CHECK_EQUAL(filter_type, BlockFilterType::BASIC);
+    BOOST_CHECK(BlockFilterTypeByName("names", filter_type));
+    BOOST_CHECK_EQUAL(filter_type, BlockFilterType::NAMES);
 
     BOOST_CHECK(!BlockFilterTypeByName("unknown", filter_type));
 }
@@ -216,6 +216,32 @@ BOOST_FIXTURE_TEST_CASE(blockmanager_block_data_part_error, TestChain100Setup)
     expect_part_error(std::numeric_limits<size_t>::max(), std::numeric_limits<size_t>::max());
 }
 
+BOOST_FIXTURE_TEST_CASE(blockmanager_served_block_cache, TestChain100Setup)
+{
+    LOCK(::cs_main);
+    auto& chainman{m_node.chainman};
+    auto& blockman{chainman->m_blockman};
+    const CBlockIndex& tip{*chainman->ActiveTip()};
+    const FlatFilePos tip_block_pos{tip.GetBlockPos()};
+
+    const auto raw{blockman.ReadRawBlock(tip_block_pos)};
+    BOOST_REQUIRE(raw);
+
+    // The second read is answered from the cache with the same buffer.
+    const auto first{blockman.ReadServedBlock(tip.GetBlockHash(), tip_block_pos)};
+    BOOST_REQUIRE(first);
+    BOOST_CHECK(**first == *raw);
+    const auto second{blockman.ReadServedBlock(tip.GetBlockHash(), tip_block_pos)};
+    BOOST_REQUIRE(second);
+    BOOST_CHECK_EQUAL(first->get(), second->get());
+
+    // Partial reads bypass the cache.
+    const auto part{blockman.ReadServedBlock(tip.GetBlockHash(), tip_block_pos, std::pair{size_t{1}, size_t{10}})};
+    BOOST_REQUIRE(part);
+    BOOST_CHECK_EQUAL((*part)->size(), 10U);
+    BOOST_CHECK(std::equal((*part)->begin(), (*part)->end(), raw->begin() + 1));
+}
+
 BOOST_FIXTURE_TEST_CASE(blockmanager_readblock_hash_mismatch, TestingSetup)
 {
     CBlockIndex index;
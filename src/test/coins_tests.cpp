@@ -81,6 +81,7 @@ public:
             ret += entry.second.coin.DynamicMemoryUsage();
             ++count;
         }
+        ret += NameCacheMemoryUsage();
         BOOST_CHECK_EQUAL(GetCacheSize(), count);
         BOOST_CHECK_EQUAL(DynamicMemoryUsage(), ret);
         if (sanity_check) {
@@ -438,6 +438,13 @@ bool FuzzedSock::WaitMany(std::chrono::milliseconds timeout, EventsPerSock& even
     return true;
 }
 
+bool FuzzedSock::WaitManyPersistent(std::chrono::milliseconds timeout,
+                                    EventsPerSock& events_per_sock,
+                                    SockPoller&) const
+{
+    return WaitMany(timeout, events_per_sock);
+}
+
 bool FuzzedSock::IsConnected(std::string& errmsg) const
 {
     if (m_fuzzed_data_provider.ConsumeBool()) {
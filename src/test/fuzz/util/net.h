@@ -152,6 +152,8 @@ public:
 
     virtual bool HasAllDesirableServiceFlags(ServiceFlags) const override { return m_fdp.ConsumeBool(); }
 
+    virtual void PrepareMessages(CNode&) override {}
+
     virtual bool ProcessMessages(CNode&, std::atomic<bool>&) override { return m_fdp.ConsumeBool(); }
 
     virtual bool SendMessages(CNode&) override { return m_fdp.ConsumeBool(); }
@@ -220,6 +222,10 @@ public:
 
     bool WaitMany(std::chrono::milliseconds timeout, EventsPerSock& events_per_sock) const override;
 
+    bool WaitManyPersistent(std::chrono::milliseconds timeout,
+                            EventsPerSock& events_per_sock,
+                            SockPoller& poller) const override;
+
     bool IsConnected(std::string& errmsg) const override;
 };
 
@@ -631,6 +631,71 @@ BOOST_AUTO_TEST_CASE(http_server_socket_tests)
     server.StopListening();
 }
 
+BOOST_AUTO_TEST_CASE(http_server_chunked_reply_tests)
+{
+    SetMockTime(1733878029);
+
+    Mutex requests_mutex;
+    std::deque<std::unique_ptr<HTTPRequest>> requests;
+    auto StoreRequest = [&](std::unique_ptr<HTTPRequest>&& req) {
+        LOCK(requests_mutex);
+        requests.push_back(std::move(req));
+    };
+
+    HTTPServer server{StoreRequest};
+    server.InitHTTPAllowList();
+    CService addr_bind{Lookup("0.0.0.0", /*portDefault=*/0, /*fAllowLookup=*/false).value()};
+    BOOST_REQUIRE(server.BindAndStartListening(addr_bind));
+    server.StartSocketsThreads();
+
+    std::shared_ptr<DynSock::Pipes> mock_client_socket_pipes{ConnectClient(std::as_bytes(std::span(full_request)))};
+
+    // Wait up to a minute for the request and reply to it in several chunks.
+    int attempts{6000};
+    while (true) {
+        {
+            LOCK(requests_mutex);
+            if (requests.size() == 1) {
+                auto& req{*requests.front()};
+                req.StartChunkedReply(HTTP_OK);
+                BOOST_CHECK(req.WriteReplyChunk("hello"));
+                // Empty chunks are skipped, they would end the body.
+                BOOST_CHECK(req.WriteReplyChunk(""));
+                BOOST_CHECK(req.WriteReplyChunk(std::string(20, 'x')));
+                req.EndChunkedReply();
+                break;
+            }
+        }
+        std::this_thread::sleep_for(10ms);
+        BOOST_REQUIRE(--attempts > 0);
+    }
+
+    std::string actual;
+    char buf[0x10000] = {};
+    attempts = 6000;
+    while (!actual.ends_with("\r\n0\r\n\r\n")) {
+        ssize_t bytes_read = mock_client_socket_pipes->send.GetBytes(buf, sizeof(buf), 0);
+        if (bytes_read > 0) actual.append(buf, bytes_read);
+        std::this_thread::sleep_for(10ms);
+        BOOST_REQUIRE(--attempts > 0);
+    }
+    BOOST_CHECK(actual.starts_with("HTTP/1.1 200 OK\r\n"));
+    BOOST_CHECK(actual.find("Transfer-Encoding: chunked\r\n") != std::string::npos);
+    BOOST_CHECK(actual.find("Content-Length") == std::string::npos);
+    BOOST_CHECK(actual.ends_with("\r\n\r\n5\r\nhello\r\n14\r\n" + std::string(20, 'x') + "\r\n0\r\n\r\n"));
+
+    // The client asked for the connection to be closed after the reply.
+    attempts = 6000;
+    while (server.GetConnectionsCount() != 0) {
+        std::this_thread::sleep_for(10ms);
+        BOOST_REQUIRE(--attempts > 0);
+    }
+
+    server.InterruptNet();
+    server.JoinSocketsThreads();
+    server.StopListening();
+}
+
 BOOST_AUTO_TEST_CASE(http_socket_error_tests)
 {
     // Create a tiny threadpool for the HTTPRequest handler
@@ -7,8 +7,13 @@
 #include <names/encoding.h>
 #include <test/util/setup_common.h>
 
+#include <univalue.h>
+
 #include <boost/test/unit_test.hpp>
 
+#include <string>
+#include <vector>
+
 BOOST_AUTO_TEST_SUITE(name_applications_tests)
 
 BOOST_AUTO_TEST_CASE( namespace_detection )
@@ -141,6 +146,30 @@ BOOST_AUTO_TEST_CASE( minimal_json )
     BOOST_CHECK_EQUAL(IsMinimalJSONOrEmptyString("{\"bar\":[1, 2, 3]}"), false);
 }
 
+BOOST_AUTO_TEST_CASE( json_checks_match_univalue )
+{
+    /* The JSON checks do not build a UniValue, but must agree with what
+       UniValue::read accepts and UniValue::write produces.  */
+    const std::vector<std::string> texts = {
+        "null", "true", "false", "42", "-1.5e3", "\"str\"", "[]", "{}",
+        " {} ", "{}\n", "{} x", "{}{}", "[1,2,]", "[,1]", "[1,,2]", "[1 2]",
+        "{\"a\":1,\"a\":2}", "{\"a\" :1}", "{\"a\":}", "{\"a\"}", "{1:2}",
+        "{\"a\":1,}", "[}", "{]", "]", ":", "[\"a\":1]", "{\"a\":[1,{\"b\":null}]}",
+        "\"\\u00e4\"", "\"\xc3\xa4\"", "\"\\n\"", "\"\\/\"", "\"\\u007f\"", "\"\x7f\"",
+        "\"\\u0041\"", "\"\\ud83d\\ude00\"", "\"\xff\"", "nul", "truex", "01", "1.",
+        std::string(600, '[') + std::string(600, ']'),
+        std::string(512, '[') + std::string(512, ']'),
+    };
+
+    for (const auto& text : texts) {
+        UniValue v;
+        const bool valid = v.read(text);
+        BOOST_CHECK_MESSAGE(IsValidJSONOrEmptyString(text) == valid, text);
+        const bool minimal = valid && v.write(0, 0) == text;
+        BOOST_CHECK_MESSAGE(IsMinimalJSONOrEmptyString(text) == minimal, text);
+    }
+}
+
 BOOST_AUTO_TEST_CASE( domain_detection )
 {
     BOOST_CHECK_EQUAL(IsPurportedNamecoinDomain("test.bit"), true);
@@ -19,6 +19,8 @@
 #include <test/util/common.h>
 #include <test/util/setup_common.h>
 
+#include <univalue.h>
+
 #include <boost/test/unit_test.hpp>
 
 #include <list>
@@ -190,6 +192,185 @@ BOOST_AUTO_TEST_CASE (name_database)
   BOOST_CHECK (setRet == setExpected);
 }
 
+BOOST_AUTO_TEST_CASE (name_database_separate)
+{
+  const fs::path path = m_args.GetDataDirBase () / "name_database_separate";
+  const valtype name1 = DecodeName ("migrated-name", NameEncoding::ASCII);
+  const valtype name2 = DecodeName ("new-name", NameEncoding::ASCII);
+  const valtype value = DecodeName ("my-value", NameEncoding::ASCII);
+  const unsigned height = 0x0142;
+
+  CNameData data;
+  const CScript updateScript
+      = CNameScript::buildNameUpdate (getTestAddress (), name1, value);
+  data.fromScript (height, COutPoint (Txid (), 0), CNameScript (updateScript));
+
+  const uint256 tip1 = m_rng.rand256 ();
+  const uint256 tip2 = m_rng.rand256 ();
+
+  /* Write name data in the layout of older versions, which kept it
+     in the coin database itself.  */
+  {
+    CDBWrapper legacy({.path = path, .cache_bytes = 1_MiB,
+                       .wipe_data = true, .obfuscate = true});
+    CDBBatch batch(legacy);
+    batch.Write (std::make_pair (uint8_t ('n'), name1), data);
+    batch.Write (std::make_pair (uint8_t ('x'),
+                                 CNameCache::ExpireEntry (height, name1)));
+    batch.Write (uint8_t ('B'), tip1);
+    legacy.WriteBatch (batch);
+  }
+
+  /* Opening the database moves the names over, and flushes keep both
+     databases at the same block.  */
+  {
+    CCoinsViewDB db({.path = path, .cache_bytes = 1_MiB}, {});
+    BOOST_CHECK (db.GetNamesBestBlock () == tip1);
+    BOOST_CHECK (db.NamesConsistent ());
+
+    CNameData read;
+    BOOST_CHECK (db.GetName (name1, read));
+    BOOST_CHECK (read == data);
+    std::set<valtype> names;
+    BOOST_CHECK (db.GetNamesForHeight (height, names));
+    BOOST_CHECK (names == std::set<valtype> ({name1}));
+
+    CCoinsViewCache cache(&db);
+    cache.SetName (name2, data, false);
+    cache.SetBestBlock (tip2);
+    cache.Flush ();
+    BOOST_CHECK (db.GetBestBlock () == tip2);
+    BOOST_CHECK (db.GetNamesBestBlock () == tip2);
+    BOOST_CHECK (db.GetName (name2, read));
+  }
+
+  {
+    CDBWrapper legacy({.path = path, .cache_bytes = 1_MiB, .obfuscate = true});
+    BOOST_CHECK (!legacy.Exists (std::make_pair (uint8_t ('n'), name1)));
+    BOOST_CHECK (!legacy.Exists (std::make_pair (uint8_t ('n'), name2)));
+    BOOST_CHECK (!legacy.Exists (std::make_pair (
+        uint8_t ('x'), CNameCache::ExpireEntry (height, name1))));
+
+    /* Move the coin database ahead of the name database.  */
+    legacy.Write (uint8_t ('B'), m_rng.rand256 ());
+  }
+
+  {
+    CCoinsViewDB db({.path = path, .cache_bytes = 1_MiB}, {});
+    BOOST_CHECK (!db.NamesConsistent ());
+  }
+
+  /* A chainstate of an older version without any names is consistent
+     with the (empty) name database.  */
+  const fs::path emptyPath = m_args.GetDataDirBase () / "name_database_empty";
+  {
+    CDBWrapper legacy({.path = emptyPath, .cache_bytes = 1_MiB,
+                       .wipe_data = true, .obfuscate = true});
+    legacy.Write (uint8_t ('B'), tip1);
+  }
+  {
+    CCoinsViewDB db({.path = emptyPath, .cache_bytes = 1_MiB}, {});
+    BOOST_CHECK (db.GetNamesBestBlock () == tip1);
+    BOOST_CHECK (db.NamesConsistent ());
+  }
+}
+
+BOOST_AUTO_TEST_CASE (name_cache_memory_usage)
+{
+  fNameHistory = true;
+
+  const valtype name = DecodeName ("memory-name", NameEncoding::ASCII);
+  const valtype longValue(MAX_VALUE_LENGTH, 'x');
+  const CScript addr = getTestAddress ();
+
+  CNameData longData;
+  longData.fromScript (100, COutPoint (Txid (), 0),
+                       CNameScript (CNameScript::buildNameUpdate (addr, name,
+                                                                  longValue)));
+
+  /* Empty hash maps may already hold a bucket array, so changes are
+     measured against the usage of the empty cache.  */
+  CNameCache cache;
+  const size_t emptyUsage = cache.DynamicMemoryUsage ();
+
+  cache.set (name, longData);
+  cache.addExpireIndex (name, 100);
+  const size_t usage = cache.DynamicMemoryUsage ();
+  BOOST_CHECK_GT (usage, emptyUsage + longValue.size ());
+
+  CNameHistory history;
+  history.push (longData);
+  cache.setHistory (name, history);
+  BOOST_CHECK_GT (cache.DynamicMemoryUsage (), usage + longValue.size ());
+  cache.setHistory (name, CNameHistory ());
+
+  cache.remove (name);
+  BOOST_CHECK_LT (cache.DynamicMemoryUsage (), usage);
+
+  cache.clear ();
+  BOOST_CHECK (cache.empty ());
+  BOOST_CHECK_EQUAL (cache.DynamicMemoryUsage (), emptyUsage);
+
+  /* The usage is part of the coins view cache's usage, and the changes
+     are dropped once flushed.  */
+  LOCK (cs_main);
+  CCoinsViewCache& tip = m_node.chainman->ActiveChainstate ().CoinsTip ();
+  CCoinsViewCache view(&tip);
+  const size_t baseUsage = view.DynamicMemoryUsage ();
+  view.SetName (name, longData, false);
+  BOOST_CHECK_GT (view.NameCacheMemoryUsage (), longValue.size ());
+  BOOST_CHECK_EQUAL (view.DynamicMemoryUsage () - view.NameCacheMemoryUsage (),
+                     baseUsage - emptyUsage);
+  view.SetBestBlock (tip.GetBestBlock ());
+  view.Flush ();
+  BOOST_CHECK_EQUAL (view.NameCacheMemoryUsage (), emptyUsage);
+  BOOST_CHECK_GT (tip.NameCacheMemoryUsage (), emptyUsage + longValue.size ());
+  tip.Flush ();
+  BOOST_CHECK_EQUAL (tip.NameCacheMemoryUsage (), emptyUsage);
+  CNameData data;
+  BOOST_CHECK (tip.GetName (name, data) && data == longData);
+}
+
+BOOST_AUTO_TEST_CASE (name_cache_expire_index)
+{
+  const auto n = [] (const std::string& str)
+    {
+      return DecodeName (str, NameEncoding::ASCII);
+    };
+
+  /* Changes are added out of order, so that the merge has to interleave
+     them, and the later cache overrides the earlier one.  */
+  CNameCache cache;
+  cache.addExpireIndex (n ("d"), 100);
+  cache.addExpireIndex (n ("b"), 100);
+  cache.removeExpireIndex (n ("c"), 100);
+  cache.addExpireIndex (n ("b"), 100);
+  cache.addExpireIndex (n ("x"), 200);
+
+  CNameCache other;
+  other.addExpireIndex (n ("e"), 100);
+  other.addExpireIndex (n ("c"), 100);
+  other.removeExpireIndex (n ("d"), 100);
+  other.addExpireIndex (n ("a"), 100);
+  other.addExpireIndex (n ("y"), 300);
+
+  const size_t usage = cache.DynamicMemoryUsage ();
+  cache.apply (other);
+  BOOST_CHECK_GT (cache.DynamicMemoryUsage (), usage);
+
+  std::set<valtype> names = {n ("d"), n ("z")};
+  cache.updateNamesForHeight (100, names);
+  BOOST_CHECK (names == std::set<valtype> ({n ("a"), n ("b"), n ("c"),
+                                            n ("e"), n ("z")}));
+
+  names.clear ();
+  cache.updateNamesForHeight (200, names);
+  BOOST_CHECK (names == std::set<valtype> ({n ("x")}));
+  names.clear ();
+  cache.updateNamesForHeight (300, names);
+  BOOST_CHECK (names == std::set<valtype> ({n ("y")}));
+}
+
 /* ************************************************************************** */
 
 /**
@@ -836,6 +1017,75 @@ BOOST_AUTO_TEST_CASE (name_updates_undo)
   BOOST_CHECK (undo.vnameundo.empty ());
 }
 
+BOOST_AUTO_TEST_CASE (name_undo_format)
+{
+  const valtype name1 = DecodeName ("undo-name-1", NameEncoding::ASCII);
+  const valtype name2 = DecodeName ("undo-name-2", NameEncoding::ASCII);
+  const valtype name3 = DecodeName ("undo-name-3", NameEncoding::ASCII);
+  const valtype value(MAX_VALUE_LENGTH, 'v');
+  const CScript addr = getTestAddress ();
+
+  const CScript upd1 = CNameScript::buildNameUpdate (addr, name1, value);
+  const COutPoint prevout1(Txid::FromUint256 (uint256::ONE), 1);
+  CNameData data1;
+  data1.fromScript (1000, prevout1, CNameScript (upd1));
+
+  /* The old data of name2 does not match a coin spent in the block, e.g.
+     because it was expired and is now registered again.  */
+  const CScript upd2 = CNameScript::buildNameUpdate (addr, name2, value);
+  CNameData data2;
+  data2.fromScript (500, prevout1, CNameScript (upd2));
+
+  CBlockUndo undo;
+  undo.vtxundo.resize (2);
+  undo.vtxundo[0].vprevout.emplace_back (CTxOut (COIN, addr), 900, false);
+  undo.vtxundo[1].vprevout.emplace_back (CTxOut (COIN, addr), 950, true);
+  undo.vtxundo[1].vprevout.emplace_back (CTxOut (COIN, upd1), 1000, false);
+  undo.vnameundo.emplace_back (name1, &data1);
+  undo.vnameundo.emplace_back (name2, &data2);
+  undo.vnameundo.emplace_back (name3, nullptr);
+  undo.vexpired.emplace_back (CTxOut (COIN, upd2), 500, false);
+
+  const auto checkEqual = [&undo] (const CBlockUndo& other)
+    {
+      DataStream expected, actual;
+      expected << undo.vtxundo << undo.vnameundo << undo.vexpired;
+      actual << other.vtxundo << other.vnameundo << other.vexpired;
+      BOOST_CHECK (expected.str () == actual.str ());
+    };
+
+  DataStream compact;
+  compact << undo;
+  CBlockUndo read;
+  compact >> read;
+  BOOST_CHECK (compact.empty ());
+  checkEqual (read);
+
+  /* The legacy format can still be read.  */
+  DataStream legacy;
+  legacy << undo.vtxundo << undo.vnameundo << undo.vexpired;
+  const size_t legacySize = legacy.size ();
+  legacy >> read;
+  BOOST_CHECK (legacy.empty ());
+  checkEqual (read);
+
+  /* The value of name1 is only stored once in the compact format.  */
+  compact << undo;
+  BOOST_CHECK_LT (compact.size () + value.size (), legacySize);
+
+  /* A reference to a coin that is not there is rejected.  To test this,
+     replace the tx undo data by one without the name coin.  */
+  DataStream txundo, shorter;
+  txundo << Using<VectorFormatter<TxUndoCompactFormatter>> (undo.vtxundo);
+  undo.vtxundo[1].vprevout.pop_back ();
+  shorter << Using<VectorFormatter<TxUndoCompactFormatter>> (undo.vtxundo);
+  std::string data = compact.str ();
+  data.replace (GetSizeOfCompactSize (CBlockUndo::COMPACT_FORMAT_MARKER),
+                txundo.size (), shorter.str ());
+  DataStream tampered(MakeByteSpan (data));
+  BOOST_CHECK_THROW (tampered >> read, std::ios_base::failure);
+}
+
 /* ************************************************************************** */
 
 BOOST_AUTO_TEST_CASE (name_expire_utxo)
@@ -1011,6 +1261,19 @@ BOOST_FIXTURE_TEST_CASE (encoding_ascii, EncodingTestSetup)
   InvalidData ({'a', 0, 'x'});
   InvalidData ({'a', 0x19, 'x'});
   InvalidData ({'a', 0x80, 'x'});
+
+  /* Longer strings are checked a word at a time.  Make sure that invalid
+     characters are found at every position.  */
+  const std::string longStr = "d/" + std::string (40, 'x') + "\x7f ~";
+  ValidRoundtrip (longStr, valtype (longStr.begin (), longStr.end ()));
+  for (size_t i = 0; i < longStr.size (); ++i)
+    for (const unsigned char c : {0x00, 0x1f, 0x80, 0xff})
+      {
+        valtype data(longStr.begin (), longStr.end ());
+        data[i] = c;
+        InvalidData (data);
+        InvalidString (std::string (data.begin (), data.end ()));
+      }
 }
 
 BOOST_FIXTURE_TEST_CASE (encoding_utf8, EncodingTestSetup)
@@ -1028,6 +1291,15 @@ BOOST_FIXTURE_TEST_CASE (encoding_utf8, EncodingTestSetup)
 
   InvalidString ("a\x80x");
   InvalidData ({'a', 0x80, 'x'});
+
+  /* Non-ASCII characters after a long ASCII prefix.  */
+  const std::string prefix(37, 'a');
+  const std::string longStr = prefix + utf8Str + prefix;
+  ValidRoundtrip (longStr, valtype (longStr.begin (), longStr.end ()));
+  InvalidString (prefix + "\x80");
+  InvalidString (prefix + "\xc3");
+  InvalidString (prefix + "\xc0\x80");
+  InvalidString (prefix + "\xed\xa0\x80");
 }
 
 BOOST_FIXTURE_TEST_CASE (encoding_hex, EncodingTestSetup)
@@ -1041,6 +1313,9 @@ BOOST_FIXTURE_TEST_CASE (encoding_hex, EncodingTestSetup)
 
   InvalidString ("aaa");
   InvalidString ("zz");
+  InvalidString ("00 ff");
+  InvalidString (" 00ff");
+  InvalidString ("0x00");
 }
 
 BOOST_AUTO_TEST_CASE (encode_name_for_message)
@@ -1051,6 +1326,14 @@ BOOST_AUTO_TEST_CASE (encode_name_for_message)
   BOOST_CHECK_EQUAL (
       EncodeNameForMessage (DecodeName ("00ff", NameEncoding::HEX)),
       "0x00ff");
+
+  UniValue obj(UniValue::VOBJ);
+  AddEncodedNameToUniv (obj, "name", {'a', 0x80}, NameEncoding::ASCII);
+  AddEncodedNameToUniv (obj, "value", {'a', 'b'}, NameEncoding::HEX);
+  BOOST_CHECK_EQUAL (obj.write (),
+                     R"({"name_error":"invalid data for ascii",)"
+                     R"("name_encoding":"ascii",)"
+                     R"("value":"6162","value_encoding":"hex"})");
 }
 
 /* ************************************************************************** */
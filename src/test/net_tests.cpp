@@ -936,6 +936,60 @@ BOOST_AUTO_TEST_CASE(initial_advertise_from_version_message)
     m_node.args->ForceSetArg("-bind", "");
 }
 
+BOOST_AUTO_TEST_CASE(prepared_messages_keep_order)
+{
+    auto& connman{static_cast<ConnmanTestMsg&>(*m_node.connman)};
+    m_node.connman->SetCaptureMessages(true);
+
+    CNode peer{/*id=*/0,
+               /*sock=*/nullptr,
+               /*addrIn=*/CAddress{LookupNumeric("1.2.3.4", 8333), NODE_NETWORK},
+               /*nKeyedNetGroupIn=*/0,
+               /*nLocalHostNonceIn=*/0,
+               /*addrBindIn=*/CService{},
+               /*addrNameIn=*/std::string{},
+               /*conn_type_in=*/ConnectionType::INBOUND,
+               /*inbound_onion=*/false,
+               /*network_key=*/0};
+    m_node.peerman->InitializeNode(peer, NODE_NETWORK);
+    WITH_LOCK(NetEventsInterface::g_msgproc_mutex,
+              connman.Handshake(peer,
+                                /*successfully_connected=*/true,
+                                /*remote_services=*/ServiceFlags(NODE_NETWORK | NODE_WITNESS),
+                                /*local_services=*/ServiceFlags(NODE_NETWORK | NODE_WITNESS),
+                                /*version=*/PROTOCOL_VERSION,
+                                /*relay_txs=*/true));
+    connman.FlushSendBuffer(peer); // Drop the messages sent after the handshake.
+
+    std::vector<uint64_t> pongs;
+    const auto CaptureMessageOrig = CaptureMessage;
+    CaptureMessage = [&pongs](const CAddress&, const std::string& msg_type,
+                              std::span<const unsigned char> data, bool is_incoming) {
+        if (!is_incoming && msg_type == NetMsgType::PONG) {
+            SpanReader{data} >> pongs.emplace_back();
+        }
+    };
+
+    // The first ping is taken off the queue by PrepareMessages(), and must
+    // still be answered before the ones that were queued behind or after it.
+    BOOST_REQUIRE(connman.ReceiveMsgFrom(peer, NetMsg::Make(NetMsgType::PING, uint64_t{1})));
+    BOOST_REQUIRE(connman.ReceiveMsgFrom(peer, NetMsg::Make(NetMsgType::PING, uint64_t{2})));
+    m_node.peerman->PrepareMessages(peer);
+    BOOST_REQUIRE(connman.ReceiveMsgFrom(peer, NetMsg::Make(NetMsgType::PING, uint64_t{3})));
+    {
+        LOCK(NetEventsInterface::g_msgproc_mutex);
+        for (const bool more_work : {true, true, false}) {
+            peer.fPauseSend = false;
+            BOOST_CHECK_EQUAL(connman.ProcessMessagesOnce(peer), more_work);
+        }
+    }
+    BOOST_CHECK(pongs == std::vector<uint64_t>({1, 2, 3}));
+
+    CaptureMessage = CaptureMessageOrig;
+    m_node.connman->SetCaptureMessages(false);
+    m_node.peerman->FinalizeNode(peer);
+}
+
 
 BOOST_AUTO_TEST_CASE(advertise_local_address)
 {
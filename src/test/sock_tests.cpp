@@ -12,6 +12,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include <cassert>
+#include <memory>
 #include <thread>
 
 using namespace std::chrono_literals;
@@ -155,6 +156,42 @@ BOOST_AUTO_TEST_CASE(wait)
     waiter.join();
 }
 
+BOOST_AUTO_TEST_CASE(poller)
+{
+    TcpSocketPair socks{};
+    const auto sender{std::make_shared<const Sock>(std::move(socks.sender))};
+    const auto receiver{std::make_shared<const Sock>(std::move(socks.receiver))};
+
+    SockPoller poller;
+    Sock::EventsPerSock events_per_sock;
+    events_per_sock.emplace(sender, Sock::Events{Sock::RecvEvent});
+    events_per_sock.emplace(receiver, Sock::Events{Sock::RecvEvent});
+
+    // Nothing has been sent yet.
+    BOOST_REQUIRE(poller.Wait(0ms, events_per_sock));
+    BOOST_CHECK_EQUAL(events_per_sock.at(sender).occurred, 0);
+    BOOST_CHECK_EQUAL(events_per_sock.at(receiver).occurred, 0);
+
+    BOOST_REQUIRE_EQUAL(sender->Send("a", 1, 0), 1);
+    BOOST_REQUIRE(poller.Wait(1min, events_per_sock));
+    BOOST_CHECK_EQUAL(events_per_sock.at(sender).occurred, 0);
+    BOOST_CHECK_EQUAL(events_per_sock.at(receiver).occurred, Sock::RecvEvent);
+
+    // A change of the requested events is picked up for a registered socket.
+    events_per_sock.at(sender).requested = Sock::SendEvent;
+    BOOST_REQUIRE(poller.Wait(1min, events_per_sock));
+    BOOST_CHECK_EQUAL(events_per_sock.at(sender).occurred, Sock::SendEvent);
+    BOOST_CHECK_EQUAL(events_per_sock.at(receiver).occurred, Sock::RecvEvent);
+
+    // Sockets that are not waited for anymore are dropped.
+    events_per_sock.erase(sender);
+    BOOST_REQUIRE(poller.Wait(1min, events_per_sock));
+    BOOST_CHECK_EQUAL(events_per_sock.at(receiver).occurred, Sock::RecvEvent);
+#ifdef USE_EPOLL
+    BOOST_CHECK_EQUAL(poller.RegisteredCount(), 1U);
+#endif
+}
+
 BOOST_AUTO_TEST_CASE(recv_until_terminator_limit)
 {
     constexpr auto timeout = 1min; // High enough so that it is never hit.
@@ -6,6 +6,7 @@
 #include <test/data/tx_valid.json.h>
 #include <test/util/setup_common.h>
 
+#include <addresstype.h>
 #include <checkqueue.h>
 #include <clientversion.h>
 #include <consensus/amount.h>
@@ -559,6 +560,43 @@ BOOST_AUTO_TEST_CASE(test_big_witness_transaction)
     assert(controlCheck);
 }
 
+BOOST_AUTO_TEST_CASE(sign_transaction_many_inputs)
+{
+    // Enough inputs that SignTransaction signs them in parallel, with one
+    // missing coin.  The result must be the same as signing one by one.
+    CKey key = GenerateRandomKey();
+    FillableSigningProvider keystore;
+    BOOST_CHECK(keystore.AddKeyPubKey(key, key.GetPubKey()));
+    const std::vector<CScript> scripts{GetScriptForDestination(PKHash(key.GetPubKey())), GetScriptForDestination(WitnessV0KeyHash(key.GetPubKey()))};
+
+    CMutableTransaction mtx;
+    std::map<COutPoint, Coin> coins;
+    constexpr uint32_t NUM_INPUTS{200};
+    constexpr uint32_t MISSING_INPUT{57};
+    for (uint32_t i = 0; i < NUM_INPUTS; ++i) {
+        const COutPoint outpoint{Txid{"0000000000000000000000000000000000000000000000000000000000000100"}, i};
+        mtx.vin.emplace_back(outpoint);
+        if (i != MISSING_INPUT) coins[outpoint] = Coin(CTxOut(1000, scripts[i % scripts.size()]), 1, false);
+    }
+    mtx.vout.emplace_back(1000, CScript() << OP_1);
+
+    CMutableTransaction expected{mtx};
+    for (uint32_t i = 0; i < NUM_INPUTS; ++i) {
+        if (i == MISSING_INPUT) continue;
+        SignatureData empty;
+        BOOST_CHECK(SignSignature(keystore, scripts[i % scripts.size()], expected, i, 1000, SIGHASH_ALL, empty));
+    }
+
+    std::map<int, bilingual_str> input_errors;
+    BOOST_CHECK(!SignTransaction(mtx, &keystore, coins, {.sighash_type = SIGHASH_ALL}, input_errors));
+    BOOST_CHECK_EQUAL(input_errors.size(), 1U);
+    BOOST_CHECK(input_errors.contains(MISSING_INPUT));
+    for (uint32_t i = 0; i < NUM_INPUTS; ++i) {
+        BOOST_CHECK(mtx.vin[i].scriptSig == expected.vin[i].scriptSig);
+        BOOST_CHECK(mtx.vin[i].scriptWitness.stack == expected.vin[i].scriptWitness.stack);
+    }
+}
+
 SignatureData CombineSignatures(const CMutableTransaction& input1, const CMutableTransaction& input2, const CTransactionRef tx)
 {
     SignatureData sigdata;
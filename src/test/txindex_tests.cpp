@@ -174,6 +174,26 @@ BOOST_FIXTURE_TEST_CASE(txindex_initial_sync, TestChain100Setup)
     txindex.Stop();
 }
 
+BOOST_FIXTURE_TEST_CASE(txindex_parallel_sync, TestChain100Setup)
+{
+    TxIndex txindex(interfaces::MakeChain(m_node), /*n_cache_size=*/1_MiB, /*f_memory=*/true);
+    BOOST_REQUIRE(txindex.Init());
+
+    // Blocks are read and prepared out of order, but appended in order.
+    txindex.SetSyncThreads(4);
+    txindex.Sync();
+
+    const IndexSummary summary{txindex.GetSummary()};
+    BOOST_CHECK(summary.synced);
+    BOOST_CHECK_EQUAL(summary.best_block_height, WITH_LOCK(cs_main, return m_node.chainman->ActiveHeight()));
+
+    for (const auto& txn : m_coinbase_txns) {
+        LookupTx(txindex, txn->GetHash());
+    }
+
+    txindex.Stop();
+}
+
 BOOST_FIXTURE_TEST_CASE(txindex_collision_scan_path, TestChain100Setup)
 {
     // On-disk, so the legacy-entry probe at construction runs against a fresh
@@ -2,6 +2,7 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <addresstype.h>
 #include <consensus/validation.h>
 #include <key.h>
 #include <random.h>
@@ -385,4 +386,47 @@ BOOST_FIXTURE_TEST_CASE(checkinputs_test, Dersig100Setup)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(mempool_parallel_script_checks, TestChain100Setup)
+{
+    // The inputs of this transaction are verified on the script check threads.
+    BOOST_REQUIRE(m_node.chainman->GetCheckQueue().HasThreads());
+
+    // Fund five inputs from a mature coinbase.
+    const CScript spk{GetScriptForDestination(WitnessV0KeyHash{coinbaseKey.GetPubKey()})};
+    const std::vector<CTxOut> funding_outputs(5, CTxOut{COIN, spk});
+    const auto [funding_mtx, _funding_fee]{CreateValidTransaction({m_coinbase_txns[0]}, {COutPoint{m_coinbase_txns[0]->GetHash(), 0}},
+                                                                  /*input_height=*/1, {coinbaseKey}, funding_outputs, {}, {})};
+    CreateAndProcessBlock({funding_mtx}, CScript() << OP_TRUE);
+    const CTransactionRef funding_tx{MakeTransactionRef(funding_mtx)};
+
+    std::vector<COutPoint> inputs;
+    for (uint32_t i = 0; i < funding_outputs.size(); ++i) {
+        inputs.emplace_back(funding_tx->GetHash(), i);
+    }
+    const auto [tx, _fee]{CreateValidTransaction({funding_tx}, inputs, /*input_height=*/101, {coinbaseKey},
+                                                 {CTxOut{4 * COIN, spk}}, {}, {})};
+
+    LOCK(cs_main);
+
+    // Changing the output after signing invalidates all signatures. The
+    // failure reported by the threads is the same as with a serial check.
+    CMutableTransaction invalid_tx{tx};
+    invalid_tx.vout[0].nValue -= 1;
+    const auto invalid_result{m_node.chainman->ProcessTransaction(MakeTransactionRef(invalid_tx))};
+    BOOST_CHECK(invalid_result.m_result_type == MempoolAcceptResult::ResultType::INVALID);
+    BOOST_CHECK(invalid_result.m_state.GetResult() == TxValidationResult::TX_NOT_STANDARD);
+    BOOST_CHECK_EQUAL(invalid_result.m_state.GetRejectReason(),
+                      "mempool-script-verify-flag-failed (Signature must be zero for failed CHECK(MULTI)SIG operation)");
+
+    // A failure without witnesses is still detected as a stripped witness.
+    CMutableTransaction stripped_tx{tx};
+    for (auto& txin : stripped_tx.vin) txin.scriptWitness.SetNull();
+    const auto stripped_result{m_node.chainman->ProcessTransaction(MakeTransactionRef(stripped_tx))};
+    BOOST_CHECK(stripped_result.m_result_type == MempoolAcceptResult::ResultType::INVALID);
+    BOOST_CHECK(stripped_result.m_state.GetResult() == TxValidationResult::TX_WITNESS_STRIPPED);
+
+    const auto result{m_node.chainman->ProcessTransaction(MakeTransactionRef(tx))};
+    BOOST_CHECK(result.m_result_type == MempoolAcceptResult::ResultType::VALID);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
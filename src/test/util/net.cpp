@@ -234,6 +234,14 @@ bool ZeroSock::WaitMany(std::chrono::milliseconds timeout, EventsPerSock& events
     return true;
 }
 
+bool ZeroSock::WaitManyPersistent(std::chrono::milliseconds timeout,
+                                  EventsPerSock& events_per_sock,
+                                  SockPoller&) const
+{
+    // The file descriptors are fake, do not register them with the kernel.
+    return WaitMany(timeout, events_per_sock);
+}
+
 ZeroSock& ZeroSock::operator=(Sock&& other)
 {
     assert(false && "Move of Sock into ZeroSock not allowed.");
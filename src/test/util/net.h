@@ -200,6 +200,10 @@ public:
 
     bool WaitMany(std::chrono::milliseconds timeout, EventsPerSock& events_per_sock) const override;
 
+    bool WaitManyPersistent(std::chrono::milliseconds timeout,
+                            EventsPerSock& events_per_sock,
+                            SockPoller& poller) const override;
+
 private:
     ZeroSock& operator=(Sock&& other) override;
 };
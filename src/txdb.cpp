@@ -66,8 +66,114 @@ struct CoinEntry {
 
 CCoinsViewDB::CCoinsViewDB(DBParams db_params, CoinsViewOptions options) :
     m_db_params{std::move(db_params)},
-    m_options{std::move(options)},
-    m_db{std::make_unique<CDBWrapper>(m_db_params)} { }
+    m_options{std::move(options)}
+{
+    OpenDatabases();
+    MigrateNameData();
+}
+
+fs::path CCoinsViewDB::NamesDBPath(const fs::path& coins_path)
+{
+    return coins_path / "names";
+}
+
+void CCoinsViewDB::OpenDatabases()
+{
+    const int names_percent{std::clamp(m_options.names_cache_percent, 1, 99)};
+    const size_t names_cache{m_db_params.cache_bytes * names_percent / 100};
+
+    DBParams coins_params{m_db_params};
+    coins_params.cache_bytes = m_db_params.cache_bytes - names_cache;
+    m_db = std::make_unique<CDBWrapper>(coins_params);
+
+    // Name lookups are mostly point reads of a small working set, while the
+    // writes per flush are small.  Give most of the cache to the block cache.
+    DBParams names_params{m_db_params};
+    names_params.path = NamesDBPath(m_db_params.path);
+    names_params.cache_bytes = names_cache;
+    names_params.write_buffer_bytes = names_cache / 8;
+    m_names_db = std::make_unique<CDBWrapper>(names_params);
+}
+
+void CCoinsViewDB::MigrateNameData()
+{
+    std::unique_ptr<CDBIterator> cursor{m_db->NewIterator()};
+    const auto has_prefix{[&cursor](uint8_t prefix) {
+        cursor->Seek(prefix);
+        uint8_t key;
+        return cursor->Valid() && cursor->GetKey(key) && key == prefix;
+    }};
+    // The name data used to be committed together with the final batch of
+    // a flush, so it matches the old tip if that flush was interrupted.
+    const auto old_names_tip{[this]() {
+        uint256 names_tip{GetBestBlock()};
+        if (const auto heads{GetHeadBlocks()}; names_tip.IsNull() && heads.size() == 2) {
+            names_tip = heads[1];
+        }
+        return names_tip;
+    }};
+
+    if (!has_prefix(DB_NAME) && !has_prefix(DB_NAME_HISTORY) && !has_prefix(DB_NAME_EXPIRY)) {
+        // A chainstate from an older version without any names has nothing
+        // to move, but the name database is consistent with it.
+        if (GetNamesBestBlock().IsNull()) {
+            if (const uint256 names_tip{old_names_tip()}; !names_tip.IsNull()) {
+                m_names_db->Write(DB_BEST_BLOCK, names_tip, /*fSync=*/true);
+            }
+        }
+        return;
+    }
+
+    LogInfo("Moving name database from the coin database to %s", fs::PathToString(NamesDBPath(m_db_params.path)));
+
+    CDBBatch names_batch(*m_names_db);
+    CDBBatch coins_batch(*m_db);
+    size_t count{0};
+    const auto maybe_flush{[&]() {
+        ++count;
+        if (names_batch.ApproximateSize() > m_options.batch_write_bytes) {
+            m_names_db->WriteBatch(names_batch);
+            names_batch.Clear();
+        }
+    }};
+
+    for (cursor->Seek(DB_NAME); cursor->Valid(); cursor->Next()) {
+        std::pair<uint8_t, valtype> key;
+        CNameData data;
+        if (!cursor->GetKey(key) || key.first != DB_NAME) break;
+        if (!cursor->GetValue(data)) throw dbwrapper_error("Failed to read name data during migration");
+        names_batch.Write(key, data);
+        coins_batch.Erase(key);
+        maybe_flush();
+    }
+    for (cursor->Seek(DB_NAME_HISTORY); cursor->Valid(); cursor->Next()) {
+        std::pair<uint8_t, valtype> key;
+        CNameHistory data;
+        if (!cursor->GetKey(key) || key.first != DB_NAME_HISTORY) break;
+        if (!cursor->GetValue(data)) throw dbwrapper_error("Failed to read name history during migration");
+        names_batch.Write(key, data);
+        coins_batch.Erase(key);
+        maybe_flush();
+    }
+    for (cursor->Seek(DB_NAME_EXPIRY); cursor->Valid(); cursor->Next()) {
+        std::pair<uint8_t, CNameCache::ExpireEntry> key;
+        if (!cursor->GetKey(key) || key.first != DB_NAME_EXPIRY) break;
+        names_batch.Write(key);
+        coins_batch.Erase(key);
+        maybe_flush();
+    }
+    cursor.reset();
+
+    if (const uint256 names_tip{old_names_tip()}; !names_tip.IsNull()) {
+        names_batch.Write(DB_BEST_BLOCK, names_tip);
+    }
+
+    // Only remove the data from the coin database once it is safely stored
+    // in the name database, so that an interrupted migration is redone.
+    m_names_db->WriteBatch(names_batch, /*fSync=*/true);
+    m_db->WriteBatch(coins_batch, /*fSync=*/true);
+    LogInfo("Moved %u name database entries", count);
+}
 
 CCoinsViewDB::~CCoinsViewDB()
 {
@@ -87,10 +193,11 @@ void CCoinsViewDB::ResizeCache(size_t new_cache_size)
         LOCK(m_db_mutex);
         // Have to do a reset first to get the original `m_db` state to release its
         // filesystem lock.
+        m_names_db.reset();
         m_db.reset();
         m_db_params.cache_bytes = new_cache_size;
         m_db_params.wipe_data = false;
-        m_db = std::make_unique<CDBWrapper>(m_db_params);
+        OpenDatabases();
     }
 }
 
@@ -128,13 +235,33 @@ std::vector<uint256> CCoinsViewDB::GetHeadBlocks() const {
     return vhashHeadBlocks;
 }
 
+uint256 CCoinsViewDB::GetNamesBestBlock() const {
+    uint256 hashBestChain;
+    if (!m_names_db->Read(DB_BEST_BLOCK, hashBestChain))
+        return uint256();
+    return hashBestChain;
+}
+
+bool CCoinsViewDB::NamesConsistent() const
+{
+    const uint256 names_tip{GetNamesBestBlock()};
+    const uint256 coins_tip{GetBestBlock()};
+    if (!coins_tip.IsNull()) return names_tip == coins_tip;
+
+    // While the coin database is in transition, the name database may be
+    // at either end, and the replay brings it to the new tip.
+    const auto heads{GetHeadBlocks()};
+    if (heads.size() == 2) return names_tip == heads[0] || names_tip == heads[1];
+    return names_tip.IsNull();
+}
+
 bool CCoinsViewDB::GetName(const valtype &name, CNameData& data) const {
-    return m_db->Read(std::make_pair(DB_NAME, name), data);
+    return m_names_db->Read(std::make_pair(DB_NAME, name), data);
 }
 
 bool CCoinsViewDB::GetNameHistory(const valtype &name, CNameHistory& data) const {
     assert (fNameHistory);
-    return m_db->Read(std::make_pair(DB_NAME_HISTORY, name), data);
+    return m_names_db->Read(std::make_pair(DB_NAME_HISTORY, name), data);
 }
 
 bool CCoinsViewDB::GetNamesForHeight(unsigned nHeight, std::set<valtype>& names) const {
@@ -143,7 +270,7 @@ bool CCoinsViewDB::GetNamesForHeight(unsigned nHeight, std::set<valtype>& names)
     /* It seems that there are no "const iterators" for LevelDB.  Since we
        only need read operations on it, use a const-cast to get around
        that restriction.  */
-    std::unique_ptr<CDBIterator> pcursor(const_cast<CDBWrapper*>(m_db.get())->NewIterator());
+    std::unique_ptr<CDBIterator> pcursor(const_cast<CDBWrapper*>(m_names_db.get())->NewIterator());
 
     const CNameCache::ExpireEntry seekEntry(nHeight, valtype ());
     pcursor->Seek(std::make_pair(DB_NAME_EXPIRY, seekEntry));
@@ -222,7 +349,7 @@ bool CDbNameIterator::next(valtype& name, CNameData& data) {
 }
 
 CNameIterator* CCoinsViewDB::IterateNames() const {
-    return new CDbNameIterator(*m_db);
+    return new CDbNameIterator(*m_names_db);
 }
 
 void CCoinsViewDB::BatchWrite(CoinsViewCacheCursor& cursor, const uint256& block_hash, const CNameCache& names)
@@ -232,6 +359,10 @@ void CCoinsViewDB::BatchWrite(CoinsViewCacheCursor& cursor, const uint256& block
     const size_t dirty_count{cursor.GetDirtyCount()};
     assert(!block_hash.IsNull());
 
+    // Set if the name database already reflects block_hash, which happens
+    // when the previous flush was interrupted after writing it.
+    bool names_done{false};
+
     uint256 old_tip = GetBestBlock();
     if (old_tip.IsNull()) {
         // We may be in the middle of replaying.
@@ -242,6 +373,7 @@ void CCoinsViewDB::BatchWrite(CoinsViewCacheCursor& cursor, const uint256& block
             }
             assert(old_heads[0] == block_hash);
             old_tip = old_heads[1];
+            names_done = GetNamesBestBlock() == block_hash;
         }
     }
 
@@ -249,12 +381,25 @@ void CCoinsViewDB::BatchWrite(CoinsViewCacheCursor& cursor, const uint256& block
     LOG_TIME_MILLIS_WITH_CATEGORY(strprintf("write coins cache to disk (%d out of %d cached coins)",
         dirty_count, cursor.GetTotalCount()), BCLog::BENCH);
 
-    // In the first batch, mark the database as being in the middle of a
-    // transition from old_tip to block_hash.
+    const auto maybe_simulate_crash{[this]() {
+        if (m_options.simulate_crash_ratio) {
+            static FastRandomContext rng;
+            if (rng.randrange(m_options.simulate_crash_ratio) == 0) {
+                LogError("Simulating a crash. Goodbye.");
+                _Exit(0);
+            }
+        }
+    }};
+
+    // First mark the database as being in the middle of a transition from
+    // old_tip to block_hash.  The marker is synced on its own, so that it is
+    // on disk before the name database can move to block_hash.
     // A vector is used for future extensibility, as we may want to support
     // interrupting after partial writes from multiple independent reorgs.
     batch.Erase(DB_BEST_BLOCK);
     batch.Write(DB_HEAD_BLOCKS, Vector(block_hash, old_tip));
+    m_db->WriteBatch(batch, /*fSync=*/true);
+    batch.Clear();
 
     for (auto it{cursor.Begin()}; it != cursor.End();) {
         if (it->second.IsDirty()) {
@@ -272,17 +417,21 @@ void CCoinsViewDB::BatchWrite(CoinsViewCacheCursor& cursor, const uint256& block
 
             m_db->WriteBatch(batch);
             batch.Clear();
-            if (m_options.simulate_crash_ratio) {
-                static FastRandomContext rng;
-                if (rng.randrange(m_options.simulate_crash_ratio) == 0) {
-                    LogError("Simulating a crash. Goodbye.");
-                    _Exit(0);
-                }
-            }
+            maybe_simulate_crash();
         }
     }
 
-    names.writeBatch(batch);
+    // The name database is committed and synced before the final coins
+    // batch, so it is never behind a consistent coin database, and only
+    // ahead of it while the transition marker is on disk.
+    if (!names_done) {
+        CDBBatch names_batch(*m_names_db);
+        names.writeBatch(names_batch);
+        names_batch.Write(DB_BEST_BLOCK, block_hash);
+        LogDebug(BCLog::COINDB, "Writing name batch of %.2f MiB\n", names_batch.ApproximateSize() / double(1_MiB));
+        m_names_db->WriteBatch(names_batch, /*fSync=*/true);
+        maybe_simulate_crash();
+    }
 
     // In the last batch, mark the database as consistent with block_hash again.
     batch.Erase(DB_HEAD_BLOCKS);
@@ -314,6 +463,7 @@ std::shared_future<void> CCoinsViewDB::CompactFullAsync()
 
             LogDebug(BCLog::COINDB, "Starting chainstate compaction of %s", fs::PathToString(m_db_params.path));
             m_db->CompactFull();
+            m_names_db->CompactFull();
             LogDebug(BCLog::COINDB, "Finished chainstate compaction of %s", fs::PathToString(m_db_params.path));
         } catch (const std::exception& e) {
             LogWarning("Failed chainstate compaction (%s)", e.what());
@@ -404,13 +554,13 @@ bool CCoinsViewDB::ValidateNameDB(const Chainstate& chainState, const std::funct
     else
         nHeight = chainState.m_blockman.m_block_index.find(blockHash)->second.nHeight;
 
-    /* It seems that there are no "const iterators" for LevelDB.  Since we
-       only need read operations on it, use a const-cast to get around
-       that restriction.  */
-    std::unique_ptr<CDBIterator> pcursor(const_cast<CDBWrapper*>(m_db.get())->NewIterator());
-    pcursor->SeekToFirst();
+    if (GetNamesBestBlock() != blockHash) {
+        LogError ("%s : name database is not at the UTXO set's best block",
+                  __func__);
+        return false;
+    }
 
-    /* Loop over the total database and read interesting
+    /* Loop over both databases and read interesting
        things to memory.  We later use that to check
        everything against each other.  */
 
@@ -420,110 +570,116 @@ bool CCoinsViewDB::ValidateNameDB(const Chainstate& chainState, const std::funct
     std::set<valtype> namesInUTXO;
     std::set<valtype> namesWithHistory;
 
-    for (; pcursor->Valid(); pcursor->Next())
+    for (CDBWrapper* db : {m_db.get(), m_names_db.get()})
     {
-        interruption_point();
-        uint8_t chType;
-        if (!pcursor->GetKey(chType))
-            continue;
+        std::unique_ptr<CDBIterator> pcursor(db->NewIterator());
+        pcursor->SeekToFirst();
 
-        switch (chType)
+        for (; pcursor->Valid(); pcursor->Next())
         {
-        case DB_COIN:
-        {
-            Coin coin;
-            if (!pcursor->GetValue(coin)) {
-                LogError ("%s : failed to read coin", __func__);
-                return false;
-            }
+            interruption_point();
+            uint8_t chType;
+            if (!pcursor->GetKey(chType))
+                continue;
 
-            if (!coin.out.IsNull())
+            switch (chType)
             {
-                const CNameScript nameOp(coin.out.scriptPubKey);
-                if (nameOp.isNameOp() && nameOp.isAnyUpdate())
+            case DB_COIN:
+            {
+                Coin coin;
+                if (!pcursor->GetValue(coin)) {
+                    LogError ("%s : failed to read coin", __func__);
+                    return false;
+                }
+
+                if (!coin.out.IsNull())
                 {
-                    const valtype& name = nameOp.getOpName();
-                    if (namesInUTXO.count(name) > 0) {
-                        LogError ("%s : name %s duplicated in UTXO set",
-                                  __func__, EncodeNameForMessage(name));
-                        return false;
+                    const CNameScript nameOp(coin.out.scriptPubKey);
+                    if (nameOp.isNameOp() && nameOp.isAnyUpdate())
+                    {
+                        const valtype& name = nameOp.getOpName();
+                        if (namesInUTXO.count(name) > 0) {
+                            LogError ("%s : name %s duplicated in UTXO set",
+                                      __func__, EncodeNameForMessage(name));
+                            return false;
+                        }
+                        namesInUTXO.insert(nameOp.getOpName());
                     }
-                    namesInUTXO.insert(nameOp.getOpName());
                 }
+                break;
             }
-            break;
-        }
 
-        case DB_NAME:
-        {
-            std::pair<uint8_t, valtype> key;
-            if (!pcursor->GetKey(key) || key.first != DB_NAME) {
-                LogError ("%s : failed to read DB_NAME key", __func__);
-                return false;
-            }
-            const valtype& name = key.second;
+            case DB_NAME:
+            {
+                std::pair<uint8_t, valtype> key;
+                if (!pcursor->GetKey(key) || key.first != DB_NAME) {
+                    LogError ("%s : failed to read DB_NAME key", __func__);
+                    return false;
+                }
+                const valtype& name = key.second;
 
-            CNameData data;
-            if (!pcursor->GetValue(data)) {
-                LogError ("%s : failed to read name value", __func__);
-                return false;
-            }
+                CNameData data;
+                if (!pcursor->GetValue(data)) {
+                    LogError ("%s : failed to read name value", __func__);
+                    return false;
+                }
 
-            if (nameHeightsData.count(name) > 0) {
-                LogError ("%s : name %s duplicated in name index",
-                          __func__, EncodeNameForMessage(name));
-                return false;
+                if (nameHeightsData.count(name) > 0) {
+                    LogError ("%s : name %s duplicated in name index",
+                              __func__, EncodeNameForMessage(name));
+                    return false;
+                }
+                nameHeightsData.insert(std::make_pair(name, data.getHeight()));
+                
+                /* Expiration is checked at height+1, because that matches
+                   how the UTXO set is cleared in ExpireNames.  */
+                assert(namesInDB.count(name) == 0);
+                if (!data.isExpired(nHeight + 1))
+                    namesInDB.insert(name);
+                break;
             }
-            nameHeightsData.insert(std::make_pair(name, data.getHeight()));
-            
-            /* Expiration is checked at height+1, because that matches
-               how the UTXO set is cleared in ExpireNames.  */
-            assert(namesInDB.count(name) == 0);
-            if (!data.isExpired(nHeight + 1))
-                namesInDB.insert(name);
-            break;
-        }
 
-        case DB_NAME_HISTORY:
-        {
-            std::pair<uint8_t, valtype> key;
-            if (!pcursor->GetKey(key) || key.first != DB_NAME_HISTORY) {
-                LogError ("%s : failed to read DB_NAME_HISTORY key", __func__);
-                return false;
-            }
-            const valtype& name = key.second;
+            case DB_NAME_HISTORY:
+            {
+                std::pair<uint8_t, valtype> key;
+                if (!pcursor->GetKey(key) || key.first != DB_NAME_HISTORY) {
+                    LogError ("%s : failed to read DB_NAME_HISTORY key", __func__);
+                    return false;
+                }
+                const valtype& name = key.second;
 
-            if (namesWithHistory.count(name) > 0) {
-                LogError ("%s : name %s has duplicate history",
-                          __func__, EncodeNameForMessage(name));
-                return false;
+                if (namesWithHistory.count(name) > 0) {
+                    LogError ("%s : name %s has duplicate history",
+                              __func__, EncodeNameForMessage(name));
+                    return false;
+                }
+                namesWithHistory.insert(name);
+                break;
             }
-            namesWithHistory.insert(name);
-            break;
-        }
 
-        case DB_NAME_EXPIRY:
-        {
-            std::pair<uint8_t, CNameCache::ExpireEntry> key;
-            if (!pcursor->GetKey(key) || key.first != DB_NAME_EXPIRY) {
-                LogError ("%s : failed to read DB_NAME_EXPIRY key", __func__);
-                return false;
-            }
-            const CNameCache::ExpireEntry& entry = key.second;
-            const valtype& name = entry.name;
+            case DB_NAME_EXPIRY:
+            {
+                std::pair<uint8_t, CNameCache::ExpireEntry> key;
+                if (!pcursor->GetKey(key) || key.first != DB_NAME_EXPIRY) {
+                    LogError ("%s : failed to read DB_NAME_EXPIRY key", __func__);
+                    return false;
+                }
+                const CNameCache::ExpireEntry& entry = key.second;
+                const valtype& name = entry.name;
 
-            if (nameHeightsIndex.count(name) > 0) {
-                LogError ("%s : name %s duplicated in expire idnex",
-                          __func__, EncodeNameForMessage(name));
-                return false;
-            }
+                if (nameHeightsIndex.count(name) > 0) {
+                    LogError ("%s : name %s duplicated in expire idnex",
+                              __func__, EncodeNameForMessage(name));
+                    return false;
+                }
 
-            nameHeightsIndex.insert(std::make_pair(name, entry.nHeight));
-            break;
-        }
+                nameHeightsIndex.insert(std::make_pair(name, entry.nHeight));
+                break;
+            }
 
-        default:
-            break;
+            default:
+                break;
+            }
         }
     }
 
@@ -573,26 +729,28 @@ bool CCoinsViewDB::ValidateNameDB(const Chainstate& chainState, const std::funct
 void
 CNameCache::writeBatch (CDBBatch& batch) const
 {
-  for (EntryMap::const_iterator i = entries.begin ();
-       i != entries.end (); ++i)
-    batch.Write (std::make_pair (DB_NAME, i->first), i->second);
+  /* The names are serialised in the same way as valtype, so they can be
+     used directly as keys here.  */
+  for (const auto& [name, data] : entries)
+    batch.Write (std::make_pair (DB_NAME, name), data);
 
-  for (std::set<valtype>::const_iterator i = deleted.begin ();
-       i != deleted.end (); ++i)
-    batch.Erase (std::make_pair (DB_NAME, *i));
+  for (const auto& name : deleted)
+    batch.Erase (std::make_pair (DB_NAME, name));
 
   assert (fNameHistory || history.empty ());
-  for (std::map<valtype, CNameHistory>::const_iterator i = history.begin ();
-       i != history.end (); ++i)
-    if (i->second.empty ())
-      batch.Erase (std::make_pair (DB_NAME_HISTORY, i->first));
-    else
-      batch.Write (std::make_pair (DB_NAME_HISTORY, i->first), i->second);
-
-  for (std::map<ExpireEntry, bool>::const_iterator i = expireIndex.begin ();
-       i != expireIndex.end (); ++i)
-    if (i->second)
-      batch.Write (std::make_pair (DB_NAME_EXPIRY, i->first));
+  for (const auto& [name, data] : history)
+    if (data.empty ())
+      batch.Erase (std::make_pair (DB_NAME_HISTORY, name));
     else
-      batch.Erase (std::make_pair (DB_NAME_EXPIRY, i->first));
+      batch.Write (std::make_pair (DB_NAME_HISTORY, name), data);
+
+  for (const auto& [height, changes] : expireIndex)
+    for (const auto& [name, add] : changes)
+      {
+        const ExpireEntry entry(height, valtype (name.begin (), name.end ()));
+        if (add)
+          batch.Write (std::make_pair (DB_NAME_EXPIRY, entry));
+        else
+          batch.Erase (std::make_pair (DB_NAME_EXPIRY, entry));
+      }
 }
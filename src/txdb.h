@@ -24,15 +24,29 @@
 class COutPoint;
 class uint256;
 
+//! Default share (in percent) of the chainstate LevelDB cache given to the name database.
+static constexpr int DEFAULT_NAMES_DB_CACHE_PERCENT{25};
+
 //! User-controlled performance and debug options.
 struct CoinsViewOptions {
     //! Maximum database write batch size in bytes.
     uint64_t batch_write_bytes{DEFAULT_DB_CACHE_BATCH};
+    //! Share (in percent) of the LevelDB cache that goes to the name database.
+    int names_cache_percent{DEFAULT_NAMES_DB_CACHE_PERCENT};
     //! If non-zero, randomly exit when the database is flushed with (1/ratio) probability.
     int simulate_crash_ratio{0};
 };
 
-/** CCoinsView backed by the coin database (chainstate/) */
+/**
+ * CCoinsView backed by the coin database (chainstate/).
+ *
+ * The name database (names, their history and the expire index) is kept
+ * in a separate LevelDB instance in the "names" subdirectory, so that it
+ * can be tuned independently of the much larger UTXO set.  Both databases
+ * record the block hash they are consistent with; the name database is
+ * always written before the final batch of the coin database, so that
+ * an interrupted flush can be detected and completed by ReplayBlocks.
+ */
 class CCoinsViewDB final : public CCoinsView
 {
 protected:
@@ -41,7 +55,14 @@ protected:
     //! Prevents CompactFull() from using m_db while ResizeCache() replaces it.
     Mutex m_db_mutex;
     std::unique_ptr<CDBWrapper> m_db;
+    std::unique_ptr<CDBWrapper> m_names_db;
     std::shared_future<void> m_compaction;
+
+    //! Open both LevelDB instances, splitting the cache between them.
+    void OpenDatabases();
+    //! Move name data left in the coin database by older versions.
+    void MigrateNameData();
+
 public:
     explicit CCoinsViewDB(DBParams db_params, CoinsViewOptions options);
     ~CCoinsViewDB() override;
@@ -51,6 +72,10 @@ public:
     bool HaveCoin(const COutPoint& outpoint) const override;
     uint256 GetBestBlock() const override;
     std::vector<uint256> GetHeadBlocks() const override;
+    //! Retrieve the block hash the name database is consistent with.
+    uint256 GetNamesBestBlock() const;
+    //! Whether the name database matches the state of the coin database.
+    bool NamesConsistent() const;
     bool GetName(const valtype &name, CNameData &data) const override;
     bool GetNameHistory(const valtype &name, CNameHistory &data) const override;
     bool GetNamesForHeight(unsigned nHeight, std::set<valtype>& data) const override;
@@ -72,6 +97,9 @@ public:
 
     //! Return an underlying LevelDB property value, if available.
     std::optional<std::string> GetDBProperty(const std::string& property);
+
+    //! Return the location of the name database for a coin database path.
+    static fs::path NamesDBPath(const fs::path& coins_path);
 };
 
 #endif // BITCOIN_TXDB_H
@@ -11,8 +11,15 @@
 #include <consensus/consensus.h>
 #include <names/main.h>
 #include <primitives/transaction.h>
+#include <script/names.h>
 #include <serialize.h>
 
+#include <cstdint>
+#include <ios>
+#include <map>
+#include <utility>
+#include <vector>
+
 /** Formatter for undo information for a CTxIn
  *
  *  Contains the prevout's CTxOut being spent, and its metadata as well
@@ -50,6 +57,29 @@ struct TxInUndoFormatter
     }
 };
 
+/** Formatter for undo information for a CTxIn in the compact block undo
+ *  format.  This is the same as TxInUndoFormatter, but without the dummy
+ *  version.
+ */
+struct TxInUndoCompactFormatter
+{
+    template<typename Stream>
+    void Ser(Stream &s, const Coin& txout) {
+        uint32_t nCode{(uint32_t{txout.nHeight} << 1) | uint32_t{txout.fCoinBase}};
+        ::Serialize(s, VARINT(nCode));
+        ::Serialize(s, Using<TxOutCompression>(txout.out));
+    }
+
+    template<typename Stream>
+    void Unser(Stream &s, Coin& txout) {
+        uint32_t nCode = 0;
+        ::Unserialize(s, VARINT(nCode));
+        txout.nHeight = nCode >> 1;
+        txout.fCoinBase = nCode & 1;
+        ::Unserialize(s, Using<TxOutCompression>(txout.out));
+    }
+};
+
 /** Undo information for a CTransaction */
 class CTxUndo
 {
@@ -60,7 +90,27 @@ public:
     SERIALIZE_METHODS(CTxUndo, obj) { READWRITE(Using<VectorFormatter<TxInUndoFormatter>>(obj.vprevout)); }
 };
 
-/** Undo information for a CBlock */
+/** Formatter for a CTxUndo in the compact block undo format. */
+struct TxUndoCompactFormatter
+{
+    template<typename Stream>
+    void Ser(Stream &s, const CTxUndo& txundo) { ::Serialize(s, Using<VectorFormatter<TxInUndoCompactFormatter>>(txundo.vprevout)); }
+
+    template<typename Stream>
+    void Unser(Stream &s, CTxUndo& txundo) { ::Unserialize(s, Using<VectorFormatter<TxInUndoCompactFormatter>>(txundo.vprevout)); }
+};
+
+/** Undo information for a CBlock
+ *
+ *  This is written in a compact format, which is marked by a leading
+ *  COMPACT_FORMAT_MARKER, and differs from the legacy format in that:
+ *   - The spent coins do not include the dummy version.
+ *   - Name undo entries restoring the state of a name coin spent in the
+ *     block refer to that coin in vtxundo (whose script already contains
+ *     the name, value and address) instead of repeating the data.
+ *  The legacy format (starting directly with the size of vtxundo) can still
+ *  be read.
+ */
 class CBlockUndo
 {
 public:
@@ -71,12 +121,133 @@ public:
     /** Undo information for expired name coins.  */
     std::vector<Coin> vexpired;
 
-    SERIALIZE_METHODS(CBlockUndo, obj) {
-        READWRITE(obj.vtxundo);
-        READWRITE(obj.vnameundo);
-        READWRITE(obj.vexpired);
+    /** Leading compact size of the compact format.  It is larger than
+     *  MAX_SIZE, so that it can not be confused with the size of vtxundo in
+     *  the legacy format, and older software fails to read the data instead
+     *  of misinterpreting it. */
+    static constexpr uint64_t COMPACT_FORMAT_MARKER{0xffffffff};
+
+    /** Encoding of a name undo entry in the compact format. */
+    enum NameUndoType : uint8_t {
+        /** The CNameTxUndo serialized as is. */
+        NAME_UNDO_FULL = 0,
+        /** Old data from a name coin in vtxundo, followed by the tx and input
+         *  index of that coin and the old update outpoint. */
+        NAME_UNDO_SPENT_COIN = 1,
+    };
+
+    template<typename Stream>
+    void Serialize(Stream &s) const {
+        WriteCompactSize(s, COMPACT_FORMAT_MARKER);
+        ::Serialize(s, Using<VectorFormatter<TxUndoCompactFormatter>>(vtxundo));
+
+        // Name coins spent in the block, by name.  A name can be updated
+        // more than once per block, so there may be several coins.
+        std::map<valtype, std::vector<std::pair<uint32_t, uint32_t>>> name_coins;
+        for (uint32_t i = 0; i < vtxundo.size(); ++i) {
+            for (uint32_t j = 0; j < vtxundo[i].vprevout.size(); ++j) {
+                const CNameScript op(vtxundo[i].vprevout[j].out.scriptPubKey);
+                if (op.isNameOp() && op.isAnyUpdate()) {
+                    name_coins[op.getOpName()].emplace_back(i, j);
+                }
+            }
+        }
+
+        WriteCompactSize(s, vnameundo.size());
+        for (const CNameTxUndo& entry : vnameundo) {
+            const auto* coin_ref{FindSpentNameCoin(entry, name_coins)};
+            if (coin_ref == nullptr) {
+                ::Serialize(s, uint8_t{NAME_UNDO_FULL});
+                ::Serialize(s, entry);
+                continue;
+            }
+            ::Serialize(s, uint8_t{NAME_UNDO_SPENT_COIN});
+            ::Serialize(s, VARINT(coin_ref->first));
+            ::Serialize(s, VARINT(coin_ref->second));
+            ::Serialize(s, entry.getOldData().getUpdateOutpoint());
+        }
+
+        ::Serialize(s, vexpired);
     }
 
+    template<typename Stream>
+    void Unserialize(Stream &s) {
+        const uint64_t size{ReadCompactSize(s, /*range_check=*/false)};
+        if (size != COMPACT_FORMAT_MARKER) {
+            UnserializeLegacy(s, size);
+            return;
+        }
+
+        ::Unserialize(s, Using<VectorFormatter<TxUndoCompactFormatter>>(vtxundo));
+
+        const uint64_t num_names{ReadCompactSize(s)};
+        vnameundo.clear();
+        while (vnameundo.size() < num_names) {
+            uint8_t type;
+            ::Unserialize(s, type);
+            switch (type) {
+            case NAME_UNDO_FULL:
+                ::Unserialize(s, vnameundo.emplace_back());
+                break;
+            case NAME_UNDO_SPENT_COIN: {
+                uint32_t i{0}, j{0};
+                COutPoint prevout;
+                ::Unserialize(s, VARINT(i));
+                ::Unserialize(s, VARINT(j));
+                ::Unserialize(s, prevout);
+                if (i >= vtxundo.size() || j >= vtxundo[i].vprevout.size()) {
+                    throw std::ios_base::failure("Invalid name undo coin reference");
+                }
+                const Coin& coin{vtxundo[i].vprevout[j]};
+                const CNameScript op(coin.out.scriptPubKey);
+                if (!op.isNameOp() || !op.isAnyUpdate()) {
+                    throw std::ios_base::failure("Name undo refers to non-name coin");
+                }
+                CNameData data;
+                data.fromScript(coin.nHeight, prevout, op);
+                vnameundo.emplace_back(op.getOpName(), &data);
+                break;
+            }
+            default:
+                throw std::ios_base::failure("Unknown name undo type");
+            }
+        }
+
+        ::Unserialize(s, vexpired);
+    }
+
+private:
+    /** Find a name coin from vtxundo, which encodes exactly the old data
+     *  restored by the given name undo entry. */
+    const std::pair<uint32_t, uint32_t>* FindSpentNameCoin(
+        const CNameTxUndo& entry,
+        const std::map<valtype, std::vector<std::pair<uint32_t, uint32_t>>>& name_coins) const
+    {
+        if (entry.isNewName()) return nullptr;
+        const auto mit{name_coins.find(entry.getName())};
+        if (mit == name_coins.end()) return nullptr;
+        const CNameData& old_data{entry.getOldData()};
+        for (const auto& ref : mit->second) {
+            const Coin& coin{vtxundo[ref.first].vprevout[ref.second]};
+            CNameData data;
+            data.fromScript(coin.nHeight, old_data.getUpdateOutpoint(), CNameScript(coin.out.scriptPubKey));
+            if (data == old_data) return &ref;
+        }
+        return nullptr;
+    }
+
+    template<typename Stream>
+    void UnserializeLegacy(Stream &s, uint64_t num_txundo) {
+        if (num_txundo > MAX_SIZE) {
+            throw std::ios_base::failure("ReadCompactSize(): size too large");
+        }
+        vtxundo.clear();
+        while (vtxundo.size() < num_txundo) {
+            ::Unserialize(s, vtxundo.emplace_back());
+        }
+        ::Unserialize(s, vnameundo);
+        ::Unserialize(s, vexpired);
+    }
 };
 
 #endif // BITCOIN_UNDO_H
@@ -98,6 +98,9 @@ public:
 
     std::string write(unsigned int prettyIndent = 0,
                       unsigned int indentLevel = 0) const;
+    /** Like write(), but appends the JSON to the given string.  */
+    void write(std::string& out, unsigned int prettyIndent = 0,
+               unsigned int indentLevel = 0) const;
 
     bool read(std::string_view raw);
 
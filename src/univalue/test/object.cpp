@@ -411,6 +411,15 @@ void univalue_readwrite()
 
     BOOST_CHECK_EQUAL(strJson1, v.write());
 
+    // Writing into a string appends to what is already there.
+    std::string appended{"prefix"};
+    v.write(appended);
+    BOOST_CHECK_EQUAL(appended, "prefix" + strJson1);
+    appended.clear();
+    v.write(appended, 2);
+    BOOST_CHECK_EQUAL(appended, v.write(2));
+    BOOST_CHECK_EQUAL(UniValue{"a\"b\\c\n"}.write(), "\"a\\\"b\\\\c\\n\"");
+
     // Valid
     BOOST_CHECK(v.read("1.0") && (v.get_real() == 1.0));
     BOOST_CHECK(v.read("true") && v.get_bool());
@@ -26,6 +26,11 @@
 #include <poll.h>
 #endif
 
+#ifdef USE_EPOLL
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
 Sock::Sock(SOCKET s) : m_socket(s) {}
 
 Sock::Sock(Sock&& other)
@@ -246,6 +251,141 @@ bool Sock::WaitMany(std::chrono::milliseconds timeout, EventsPerSock& events_per
 #endif /* USE_POLL */
 }
 
+bool Sock::WaitManyPersistent(std::chrono::milliseconds timeout,
+                              EventsPerSock& events_per_sock,
+                              SockPoller& poller) const
+{
+    return poller.Wait(timeout, events_per_sock);
+}
+
+#ifdef USE_EPOLL
+SockPoller::SockPoller() : m_epoll_fd{epoll_create1(EPOLL_CLOEXEC)}
+{
+    if (m_epoll_fd == -1) {
+        LogWarning("Cannot create epoll instance, falling back to waiting on all sockets: %s",
+                   SysErrorString(errno));
+    }
+}
+
+SockPoller::~SockPoller()
+{
+    if (m_epoll_fd != -1) {
+        close(m_epoll_fd);
+    }
+}
+#else
+SockPoller::SockPoller() = default;
+SockPoller::~SockPoller() = default;
+#endif /* USE_EPOLL */
+
+bool SockPoller::Wait(std::chrono::milliseconds timeout, Sock::EventsPerSock& events_per_sock)
+{
+#ifdef USE_EPOLL
+    if (m_epoll_fd != -1) {
+        ++m_generation;
+
+        bool registered{true};
+        for (auto& [sock, events] : events_per_sock) {
+            events.occurred = 0;
+
+            uint32_t wanted{0};
+            if (events.requested & Sock::RecvEvent) {
+                wanted |= EPOLLIN;
+            }
+            if (events.requested & Sock::SendEvent) {
+                wanted |= EPOLLOUT;
+            }
+
+            const SOCKET fd{sock->m_socket};
+            const auto [it, inserted]{m_registered.try_emplace(fd)};
+            Registration& reg{it->second};
+
+            int op{EPOLL_CTL_ADD};
+            if (!inserted) {
+                const bool same_sock{!reg.sock.owner_before(sock) && !sock.owner_before(reg.sock)};
+                if (!same_sock) {
+                    // The registered socket has been closed and a new one got the same
+                    // file descriptor. Closing it already removed it from the epoll set,
+                    // unless the file descriptor had been duplicated.
+                    (void)epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+                } else if (reg.events == wanted) {
+                    op = 0; // Already registered as requested.
+                } else {
+                    op = EPOLL_CTL_MOD;
+                }
+            }
+
+            if (op != 0) {
+                epoll_event ev{};
+                ev.events = wanted;
+                ev.data.fd = fd;
+                if (epoll_ctl(m_epoll_fd, op, fd, &ev) != 0) {
+                    (void)epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+                    m_registered.erase(it);
+                    registered = false;
+                    break;
+                }
+                reg.sock = sock;
+                reg.events = wanted;
+            }
+            reg.generation = m_generation;
+            reg.current = &events;
+        }
+
+        if (registered) {
+            // Unregister the sockets that are not waited for anymore. This fails
+            // harmlessly for the ones that have been closed in the meantime.
+            for (auto it{m_registered.begin()}; it != m_registered.end();) {
+                if (it->second.generation != m_generation) {
+                    (void)epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, it->first, nullptr);
+                    it = m_registered.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+
+            m_ready.resize(std::max<size_t>(m_registered.size(), 1));
+            const int num_ready{epoll_wait(m_epoll_fd, m_ready.data(), m_ready.size(), count_milliseconds(timeout))};
+            if (num_ready == SOCKET_ERROR) {
+                return false;
+            }
+
+            for (int i = 0; i < num_ready; ++i) {
+                const auto it{m_registered.find(m_ready[i].data.fd)};
+                assert(it != m_registered.end());
+                Sock::Events& events{*it->second.current};
+                if (m_ready[i].events & EPOLLIN) {
+                    events.occurred |= Sock::RecvEvent;
+                }
+                if (m_ready[i].events & EPOLLOUT) {
+                    events.occurred |= Sock::SendEvent;
+                }
+                if (m_ready[i].events & (EPOLLERR | EPOLLHUP)) {
+                    events.occurred |= Sock::ErrorEvent;
+                }
+            }
+
+            return true;
+        }
+    }
+#endif /* USE_EPOLL */
+
+    if (events_per_sock.empty()) {
+        return false;
+    }
+    // WaitMany() may as well be a static method, the context of the first Sock in the map is not relevant.
+    return events_per_sock.begin()->first->WaitMany(timeout, events_per_sock);
+}
+
+size_t SockPoller::RegisteredCount() const
+{
+#ifdef USE_EPOLL
+    return m_registered.size();
+#else
+    return 0;
+#endif
+}
+
 void Sock::SendComplete(std::span<const unsigned char> data,
                         std::chrono::milliseconds timeout,
                         CThreadInterrupt& interrupt) const
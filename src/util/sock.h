@@ -14,8 +14,13 @@
 #include <span>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 class CThreadInterrupt;
+class SockPoller;
+#ifdef USE_EPOLL
+struct epoll_event;
+#endif
 
 /**
  * Maximum time to wait for I/O readiness.
@@ -226,6 +231,21 @@ public:
     [[nodiscard]] virtual bool WaitMany(std::chrono::milliseconds timeout,
                                         EventsPerSock& events_per_sock) const;
 
+    /**
+     * Same as `WaitMany()`, but keep the sockets registered with `poller` between calls,
+     * see `SockPoller`. Mocked sockets override this to use their `WaitMany()`, since their
+     * file descriptors are not real and must not be handed to the kernel.
+     * @param[in] timeout Wait this long for at least one of the requested events to occur.
+     * @param[in,out] events_per_sock Wait for the requested events on these sockets and set
+     * `occurred` for the events that actually occurred.
+     * @param[in,out] poller Registrations kept from previous calls.
+     * @return true on success (or timeout, if all `what[].occurred` are returned as 0),
+     * false otherwise
+     */
+    [[nodiscard]] virtual bool WaitManyPersistent(std::chrono::milliseconds timeout,
+                                                  EventsPerSock& events_per_sock,
+                                                  SockPoller& poller) const;
+
     /* Higher level, convenience, methods. These may throw. */
 
     /**
@@ -283,12 +303,78 @@ protected:
     SOCKET m_socket;
 
 private:
+    friend class SockPoller;
+
     /**
      * Close `m_socket` if it is not `INVALID_SOCKET`.
      */
     void Close();
 };
 
+/**
+ * Waits for events on a set of sockets that changes little from one wait to the next,
+ * like the connections of `CConnman`.
+ *
+ * With epoll(7) the sockets are registered with the kernel once and only updated when
+ * the requested events change, so that the cost of a wait in the kernel is proportional
+ * to the number of ready sockets instead of the number of sockets. Otherwise, or if a
+ * socket can not be registered, this falls back to `Sock::WaitMany()`.
+ *
+ * This only changes the kernel side of the wait. The caller still passes the full set of
+ * sockets to every `Wait()`, which walks it to find the registrations to add, update or
+ * remove, so the work in user space stays proportional to the number of sockets.
+ *
+ * Not thread-safe, each instance is meant to be used by a single event loop.
+ */
+class SockPoller
+{
+public:
+    SockPoller();
+    ~SockPoller();
+
+    SockPoller(const SockPoller&) = delete;
+    SockPoller& operator=(const SockPoller&) = delete;
+
+    /**
+     * Wait for the requested events, like `Sock::WaitMany()`. Sockets that were waited
+     * for in a previous call but are not part of `events_per_sock` are unregistered.
+     * The `shared_ptr`s in `events_per_sock` must own their sockets, as the ownership
+     * is what tells apart different sockets that reuse the same file descriptor.
+     * @return false on error, or if `events_per_sock` is empty and there is nothing to
+     * wait with
+     */
+    [[nodiscard]] bool Wait(std::chrono::milliseconds timeout, Sock::EventsPerSock& events_per_sock);
+
+    /** Number of sockets currently registered with the kernel. */
+    size_t RegisteredCount() const;
+
+private:
+#ifdef USE_EPOLL
+    struct Registration {
+        /**
+         * The socket the file descriptor was registered for. A file descriptor
+         * number may be reused once its socket is closed, which is detected by
+         * comparing ownership with the socket passed to `Wait()`.
+         */
+        std::weak_ptr<const Sock> sock;
+        /** The epoll(7) events it was registered with. */
+        uint32_t events{0};
+        /** Value of `m_generation` in the last `Wait()` it was part of. */
+        uint64_t generation{0};
+        /** Its entry in the `events_per_sock` of the current `Wait()`. */
+        Sock::Events* current{nullptr};
+    };
+
+    /** File descriptor of the epoll instance, or -1 if it could not be created. */
+    int m_epoll_fd{-1};
+    /** Counter of `Wait()` calls, used to find registrations that went away. */
+    uint64_t m_generation{0};
+    std::unordered_map<SOCKET, Registration> m_registered;
+    /** Buffer for the ready sockets reported by the kernel, kept to avoid reallocations. */
+    std::vector<epoll_event> m_ready;
+#endif
+};
+
 /** Return readable error string for a network error code */
 std::string NetworkErrorString(int err);
 
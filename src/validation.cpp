@@ -116,6 +116,9 @@ const std::vector<std::string> CHECKLEVEL_DOC {
  *  noticeably interfere with the pruning mechanism.
  * */
 static constexpr int PRUNE_LOCK_BUFFER{10};
+/** Transactions with at least this many inputs have their scripts verified on
+ *  the script check threads when they are accepted to the mempool. */
+static constexpr size_t MIN_INPUTS_FOR_PARALLEL_MEMPOOL_SCRIPT_CHECKS{4};
 
 // Return whether the completed full flush should compact chainstate
 static bool ShouldCompactChainstate(bool in_ibd)
@@ -489,11 +492,15 @@ public:
          * Any individual transaction failing this check causes immediate failure.
          */
         const std::optional<CFeeRate> m_client_maxfeerate;
+        /** When true, the script checks are skipped because the transaction is known to have
+         * passed them against the current chain tip, e.g. when it is reloaded from a mempool
+         * snapshot taken at that tip with the same script flags. */
+        const bool m_skip_script_checks;
 
         /** Parameters for single transaction mempool validation. */
         static ATMPArgs SingleAccept(const CChainParams& chainparams, int64_t accept_time,
                                      bool bypass_limits, std::vector<COutPoint>& coins_to_uncache,
-                                     bool test_accept) {
+                                     bool test_accept, bool skip_script_checks) {
             return ATMPArgs{/*chainparams=*/ chainparams,
                             /*accept_time=*/ accept_time,
                             /*bypass_limits=*/ bypass_limits,
@@ -504,6 +511,7 @@ public:
                             /*package_submission=*/ false,
                             /*package_feerates=*/ false,
                             /*client_maxfeerate=*/ {}, // checked by caller
+                            /*skip_script_checks=*/ skip_script_checks,
             };
         }
 
@@ -520,6 +528,7 @@ public:
                             /*package_submission=*/ false, // not submitting to mempool
                             /*package_feerates=*/ false,
                             /*client_maxfeerate=*/ {}, // checked by caller
+                            /*skip_script_checks=*/ false,
             };
         }
 
@@ -536,6 +545,7 @@ public:
                             /*package_submission=*/ true,
                             /*package_feerates=*/ true,
                             /*client_maxfeerate=*/ client_maxfeerate,
+                            /*skip_script_checks=*/ false,
             };
         }
 
@@ -551,6 +561,7 @@ public:
                             /*package_submission=*/ true, // trim at the end of AcceptPackage()
                             /*package_feerates=*/ false, // only 1 transaction
                             /*client_maxfeerate=*/ package_args.m_client_maxfeerate,
+                            /*skip_script_checks=*/ false,
             };
         }
 
@@ -566,7 +577,8 @@ public:
                  bool allow_sibling_eviction,
                  bool package_submission,
                  bool package_feerates,
-                 std::optional<CFeeRate> client_maxfeerate)
+                 std::optional<CFeeRate> client_maxfeerate,
+                 bool skip_script_checks)
             : m_chainparams{chainparams},
               m_accept_time{accept_time},
               m_bypass_limits{bypass_limits},
@@ -576,7 +588,8 @@ public:
               m_allow_sibling_eviction{allow_sibling_eviction},
               m_package_submission{package_submission},
               m_package_feerates{package_feerates},
-              m_client_maxfeerate{client_maxfeerate}
+              m_client_maxfeerate{client_maxfeerate},
+              m_skip_script_checks{skip_script_checks}
         {
             // If we are using package feerates, we must be doing package submission.
             // It also means sibling eviction is not permitted.
@@ -1175,7 +1188,29 @@ bool MemPoolAccept::PolicyScriptChecks(const ATMPArgs& args, Workspace& ws)
 
     // Check input scripts and signatures.
     // This is done last to help prevent CPU exhaustion denial-of-service attacks.
-    if (!CheckInputScripts(tx, state, m_view, scriptVerifyFlags, true, false, ws.m_precomputed_txdata, GetValidationCache())) {
+    //
+    // The inputs of larger transactions are verified in parallel on the script
+    // check threads, against the spent outputs captured in the precomputed
+    // transaction data. A failure is reported in the same way as by the serial
+    // CheckInputScripts(), only for the first input that failed on a thread
+    // rather than the one with the lowest index.
+    bool scripts_valid;
+    auto& check_queue{m_active_chainstate.m_chainman.GetCheckQueue()};
+    if (check_queue.HasThreads() && tx.vin.size() >= MIN_INPUTS_FOR_PARALLEL_MEMPOOL_SCRIPT_CHECKS) {
+        std::vector<CScriptCheck> checks;
+        scripts_valid = CheckInputScripts(tx, state, m_view, scriptVerifyFlags, true, false, ws.m_precomputed_txdata, GetValidationCache(), &checks);
+        if (scripts_valid) {
+            CCheckQueueControl<CScriptCheck> control{check_queue};
+            control.Add(std::move(checks));
+            if (const auto result{control.Complete()}) {
+                scripts_valid = state.Invalid(TxValidationResult::TX_NOT_STANDARD, strprintf("mempool-script-verify-flag-failed (%s)", ScriptErrorString(result->first)), result->second);
+            }
+        }
+    } else {
+        scripts_valid = CheckInputScripts(tx, state, m_view, scriptVerifyFlags, true, false, ws.m_precomputed_txdata, GetValidationCache());
+    }
+
+    if (!scripts_valid) {
         // Detect a failure due to a missing witness so that p2p code can handle rejection caching appropriately.
         if (!tx.HasWitness() && SpendsNonAnchorWitnessProg(tx, m_view)) {
             state.Invalid(TxValidationResult::TX_WITNESS_STRIPPED,
@@ -1418,9 +1453,13 @@ MempoolAcceptResult MemPoolAccept::AcceptSingleTransactionInternal(const CTransa
 
     // Perform the inexpensive checks first and avoid hashing and signature verification unless
     // those checks pass, to mitigate CPU exhaustion denial-of-service attacks.
-    if (!PolicyScriptChecks(args, ws)) return MempoolAcceptResult::Failure(ws.m_state);
+    // The consensus script checks are skipped together with the policy ones: the policy checks
+    // already fill the script cache, so running only the consensus checks would save nothing.
+    if (!args.m_skip_script_checks) {
+        if (!PolicyScriptChecks(args, ws)) return MempoolAcceptResult::Failure(ws.m_state);
 
-    if (!ConsensusScriptChecks(args, ws)) return MempoolAcceptResult::Failure(ws.m_state);
+        if (!ConsensusScriptChecks(args, ws)) return MempoolAcceptResult::Failure(ws.m_state);
+    }
 
     const CFeeRate effective_feerate{ws.m_modified_fees, static_cast<int32_t>(ws.m_vsize)};
     // Tx was accepted, but not added
@@ -1812,7 +1851,8 @@ PackageMempoolAcceptResult MemPoolAccept::AcceptPackage(const Package& package,
 } // anon namespace
 
 MempoolAcceptResult AcceptToMemoryPool(Chainstate& active_chainstate, const CTransactionRef& tx,
-                                       int64_t accept_time, bool bypass_limits, bool test_accept)
+                                       int64_t accept_time, bool bypass_limits, bool test_accept,
+                                       bool skip_script_checks)
 {
     AssertLockHeld(::cs_main);
     const CChainParams& chainparams{active_chainstate.m_chainman.GetParams()};
@@ -1821,7 +1861,7 @@ MempoolAcceptResult AcceptToMemoryPool(Chainstate& active_chainstate, const CTra
 
     std::vector<COutPoint> coins_to_uncache;
 
-    auto args = MemPoolAccept::ATMPArgs::SingleAccept(chainparams, accept_time, bypass_limits, coins_to_uncache, test_accept);
+    auto args = MemPoolAccept::ATMPArgs::SingleAccept(chainparams, accept_time, bypass_limits, coins_to_uncache, test_accept, skip_script_checks);
     MempoolAcceptResult result = MemPoolAccept(pool, active_chainstate).AcceptSingleTransactionAndCleanup(tx, args);
 
     if (result.m_result_type != MempoolAcceptResult::ResultType::VALID) {
@@ -5718,7 +5758,9 @@ Chainstate& ChainstateManager::InitializeChainstate(CTxMemPool* mempool)
 
     // We have to destruct before this call leveldb::DB in order to release the db
     // lock, otherwise `DestroyDB` will fail. See `leveldb::~DBImpl()`.
-    const bool destroyed = DestroyDB(path_str);
+    // The name database lives in a subdirectory and has to go first.
+    const bool destroyed = DestroyDB(fs::PathToString(CCoinsViewDB::NamesDBPath(db_path)))
+                           && DestroyDB(path_str);
 
     if (!destroyed) {
         LogError("leveldb DestroyDB call failed on %s", path_str);
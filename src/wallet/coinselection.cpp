@@ -9,13 +9,17 @@
 #include <consensus/consensus.h>
 #include <interfaces/chain.h>
 #include <policy/feerate.h>
+#include <policy/policy.h>
 #include <util/check.h>
 #include <util/log.h>
 #include <util/moneystr.h>
 
+#include <algorithm>
+#include <map>
 #include <numeric>
 #include <optional>
 #include <queue>
+#include <set>
 
 namespace wallet {
 // Common selection error across the algorithms
@@ -820,6 +824,56 @@ util::Result<SelectionResult> KnapsackSolver(std::vector<OutputGroup>& groups, c
     return result;
 }
 
+std::vector<std::optional<SelectionResult>> SelectNameBatchCoins(const std::vector<OutputGroup>& utxo_pool, const std::vector<CAmount>& targets,
+                                                                 CAmount cost_of_change)
+{
+    // The groups that are still available, by their selection amount.
+    std::set<std::pair<CAmount, size_t>> available;
+    // The group of each output, to map the Branch and Bound results back.
+    std::map<COutPoint, size_t> output_groups;
+    for (size_t i = 0; i < utxo_pool.size(); ++i) {
+        available.emplace(utxo_pool[i].GetSelectionAmount(), i);
+        for (const auto& output : utxo_pool[i].m_outputs) {
+            output_groups.emplace(output->outpoint, i);
+        }
+    }
+
+    std::vector<size_t> order(targets.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return targets[a] > targets[b]; });
+
+    std::vector<std::optional<SelectionResult>> results(targets.size());
+    for (const size_t t : order) {
+        std::set<size_t> selected;
+
+        // Groups above the target plus the cost of change cannot be part of a
+        // changeless set, so Branch and Bound only gets the ones below.
+        std::vector<OutputGroup> changeless_pool;
+        const auto changeless_end = available.upper_bound({targets[t] + cost_of_change, utxo_pool.size()});
+        for (auto it = available.begin(); it != changeless_end; ++it) {
+            changeless_pool.push_back(utxo_pool[it->second]);
+        }
+        if (auto bnb_result{SelectCoinsBnB(changeless_pool, targets[t], cost_of_change, MAX_STANDARD_TX_WEIGHT)}) {
+            for (const auto& output : bnb_result->GetInputSet()) {
+                selected.insert(output_groups.at(output->outpoint));
+            }
+        } else if (const auto it = available.lower_bound({targets[t], 0}); it != available.end()) {
+            selected.insert(it->second);
+        } else {
+            continue;
+        }
+
+        SelectionResult result(targets[t], SelectionAlgorithm::NAME_BATCH);
+        for (const size_t i : selected) {
+            result.AddInput(utxo_pool[i]);
+            available.erase({utxo_pool[i].GetSelectionAmount(), i});
+        }
+        results[t] = std::move(result);
+    }
+
+    return results;
+}
+
 /******************************************************************************
 
  OutputGroup
@@ -1041,6 +1095,7 @@ std::string GetAlgorithmName(const SelectionAlgorithm algo)
     case SelectionAlgorithm::SRD: return "srd";
     case SelectionAlgorithm::CG: return "cg";
     case SelectionAlgorithm::MANUAL: return "manual";
+    case SelectionAlgorithm::NAME_BATCH: return "namebatch";
     } // no default case, so the compiler can warn about missing cases
     assert(false);
 }
@@ -316,6 +316,7 @@ enum class SelectionAlgorithm : uint8_t
     SRD = 2,
     CG = 3,
     MANUAL = 4,
+    NAME_BATCH = 5,
 };
 
 std::string GetAlgorithmName(SelectionAlgorithm algo);
@@ -474,6 +475,24 @@ util::Result<SelectionResult> SelectCoinsSRD(const std::vector<OutputGroup>& utx
 // Original coin selection algorithm as a fallback
 util::Result<SelectionResult> KnapsackSolver(std::vector<OutputGroup>& groups, const CAmount& nTargetValue,
                                              CAmount change_target, FastRandomContext& rng, int max_selection_weight);
+
+/** Select the coins paying the fees of a batch of name operations, which are each sent in
+ * their own transaction next to the name input. The targets are served from the largest to
+ * the smallest, all from the same pool, so that no group is used twice. For each target, Branch
+ * and Bound first looks for a set of the remaining groups that needs no change. If there is
+ * none, the target is funded by the single remaining group whose selection amount exceeds it
+ * the least (best fit decreasing). This keeps the change of the whole batch small, and saves
+ * the larger groups for the targets that need them.
+ *
+ * @param[in]  utxo_pool      The positive effective value OutputGroups eligible for selection
+ * @param[in]  targets        The selection target of each transaction in the batch
+ * @param[in]  cost_of_change The cost of creating and spending a change output, up to which
+ *                            a selection may exceed its target without change
+ * @returns The selection for each target in the order of @p targets, or std::nullopt for
+ *          targets that no remaining group covers (to be funded by the normal coin selection)
+ */
+std::vector<std::optional<SelectionResult>> SelectNameBatchCoins(const std::vector<OutputGroup>& utxo_pool, const std::vector<CAmount>& targets,
+                                                                 CAmount cost_of_change);
 } // namespace wallet
 
 #endif // BITCOIN_WALLET_COINSELECTION_H
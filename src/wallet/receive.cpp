@@ -304,15 +304,12 @@ Balance GetBalance(const CWallet& wallet, const int min_depth, bool avoid_reuse,
     {
         LOCK(wallet.cs_wallet);
         std::set<Txid> trusted_parents;
-        for (const auto& [outpoint, txo] : wallet.GetTXOs()) {
-            const CWalletTx& wtx = txo.GetWalletTx();
+        for (const auto& [outpoint, txo] : wallet.GetUnspentTXOs()) {
+            const CWalletTx& wtx = txo->GetWalletTx();
 
             const bool is_trusted{CachedTxIsTrusted(wallet, wtx, trusted_parents)};
             const int tx_depth{wallet.GetTxDepthInMainChain(wtx)};
 
-            if (CNameScript::isNameScript(txo.GetTxOut().scriptPubKey))
-                continue;
-
             bool nonmempool_spent = false;
             switch (wallet.HowSpent(outpoint)) {
             case CWallet::SpendType::CONFIRMED:
@@ -336,9 +333,9 @@ Balance GetBalance(const CWallet& wallet, const int min_depth, bool avoid_reuse,
                 }
                 if (bucket) {
                     // Get the amounts for mine
-                    CAmount credit_mine = txo.GetTxOut().nValue;
+                    CAmount credit_mine = txo->GetTxOut().nValue;
 
-                    if (!allow_used_addresses && wallet.IsSpentKey(txo.GetTxOut().scriptPubKey)) {
+                    if (!allow_used_addresses && wallet.IsSpentKey(txo->GetTxOut().scriptPubKey)) {
                         bucket = &ret.m_mine_used;
                     }
                     *bucket += credit_mine;
@@ -362,7 +359,7 @@ std::map<CTxDestination, CAmount> GetAddressBalances(const CWallet& wallet)
         for (const auto& [outpoint, txo] : wallet.GetTXOs()) {
             const CWalletTx& wtx = txo.GetWalletTx();
 
-            if (CNameScript::isNameScript(txo.GetTxOut().scriptPubKey))
+            if (txo.IsNameOutput())
                 continue;
 
             if (!CachedTxIsTrusted(wallet, wtx, trusted_parents)) continue;
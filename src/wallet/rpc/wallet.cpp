@@ -1141,7 +1141,9 @@ RPCMethod getauxblock();
 RPCMethod name_list();
 RPCMethod name_new();
 RPCMethod name_firstupdate();
+RPCMethod name_register_batch();
 RPCMethod name_update();
+RPCMethod name_update_batch();
 RPCMethod queuerawtransaction();
 RPCMethod dequeuetransaction();
 RPCMethod listqueuedtransactions();
@@ -1219,7 +1221,9 @@ std::span<const CRPCCommand> GetWalletRPCCommands()
         {"names", &name_list},
         {"names", &name_new},
         {"names", &name_firstupdate},
+        {"names", &name_register_batch},
         {"names", &name_update},
+        {"names", &name_update_batch},
         {"names", &queuerawtransaction},
         {"names", &dequeuetransaction},
         {"names", &listqueuedtransactions},
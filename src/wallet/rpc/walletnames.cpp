@@ -19,6 +19,7 @@
 #include <node/context.h>
 #include <node/types.h>
 #include <net.h>
+#include <policy/policy.h>
 #include <primitives/transaction.h>
 #include <primitives/transaction_identifier.h>
 #include <random.h>
@@ -28,21 +29,27 @@
 #include <rpc/server_util.h>
 #include <rpc/util.h>
 #include <script/names.h>
+#include <serialize.h>
 #include <txmempool.h>
 #include <util/moneystr.h>
 #include <util/translation.h>
 #include <util/vector.h>
 #include <validation.h>
 #include <wallet/coincontrol.h>
+#include <wallet/coinselection.h>
+#include <wallet/fees.h>
 #include <wallet/rpc/util.h>
 #include <wallet/rpc/wallet.h>
 #include <wallet/scriptpubkeyman.h>
+#include <wallet/spend.h>
 #include <wallet/wallet.h>
 
 #include <univalue.h>
 
 #include <algorithm>
 #include <memory>
+#include <set>
+#include <vector>
 
 namespace wallet
 {
@@ -455,6 +462,23 @@ name_new ()
   LogInfo ("name_new: name=%s, rand=%s, tx=%s\n",
            EncodeNameForMessage (name), randStr.c_str (), txid.c_str ());
 
+  /* Remember where the name_new is and its salt, so that name_firstupdate
+     can find them directly.  */
+  const auto mit = pwallet->mapWallet.find (*Txid::FromHex (txid));
+  if (mit != pwallet->mapWallet.end ())
+    {
+      const auto& vout = mit->second.GetTx ()->vout;
+      for (uint32_t i = 0; i < vout.size (); ++i)
+        {
+          const CNameScript cur(vout[i].scriptPubKey);
+          if (!cur.isNameOp () || cur.getNameOp () != OP_NAME_NEW)
+            continue;
+          if (!pwallet->WriteNameNew (name, {COutPoint (mit->first, i), rand}))
+            LogWarning ("name_new: failed to store salt for tx=%s\n", txid);
+          break;
+        }
+    }
+
   UniValue res(UniValue::VARR);
   res.push_back (txid);
   res.push_back (randStr);
@@ -512,6 +536,44 @@ getNamePrevout (Chainstate& chainState, const Txid& txid,
   return false;
 }
 
+/**
+ * Looks up the name_new for a name_firstupdate in the wallet's index of
+ * name_new outpoints and salts.  If the txid or rand are given explicitly,
+ * the indexed name_new must match them.  The name_new output must also
+ * still be unspent.
+ * @return True if the name_new was found; then rand, txOut and txIn are set.
+ */
+bool
+getIndexedNameNew (const CWallet& wallet, Chainstate& chainState,
+                   const valtype& name, const Txid* fixedTxid,
+                   valtype& rand, const bool fixedRand,
+                   CTxOut& txOut, CTxIn& txIn)
+{
+  std::optional<NameNewSalt> nameNew;
+  {
+    LOCK (wallet.cs_wallet);
+    nameNew = wallet.GetNameNew (name);
+  }
+  if (!nameNew)
+    return false;
+  if (fixedTxid != nullptr && nameNew->outpoint.hash != *fixedTxid)
+    return false;
+  if (fixedRand && nameNew->rand != rand)
+    return false;
+
+  LOCK (cs_main);
+  const auto coin = chainState.CoinsTip ().GetCoin (nameNew->outpoint);
+  if (!coin || !CNameScript::isNameScript (coin->out.scriptPubKey))
+    return false;
+
+  LogDebug (BCLog::NAMES, "%s: using stored name_new %s:%u\n", __func__,
+            nameNew->outpoint.hash.GetHex (), nameNew->outpoint.n);
+  rand = nameNew->rand;
+  txOut = coin->out;
+  txIn = CTxIn (nameNew->outpoint);
+  return true;
+}
+
 }  // anonymous namespace
 
 RPCMethod
@@ -609,7 +671,16 @@ name_firstupdate ()
         throw JSONRPCError (RPC_INVALID_PARAMETER, "invalid txid");
       prevTxid = *id;
     }
-  else
+
+  CTxOut prevOut;
+  CTxIn txIn;
+  const bool indexed
+      = getIndexedNameNew (*pwallet, chainman.ActiveChainstate (), name,
+                           fixedTxid ? &prevTxid : nullptr, rand, fixedRand,
+                           prevOut, txIn);
+  if (indexed)
+    prevTxid = txIn.prevout.hash;
+  else if (!fixedTxid)
     {
       // Code slightly duplicates name_scan, but not enough to be able to refactor.
       /* Make sure the results are valid at least up to the most recent block
@@ -666,17 +737,16 @@ name_firstupdate ()
   if (prevTxid.IsNull ())
     throw JSONRPCError (RPC_TRANSACTION_ERROR, "scan for previous txid failed");
 
-  CTxOut prevOut;
-  CTxIn txIn;
-  {
-    LOCK (cs_main);
-    if (!getNamePrevout (chainman.ActiveChainstate (), prevTxid, prevOut, txIn))
-      throw JSONRPCError (RPC_TRANSACTION_ERROR, "previous txid not found");
-  }
+  if (!indexed)
+    {
+      LOCK (cs_main);
+      if (!getNamePrevout (chainman.ActiveChainstate (), prevTxid, prevOut, txIn))
+        throw JSONRPCError (RPC_TRANSACTION_ERROR, "previous txid not found");
+    }
 
   const CNameScript prevNameOp(prevOut.scriptPubKey);
 
-  if (!fixedRand)
+  if (!fixedRand && !indexed)
     {
       LOCK (pwallet->cs_wallet);
       bool saltOK = getNameSalt (pwallet, name, prevOut.scriptPubKey, rand);
@@ -719,6 +789,359 @@ name_firstupdate ()
 
 /* ************************************************************************** */
 
+namespace
+{
+
+/* Version, lock time, input and output counts and the segwit marker.  */
+constexpr int64_t TX_OVERHEAD = 11;
+/* P2PKH inputs are the largest standard ones with a single key.  */
+constexpr int64_t MAX_INPUT_SIZE = 148;
+/* P2TR outputs are the largest ones the wallet uses for change.  */
+constexpr int64_t MAX_CHANGE_SIZE = 43;
+
+/**
+ * Upper bound for the virtual size of a name_firstupdate that spends the
+ * name_new output and one other input, and has the given name output and
+ * one change output.
+ */
+int64_t
+GetFirstupdateMaxVsize (const CScript& nameOutput)
+{
+  const CTxOut nameOut(NAME_LOCKED_AMOUNT, nameOutput);
+  return TX_OVERHEAD + 2 * MAX_INPUT_SIZE
+            + static_cast<int64_t> (GetSerializeSize (nameOut))
+            + MAX_CHANGE_SIZE;
+}
+
+/**
+ * Upper bound for the virtual size of a name_update with the given name
+ * output, excluding the coins that pay its fee and the change.  This is the
+ * part of the fee that those coins have to cover with their effective value.
+ */
+int64_t
+GetUpdateMaxVsizeWithoutFunding (const CScript& nameOutput)
+{
+  const CTxOut nameOut(NAME_LOCKED_AMOUNT, nameOutput);
+  return TX_OVERHEAD + MAX_INPUT_SIZE
+            + static_cast<int64_t> (GetSerializeSize (nameOut));
+}
+
+/**
+ * Returns the output that an update of the given name has to spend.  If
+ * there are pending operations on the name in the mempool, then we build
+ * upon the last one to get a valid chain.  If there are none, then we look
+ * up the last outpoint from the name database instead.  If value is not
+ * null, it is set to the current value of the name.
+ */
+COutPoint
+GetNameUpdateInput (const node::NodeContext& node,
+                    const ChainstateManager& chainman,
+                    const valtype& name, valtype* value)
+{
+  // TODO: Use name_show for this instead.
+
+  const unsigned chainLimit = gArgs.GetIntArg ("-limitnamechains",
+                                               DEFAULT_NAME_CHAIN_LIMIT);
+  {
+    auto& mempool = EnsureMemPool (node);
+    LOCK (mempool.cs);
+
+    const unsigned pendingOps = mempool.pendingNameChainLength (name);
+    if (pendingOps >= chainLimit)
+      throw JSONRPCError (RPC_TRANSACTION_ERROR,
+                          "there are already too many pending operations"
+                          " on this name");
+
+    if (pendingOps > 0)
+      {
+        const COutPoint outp = mempool.lastNameOutput (name);
+        if (value != nullptr)
+          {
+            const auto& tx = mempool.mapTx.find(outp.hash)->GetTx();
+            *value = CNameScript(tx.vout[outp.n].scriptPubKey).getOpValue();
+          }
+        return outp;
+      }
+  }
+
+  LOCK (cs_main);
+
+  CNameData oldData;
+  const auto& coinsTip = chainman.ActiveChainstate ().CoinsTip ();
+  if (!coinsTip.GetName (name, oldData)
+        || oldData.isExpired (chainman.ActiveHeight ()))
+    throw JSONRPCError (RPC_TRANSACTION_ERROR,
+                        "this name can not be updated");
+  if (value != nullptr)
+    *value = oldData.getValue();
+
+  const COutPoint outp = oldData.getUpdateOutpoint ();
+  assert (!outp.IsNull ());
+  return outp;
+}
+
+/**
+ * Returns the index of the output of tx that has the given script and
+ * amount and is not a name output.
+ */
+std::optional<uint32_t>
+FindPlainOutput (const CTransaction& tx, const CScript& script,
+                 const CAmount amount)
+{
+  for (uint32_t i = 0; i < tx.vout.size (); ++i)
+    if (tx.vout[i].scriptPubKey == script && tx.vout[i].nValue == amount
+          && !CNameScript::isNameScript (tx.vout[i].scriptPubKey))
+      return i;
+  return std::nullopt;
+}
+
+} // anonymous namespace
+
+RPCMethod
+name_register_batch ()
+{
+  NameOptionsHelp optHelp;
+  optHelp
+      .withNameEncoding ()
+      .withValueEncoding ()
+      .withArg ("destAddress", RPCArg::Type::STR,
+                "The address to send the registered names to")
+      .withArg ("allowExisting", RPCArg::Type::BOOL, "false",
+                "If set, then the names are registered even if they exist already");
+
+  return RPCMethod ("name_register_batch",
+      "Starts the registration of many names at once.  For each name, a name_new is sent"
+      " and the matching name_firstupdate is put into the transaction queue, from where it is"
+      " broadcast as soon as the name_new has matured.  The name_new transactions have an extra"
+      " output that pays the fee of the name_firstupdate, so that it does not need any other"
+      " coins of the wallet.  If the registration of a name fails, those before it are still"
+      " sent and queued, and their data is written to the debug log."
+          + HELP_REQUIRING_PASSPHRASE,
+      {
+          {"names", RPCArg::Type::ARR, RPCArg::Optional::NO, "The names to register",
+              {
+                  {"", RPCArg::Type::OBJ, RPCArg::Optional::OMITTED, "",
+                      {
+                          {"name", RPCArg::Type::STR, RPCArg::Optional::NO, "The name to register"},
+                          {"value", RPCArg::Type::STR, RPCArg::Default{""}, "Value for the name"},
+                      },
+                  },
+              },
+          },
+          optHelp.buildRpcArg (),
+      },
+      RPCResult {RPCResult::Type::ARR, "", "",
+          {
+              {RPCResult::Type::OBJ, "", "",
+                  {
+                      {RPCResult::Type::STR, "name", "the name as given"},
+                      {RPCResult::Type::STR_HEX, "txid", "the name_new txid"},
+                      {RPCResult::Type::STR_HEX, "rand", "the rand value of the name_new"},
+                      {RPCResult::Type::STR_HEX, "firstupdate", "the txid of the queued name_firstupdate"},
+                  }},
+          },
+      },
+      RPCExamples {
+          HelpExampleCli ("name_register_batch", R"('[{"name":"d/foo","value":"{}"},{"name":"d/bar"}]')")
+        + HelpExampleRpc ("name_register_batch", R"([{"name":"d/foo","value":"{}"},{"name":"d/bar"}])")
+      },
+      [&] (const RPCMethod& self, const JSONRPCRequest& request) -> UniValue
+{
+  std::shared_ptr<CWallet> const wallet = GetWalletForJSONRPCRequest (request);
+  if (!wallet)
+    return NullUniValue;
+  CWallet* const pwallet = wallet.get ();
+
+  auto& node = EnsureAnyNodeContext (request);
+  const auto& chainman = EnsureChainman (node);
+  if (pwallet->GetBroadcastTransactions ())
+    EnsureConnman (node);
+
+  UniValue options(UniValue::VOBJ);
+  if (request.params.size () >= 2)
+    options = request.params[1].get_obj ();
+  RPCTypeCheckObj (options,
+    {
+      {"allowExisting", UniValueType (UniValue::VBOOL)},
+    },
+    true, false);
+
+  struct Registration
+  {
+    std::string nameStr;
+    valtype name;
+    valtype value;
+  };
+  std::vector<Registration> registrations;
+  std::set<valtype> seen;
+  for (const UniValue& entry : request.params[0].get_array ().getValues ())
+    {
+      RPCTypeCheckObj (entry,
+        {
+          {"name", UniValueType (UniValue::VSTR)},
+          {"value", UniValueType (UniValue::VSTR)},
+        },
+        true, true);
+
+      Registration reg;
+      reg.nameStr = entry["name"].get_str ();
+      reg.name = DecodeNameFromRPCOrThrow (entry["name"], options);
+      if (reg.name.size () > MAX_NAME_LENGTH)
+        throw JSONRPCError (RPC_INVALID_PARAMETER, "the name is too long: " + reg.nameStr);
+      if (!seen.insert (reg.name).second)
+        throw JSONRPCError (RPC_INVALID_PARAMETER, "duplicate name: " + reg.nameStr);
+      if (!entry["value"].isNull ())
+        reg.value = DecodeValueFromRPCOrThrow (entry["value"], options);
+      if (reg.value.size () > MAX_VALUE_LENGTH_UI)
+        throw JSONRPCError (RPC_INVALID_PARAMETER, "the value is too long for " + reg.nameStr);
+
+      registrations.push_back (std::move (reg));
+    }
+
+  if (!options["allowExisting"].isTrue ())
+    {
+      LOCK (cs_main);
+      const auto& coinsTip = chainman.ActiveChainstate ().CoinsTip ();
+      for (const auto& reg : registrations)
+        {
+          CNameData oldData;
+          if (coinsTip.GetName (reg.name, oldData)
+                && !oldData.isExpired (chainman.ActiveHeight ()))
+            throw JSONRPCError (RPC_TRANSACTION_ERROR, "this name exists already: " + reg.nameStr);
+        }
+    }
+
+  /* Make sure the results are valid at least up to the most recent block
+     the user could have gotten from another RPC command prior to now.  */
+  pwallet->BlockUntilSyncedToCurrentChain ();
+
+  LOCK (pwallet->cs_wallet);
+
+  EnsureWalletIsUnlocked (*pwallet);
+
+  UniValue res(UniValue::VARR);
+  std::vector<CMutableTransaction> firstupdates;
+  std::vector<std::pair<valtype, NameNewSalt>> nameNews;
+  try
+    {
+      for (const auto& reg : registrations)
+        {
+          /* The name_new (and the fee output for the name_firstupdate) must
+             go to the wallet, so that it can sign the name_firstupdate.  */
+          DestinationAddressHelper newHelper(*pwallet);
+          const CTxDestination newDest = newHelper.getDest ();
+          const CScript newScript = GetScriptForDestination (newDest);
+
+          valtype rand(20);
+          if (!getNameSalt (pwallet, reg.name, newScript, rand))
+            GetRandBytes (rand);
+
+          DestinationAddressHelper ownerHelper(*pwallet);
+          ownerHelper.setOptions (options);
+          const CTxDestination ownerDest = ownerHelper.getDest ();
+
+          CCoinControl coinControl;
+          const CScript firstOp
+              = CNameScript::buildNameFirstupdate (CScript (), reg.name,
+                                                   reg.value, rand);
+          const CScript firstOutput
+              = CNameScript::buildNameFirstupdate (GetScriptForDestination (ownerDest),
+                                                   reg.name, reg.value, rand);
+          const CFeeRate feeRate
+              = GetMinimumFeeRate (*pwallet, coinControl, nullptr);
+          const CTxOut feeOut(0, newScript);
+          const CAmount feeAmount
+              = std::max (feeRate.GetFee (GetFirstupdateMaxVsize (firstOutput)),
+                          GetDustThreshold (feeOut, pwallet->chain ().relayDustFee ()));
+
+          const CScript newOp
+              = CNameScript::buildNameNew (CScript (), reg.name, rand);
+          std::vector<CRecipient> newSend;
+          newSend.push_back ({newDest, NAME_LOCKED_AMOUNT, false, newOp});
+          newSend.push_back ({newDest, feeAmount, false, CScript ()});
+          auto newRes = CreateTransaction (*pwallet, newSend, nullptr,
+                                           std::nullopt, coinControl, true);
+          if (!newRes)
+            throw JSONRPCError (RPC_WALLET_INSUFFICIENT_FUNDS,
+                                util::ErrorString (newRes).original);
+          const CTransactionRef newTx = newRes->tx;
+
+          std::optional<uint32_t> nameIndex;
+          for (uint32_t i = 0; i < newTx->vout.size (); ++i)
+            if (CNameScript::isNameScript (newTx->vout[i].scriptPubKey))
+              nameIndex = i;
+          const auto feeIndex = FindPlainOutput (*newTx, newScript, feeAmount);
+          assert (nameIndex && feeIndex);
+
+          pwallet->CommitTransaction (newTx, std::nullopt, {}, {});
+          newHelper.finalise ();
+          LogInfo ("name_register_batch: name=%s, rand=%s, tx=%s\n",
+                   EncodeNameForMessage (reg.name), HexStr (rand),
+                   newTx->GetHash ().GetHex ());
+
+          /* Lock the outputs for the name_firstupdate right away, so that
+             the later name_new's of the batch do not spend them.  The locks
+             and the name_new are persisted together with the queued
+             name_firstupdates at the end.  */
+          const COutPoint nameOut(newTx->GetHash (), *nameIndex);
+          const COutPoint feeOutpoint(newTx->GetHash (), *feeIndex);
+          pwallet->LockCoin (nameOut, /*persist=*/false);
+          pwallet->LockCoin (feeOutpoint, /*persist=*/false);
+          nameNews.emplace_back (reg.name, NameNewSalt{nameOut, rand});
+
+          CCoinControl firstControl;
+          firstControl.m_allow_other_inputs = false;
+          firstControl.Select (feeOutpoint);
+          const CTxIn nameIn(nameOut);
+          std::vector<CRecipient> firstSend;
+          firstSend.push_back ({ownerDest, NAME_LOCKED_AMOUNT, false, firstOp});
+          auto firstRes = CreateTransaction (*pwallet, firstSend, &nameIn,
+                                             std::nullopt, firstControl, true);
+          if (!firstRes)
+            {
+              pwallet->UnlockCoin (nameOut);
+              pwallet->UnlockCoin (feeOutpoint);
+              throw JSONRPCError (RPC_WALLET_ERROR,
+                                  strprintf ("Failed to create name_firstupdate for %s: %s",
+                                             reg.nameStr,
+                                             util::ErrorString (firstRes).original));
+            }
+          ownerHelper.finalise ();
+          firstupdates.emplace_back (*firstRes->tx);
+
+          UniValue entry(UniValue::VOBJ);
+          entry.pushKVEnd ("name", reg.nameStr);
+          entry.pushKVEnd ("txid", newTx->GetHash ().GetHex ());
+          entry.pushKVEnd ("rand", HexStr (rand));
+          entry.pushKVEnd ("firstupdate", firstRes->tx->GetHash ().GetHex ());
+          res.push_back (std::move (entry));
+        }
+    }
+  catch (...)
+    {
+      /* Queue the name_firstupdates for the name_new's that were sent
+         already, so that they are not lost, and record their data, which
+         the error reply cannot return.  */
+      if (!pwallet->WriteQueuedTransactions (firstupdates, nameNews))
+        LogWarning ("name_register_batch: failed to queue the name_firstupdates\n");
+      for (const UniValue& entry : res.getValues ())
+        LogWarning ("name_register_batch: aborted after registering name=%s,"
+                    " rand=%s, tx=%s, firstupdate=%s\n",
+                    entry["name"].get_str (), entry["rand"].get_str (),
+                    entry["txid"].get_str (), entry["firstupdate"].get_str ());
+      throw;
+    }
+
+  if (!pwallet->WriteQueuedTransactions (firstupdates, nameNews))
+    throw JSONRPCError (RPC_WALLET_ERROR, "Error queueing the name_firstupdate transactions");
+
+  return res;
+}
+  );
+}
+
+/* ************************************************************************** */
+
 RPCMethod
 name_update ()
 {
@@ -768,52 +1191,9 @@ name_update ()
           throw JSONRPCError (RPC_INVALID_PARAMETER, "the value is too long");
   }
 
-  /* For finding the name output to spend and its value, we first check if
-     there are pending operations on the name in the mempool.  If there
-     are, then we build upon the last one to get a valid chain.  If there
-     are none, then we look up the last outpoint from the name database
-     instead. */
-  // TODO: Use name_show for this instead.
-
-  const unsigned chainLimit = gArgs.GetIntArg ("-limitnamechains",
-                                               DEFAULT_NAME_CHAIN_LIMIT);
-  COutPoint outp;
-  {
-    auto& mempool = EnsureMemPool (node);
-    LOCK (mempool.cs);
-
-    const unsigned pendingOps = mempool.pendingNameChainLength (name);
-    if (pendingOps >= chainLimit)
-      throw JSONRPCError (RPC_TRANSACTION_ERROR,
-                          "there are already too many pending operations"
-                          " on this name");
-
-    if (pendingOps > 0)
-      {
-        outp = mempool.lastNameOutput (name);
-        if (isDefaultVal)
-          {
-            const auto& tx = mempool.mapTx.find(outp.hash)->GetTx();
-            value = CNameScript(tx.vout[outp.n].scriptPubKey).getOpValue();
-          }
-      }
-  }
-
-  if (outp.IsNull ())
-    {
-      LOCK (cs_main);
-
-      CNameData oldData;
-      const auto& coinsTip = chainman.ActiveChainstate ().CoinsTip ();
-      if (!coinsTip.GetName (name, oldData)
-            || oldData.isExpired (chainman.ActiveHeight ()))
-        throw JSONRPCError (RPC_TRANSACTION_ERROR,
-                            "this name can not be updated");
-      if (isDefaultVal)
-        value = oldData.getValue();
-      outp = oldData.getUpdateOutpoint ();
-    }
-  assert (!outp.IsNull ());
+  const COutPoint outp
+      = GetNameUpdateInput (node, chainman, name,
+                            isDefaultVal ? &value : nullptr);
   const CTxIn txIn(outp);
 
   /* Make sure the results are valid at least up to the most recent block
@@ -840,6 +1220,206 @@ name_update ()
   );
 }
 
+RPCMethod
+name_update_batch ()
+{
+  NameOptionsHelp optHelp;
+  optHelp
+      .withNameEncoding ()
+      .withValueEncoding ()
+      .withArg ("destAddress", RPCArg::Type::STR,
+                "The address to send all updated names to");
+
+  return RPCMethod ("name_update_batch",
+      "Updates many names at once, each in its own transaction.  The fees of all"
+      " transactions are selected together, such that each is paid by the coin"
+      " that covers it with the least change.  Updates for which no single coin is"
+      " left use the normal coin selection.  If the update of a name fails, those"
+      " before it are still sent."
+          + HELP_REQUIRING_PASSPHRASE,
+      {
+          {"names", RPCArg::Type::ARR, RPCArg::Optional::NO, "The names to update",
+              {
+                  {"", RPCArg::Type::OBJ, RPCArg::Optional::OMITTED, "",
+                      {
+                          {"name", RPCArg::Type::STR, RPCArg::Optional::NO, "The name to update"},
+                          {"value", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "Value for the name"},
+                      },
+                  },
+              },
+          },
+          optHelp.buildRpcArg (),
+      },
+      RPCResult {RPCResult::Type::ARR, "", "",
+          {
+              {RPCResult::Type::OBJ, "", "",
+                  {
+                      {RPCResult::Type::STR, "name", "the name as given"},
+                      {RPCResult::Type::STR_HEX, "txid", "the transaction ID"},
+                  }},
+          },
+      },
+      RPCExamples {
+          HelpExampleCli ("name_update_batch", R"('[{"name":"d/foo","value":"{}"},{"name":"d/bar"}]')")
+        + HelpExampleRpc ("name_update_batch", R"([{"name":"d/foo","value":"{}"},{"name":"d/bar"}])")
+      },
+      [&] (const RPCMethod& self, const JSONRPCRequest& request) -> UniValue
+{
+  std::shared_ptr<CWallet> const wallet = GetWalletForJSONRPCRequest (request);
+  if (!wallet)
+    return NullUniValue;
+  CWallet* const pwallet = wallet.get ();
+
+  const auto& node = EnsureAnyNodeContext (request);
+  const auto& chainman = EnsureChainman (node);
+
+  UniValue options(UniValue::VOBJ);
+  if (request.params.size () >= 2)
+    options = request.params[1].get_obj ();
+
+  struct Update
+  {
+    std::string nameStr;
+    valtype name;
+    valtype value;
+    COutPoint input;
+  };
+  std::vector<Update> updates;
+  std::set<valtype> seen;
+  for (const UniValue& entry : request.params[0].get_array ().getValues ())
+    {
+      RPCTypeCheckObj (entry,
+        {
+          {"name", UniValueType (UniValue::VSTR)},
+          {"value", UniValueType (UniValue::VSTR)},
+        },
+        true, true);
+
+      Update upd;
+      upd.nameStr = entry["name"].get_str ();
+      upd.name = DecodeNameFromRPCOrThrow (entry["name"], options);
+      if (upd.name.size () > MAX_NAME_LENGTH)
+        throw JSONRPCError (RPC_INVALID_PARAMETER, "the name is too long: " + upd.nameStr);
+      if (!seen.insert (upd.name).second)
+        throw JSONRPCError (RPC_INVALID_PARAMETER, "duplicate name: " + upd.nameStr);
+
+      const bool isDefaultVal = entry["value"].isNull ();
+      if (!isDefaultVal)
+        {
+          upd.value = DecodeValueFromRPCOrThrow (entry["value"], options);
+          if (upd.value.size () > MAX_VALUE_LENGTH_UI)
+            throw JSONRPCError (RPC_INVALID_PARAMETER, "the value is too long for " + upd.nameStr);
+        }
+
+      upd.input = GetNameUpdateInput (node, chainman, upd.name,
+                                      isDefaultVal ? &upd.value : nullptr);
+      updates.push_back (std::move (upd));
+    }
+
+  /* Make sure the results are valid at least up to the most recent block
+     the user could have gotten from another RPC command prior to now.  */
+  pwallet->BlockUntilSyncedToCurrentChain ();
+
+  LOCK (pwallet->cs_wallet);
+
+  EnsureWalletIsUnlocked (*pwallet);
+
+  /* Fail before sending anything if one of the names is not in the wallet,
+     which would only be noticed when signing otherwise.  */
+  for (const auto& upd : updates)
+    {
+      const auto owned = pwallet->GetUnspentNameOutpoints (upd.name);
+      if (std::find (owned.begin (), owned.end (), upd.input) == owned.end ())
+        throw JSONRPCError (RPC_WALLET_ERROR,
+                            "the wallet does not own the name " + upd.nameStr);
+    }
+
+  std::vector<std::unique_ptr<DestinationAddressHelper>> destHelpers;
+  std::vector<CTxDestination> dests;
+  std::vector<CScript> nameOps;
+  std::vector<CAmount> targets;
+  CCoinControl coinControl;
+  const CFeeRate feeRate = GetMinimumFeeRate (*pwallet, coinControl, nullptr);
+  for (const auto& upd : updates)
+    {
+      destHelpers.push_back (std::make_unique<DestinationAddressHelper> (*pwallet));
+      destHelpers.back ()->setOptions (options);
+      dests.push_back (destHelpers.back ()->getDest ());
+
+      nameOps.push_back (CNameScript::buildNameUpdate (CScript (), upd.name,
+                                                       upd.value));
+      const CScript nameOutput
+          = CNameScript::buildNameUpdate (GetScriptForDestination (dests.back ()),
+                                          upd.name, upd.value);
+      targets.push_back (feeRate.GetFee (GetUpdateMaxVsizeWithoutFunding (nameOutput)));
+    }
+
+  std::vector<OutputGroup> feeCoins;
+  for (const COutput& coin : AvailableCoins (*pwallet, &coinControl, feeRate).All ())
+    if (coin.GetEffectiveValue () > 0)
+      {
+        OutputGroup group;
+        group.Insert (std::make_shared<COutput> (coin), 0, 0);
+        feeCoins.push_back (std::move (group));
+      }
+  /* The cost of creating and later spending a P2WPKH change output.  Coins
+     exceeding a target by less than that are spent without change.  */
+  const CTxOut changePrototype (0, GetScriptForDestination (WitnessV0KeyHash ()));
+  const CAmount costOfChange
+      = feeRate.GetFee (GetSerializeSize (changePrototype))
+          + GetDiscardRate (*pwallet).GetFee (DUMMY_NESTED_P2WPKH_INPUT_SIZE);
+  const auto selections = SelectNameBatchCoins (feeCoins, targets, costOfChange);
+
+  /* Lock the coins selected for each transaction while the ones before it
+     are created, so that their coin selection (if it needs more inputs)
+     does not take them away.  */
+  std::vector<COutPoint> locked;
+  for (const auto& sel : selections)
+    if (sel)
+      for (const auto& coin : sel->GetInputSet ())
+        {
+          pwallet->LockCoin (coin->outpoint, false);
+          locked.push_back (coin->outpoint);
+        }
+
+  UniValue res(UniValue::VARR);
+  try
+    {
+      for (size_t i = 0; i < updates.size (); ++i)
+        {
+          CCoinControl sendControl;
+          if (selections[i])
+            for (const auto& coin : selections[i]->GetInputSet ())
+              {
+                pwallet->UnlockCoin (coin->outpoint);
+                sendControl.Select (coin->outpoint);
+              }
+
+          const CTxIn txIn(updates[i].input);
+          std::vector<CRecipient> vecSend;
+          vecSend.push_back ({dests[i], NAME_LOCKED_AMOUNT, false, nameOps[i]});
+          const UniValue txid
+              = SendMoney (*pwallet, sendControl, &txIn, vecSend, {}, {}, false);
+          destHelpers[i]->finalise ();
+
+          UniValue entry(UniValue::VOBJ);
+          entry.pushKVEnd ("name", updates[i].nameStr);
+          entry.pushKVEnd ("txid", txid);
+          res.push_back (std::move (entry));
+        }
+    }
+  catch (...)
+    {
+      for (const auto& outp : locked)
+        pwallet->UnlockCoin (outp);
+      throw;
+    }
+
+  return res;
+}
+  );
+}
+
 /* ************************************************************************** */
 
 RPCMethod
@@ -977,7 +1557,7 @@ listqueuedtransactions ()
   for (const auto& i : wallet->queuedTransactionMap)
   {
     const Txid& txid = i.first;
-    const CMutableTransaction& tx = i.second;
+    const CMutableTransaction& tx = i.second.tx;
 
     const std::string txStr = EncodeHexTx(CTransaction(tx));
 
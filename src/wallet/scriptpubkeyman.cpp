@@ -23,6 +23,7 @@
 #include <util/translation.h>
 
 #include <optional>
+#include <set>
 
 using common::PSBTError;
 using util::ToString;
@@ -1300,7 +1301,7 @@ std::unique_ptr<FlatSigningProvider> DescriptorScriptPubKeyMan::GetSigningProvid
     return out;
 }
 
-std::unique_ptr<FlatSigningProvider> DescriptorScriptPubKeyMan::GetSigningProvider(int32_t index, bool include_private) const
+std::unique_ptr<FlatSigningProvider> DescriptorScriptPubKeyMan::GetSigningProvider(int32_t index, bool include_private, const FlatSigningProvider* master_provider) const
 {
     AssertLockHeld(cs_desc_man);
 
@@ -1320,9 +1321,13 @@ std::unique_ptr<FlatSigningProvider> DescriptorScriptPubKeyMan::GetSigningProvid
     }
 
     if (HavePrivateKeys() && include_private) {
-        FlatSigningProvider master_provider;
-        master_provider.keys = GetKeys();
-        m_wallet_descriptor.descriptor->ExpandPrivate(index, master_provider, *out_keys);
+        if (master_provider) {
+            m_wallet_descriptor.descriptor->ExpandPrivate(index, *master_provider, *out_keys);
+        } else {
+            FlatSigningProvider keys;
+            keys.keys = GetKeys();
+            m_wallet_descriptor.descriptor->ExpandPrivate(index, keys, *out_keys);
+        }
 
         // Always include musig_secnonces as this descriptor may have a participant private key
         // but not a musig() descriptor
@@ -1350,12 +1355,32 @@ bool DescriptorScriptPubKeyMan::CanProvide(const CScript& script, SignatureData&
 bool DescriptorScriptPubKeyMan::SignTransaction(CMutableTransaction& tx, const std::map<COutPoint, Coin>& coins, int sighash, std::map<int, bilingual_str>& input_errors) const
 {
     std::unique_ptr<FlatSigningProvider> keys = std::make_unique<FlatSigningProvider>();
-    for (const auto& coin_pair : coins) {
-        std::unique_ptr<FlatSigningProvider> coin_keys = GetSigningProvider(coin_pair.second.out.scriptPubKey, true);
-        if (!coin_keys) {
-            continue;
+    {
+        LOCK(cs_desc_man);
+
+        // Large transactions often spend several coins of the same script, so
+        // expand each index only once.  The wallet's keys (which may have to be
+        // decrypted) are also fetched only once for all of them.
+        std::set<int32_t> indices;
+        for (const auto& coin_pair : coins) {
+            const CNameScript nameOp(coin_pair.second.out.scriptPubKey);
+            const auto it = m_map_script_pub_keys.find(nameOp.getAddress());
+            if (it != m_map_script_pub_keys.end()) {
+                indices.insert(it->second);
+            }
+        }
+
+        FlatSigningProvider master_provider;
+        if (HavePrivateKeys() && !indices.empty()) {
+            master_provider.keys = GetKeys();
+        }
+        for (const int32_t index : indices) {
+            std::unique_ptr<FlatSigningProvider> coin_keys = GetSigningProvider(index, /*include_private=*/true, &master_provider);
+            if (!coin_keys) {
+                continue;
+            }
+            keys->Merge(std::move(*coin_keys));
         }
-        keys->Merge(std::move(*coin_keys));
     }
 
     return ::SignTransaction(tx, keys.get(), coins, {.sighash_type = sighash}, input_errors);
@@ -326,7 +326,9 @@ private:
     // Fetch the SigningProvider for the given script and optionally include private keys
     std::unique_ptr<FlatSigningProvider> GetSigningProvider(const CScript& script, bool include_private = false) const;
     // Fetch the SigningProvider for a given index and optionally include private keys. Called by the above functions.
-    std::unique_ptr<FlatSigningProvider> GetSigningProvider(int32_t index, bool include_private = false) const EXCLUSIVE_LOCKS_REQUIRED(cs_desc_man);
+    // If master_provider is given, it holds the wallet's keys to expand the private keys from (so that they need not
+    // be fetched again for each index).
+    std::unique_ptr<FlatSigningProvider> GetSigningProvider(int32_t index, bool include_private = false, const FlatSigningProvider* master_provider = nullptr) const EXCLUSIVE_LOCKS_REQUIRED(cs_desc_man);
 
     void Load();
 
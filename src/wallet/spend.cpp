@@ -349,12 +349,14 @@ CoinsResult AvailableCoins(const CWallet& wallet,
     std::set<Txid> trusted_parents;
     // Cache for whether each tx passes the tx level checks (first bool), and whether the transaction is "safe" (second bool)
     std::unordered_map<Txid, std::pair<bool, bool>, SaltedTxidHasher> tx_safe_cache;
-    for (const auto& [outpoint, txo] : wallet.GetTXOs()) {
-        const CWalletTx& wtx = txo.GetWalletTx();
-        const CTxOut& output = txo.GetTxOut();
+    // Checks a single output and adds it to the result. Returns true once
+    // enough coins have been found and the search can stop.
+    const auto add_coin = [&](const COutPoint& outpoint, const WalletTXO* txo) {
+        const CWalletTx& wtx = txo->GetWalletTx();
+        const CTxOut& output = txo->GetTxOut();
 
         if (tx_safe_cache.contains(outpoint.hash) && !tx_safe_cache.at(outpoint.hash).first) {
-            continue;
+            return false;
         }
 
         int nDepth = wallet.GetTxDepthInMainChain(wtx);
@@ -364,15 +366,15 @@ CoinsResult AvailableCoins(const CWallet& wallet,
             tx_safe_cache[outpoint.hash] = {false, false};
 
             if (wallet.IsTxImmatureCoinBase(wtx) && !params.include_immature_coinbase)
-                continue;
+                return false;
 
             if (nDepth < 0)
-                continue;
+                return false;
 
             // We should not consider coins which aren't at least in our mempool
             // It's possible for these to be conflicted via ancestors which we may never be able to detect
             if (nDepth == 0 && !wtx.InMempool())
-                continue;
+                return false;
 
             bool safeTx = CachedTxIsTrusted(wallet, wtx, trusted_parents);
 
@@ -409,49 +411,49 @@ CoinsResult AvailableCoins(const CWallet& wallet,
 
             if (nDepth == 0 && params.check_version_trucness) {
                 if (coinControl->m_version == TRUC_VERSION) {
-                    if (wtx.GetTx()->version != TRUC_VERSION) continue;
+                    if (wtx.GetTx()->version != TRUC_VERSION) return false;
                     // this unconfirmed v3 transaction already has a child
-                    if (wtx.truc_child_in_mempool.has_value()) continue;
+                    if (wtx.truc_child_in_mempool.has_value()) return false;
 
                     // this unconfirmed v3 transaction has a parent: spending would create a third generation
                     size_t ancestors, unused_cluster_count;
                     wallet.chain().getTransactionAncestry(wtx.GetTx()->GetHash(), ancestors, unused_cluster_count);
-                    if (ancestors > 1) continue;
+                    if (ancestors > 1) return false;
                 } else {
-                    if (wtx.GetTx()->version == TRUC_VERSION) continue;
+                    if (wtx.GetTx()->version == TRUC_VERSION) return false;
                 }
             }
 
             if (only_safe && !safeTx) {
-                continue;
+                return false;
             }
 
             if (nDepth < min_depth || nDepth > max_depth) {
-                continue;
+                return false;
             }
 
             tx_safe_cache[outpoint.hash] = {true, safeTx};
         }
         const auto& [tx_ok, tx_safe] = tx_safe_cache.at(outpoint.hash);
         if (!Assume(tx_ok)) {
-            continue;
+            return false;
         }
 
         if (output.nValue < params.min_amount || output.nValue > params.max_amount)
-            continue;
+            return false;
 
         // Skip manually selected coins (the caller can fetch them directly)
         if (coinControl && coinControl->HasSelected() && coinControl->IsSelected(outpoint))
-            continue;
+            return false;
 
         if (wallet.IsLockedCoin(outpoint) && params.skip_locked)
-            continue;
+            return false;
 
         if (wallet.IsSpent(outpoint))
-            continue;
+            return false;
 
         if (!allow_used_addresses && wallet.IsSpentKey(output.scriptPubKey)) {
-            continue;
+            return false;
         }
 
         bool tx_from_me = CachedTxIsFromMe(wallet, wtx);
@@ -465,15 +467,14 @@ CoinsResult AvailableCoins(const CWallet& wallet,
 
         /* Check if this is a name script, and if so, apply filtering
            based on the relevant user options.  */
-        const CNameScript nameOp(txo.GetTxOut().scriptPubKey);
-        if (nameOp.isNameOp ()) {
+        if (txo->IsNameOutput ()) {
             if (params.name_max_depth < 0)
-                continue;
+                return false;
 
             /* name_new's don't expire, but all other outputs become
                unspendable if too deep in the chain.  */
-            if (nameOp.isAnyUpdate () && nDepth > params.name_max_depth)
-                continue;
+            if (txo->IsNameUpdate () && nDepth > params.name_max_depth)
+                return false;
         }
 
         // Obtain script type
@@ -487,7 +488,7 @@ CoinsResult AvailableCoins(const CWallet& wallet,
         bool is_from_p2sh{false};
         if (type == TxoutType::SCRIPTHASH && solvable) {
             CScript script;
-            if (!provider->GetCScript(CScriptID(uint160(script_solutions[0])), script)) continue;
+            if (!provider->GetCScript(CScriptID(uint160(script_solutions[0])), script)) return false;
             type = Solver(script, script_solutions);
             is_from_p2sh = true;
         }
@@ -507,13 +508,26 @@ CoinsResult AvailableCoins(const CWallet& wallet,
         // Checks the sum amount of all UTXO's.
         if (params.min_sum_amount != MAX_MONEY) {
             if (result.GetTotalAmount() >= params.min_sum_amount) {
-                return result;
+                return true;
             }
         }
 
         // Checks the maximum number of UTXO's.
         if (params.max_count > 0 && result.Size() >= params.max_count) {
-            return result;
+            return true;
+        }
+
+        return false;
+    };
+
+    for (const auto& [outpoint, txo] : wallet.GetUnspentTXOs()) {
+        if (add_coin(outpoint, txo)) return result;
+    }
+    // Name outputs are kept apart from the other coins, so that ordinary
+    // selection does not have to look at (and skip) them at all.
+    if (params.name_max_depth >= 0) {
+        for (const auto& [outpoint, txo] : wallet.GetUnspentNameTXOs()) {
+            if (add_coin(outpoint, txo)) return result;
         }
     }
 
@@ -20,6 +20,7 @@
 
 #include <cstdint>
 #include <optional>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -423,6 +424,12 @@ void SQLiteBatch::Close()
     if (m_txn) {
         if (TxnAbort()) {
             LogWarning("SQLiteBatch: Batch closed unexpectedly without the transaction being explicitly committed or aborted");
+        } else if (m_savepoint) {
+            // The outer transaction is still ongoing, so we cannot reset the connection.  The changes of the
+            // savepoint will be committed or rolled back together with it.
+            m_txn = false;
+            m_savepoint = false;
+            LogWarning("SQLiteBatch: Batch closed and failed to roll back its savepoint");
         } else {
             // If transaction cannot be aborted, it means there is a bug or there has been data corruption. Try to recover in this case
             // by closing and reopening the database. Closing the database should also ensure that any changes made since the transaction
@@ -458,6 +465,7 @@ void SQLiteBatch::Close()
         try {
             m_database.Open();
             // If TxnAbort failed and we refreshed the connection, the semaphore was not released, so release it here to avoid deadlocks on future writes.
+            m_database.m_txn_owner = std::thread::id{};
             m_database.m_write_semaphore.release();
         } catch (const std::runtime_error&) {
             // If open fails, cleanup this object and rethrow the exception
@@ -511,7 +519,8 @@ bool SQLiteBatch::WriteKey(DataStream&& key, DataStream&& value, bool overwrite)
     if (!BindBlobToStatement(stmt, 2, value, "value")) return false;
 
     // Acquire semaphore if not previously acquired when creating a transaction.
-    if (!m_txn) m_database.m_write_semaphore.acquire();
+    const bool acquire_semaphore{NeedsWriteSemaphore()};
+    if (acquire_semaphore) m_database.m_write_semaphore.acquire();
 
     // Execute
     int res = sqlite3_step(stmt);
@@ -521,7 +530,7 @@ bool SQLiteBatch::WriteKey(DataStream&& key, DataStream&& value, bool overwrite)
         LogWarning("Unable to execute write statement: %s", sqlite3_errstr(res));
     }
 
-    if (!m_txn) m_database.m_write_semaphore.release();
+    if (acquire_semaphore) m_database.m_write_semaphore.release();
 
     return res == SQLITE_DONE;
 }
@@ -535,7 +544,8 @@ bool SQLiteBatch::ExecStatement(sqlite3_stmt* stmt, std::span<const std::byte> b
     if (!BindBlobToStatement(stmt, 1, blob, "key")) return false;
 
     // Acquire semaphore if not previously acquired when creating a transaction.
-    if (!m_txn) m_database.m_write_semaphore.acquire();
+    const bool acquire_semaphore{NeedsWriteSemaphore()};
+    if (acquire_semaphore) m_database.m_write_semaphore.acquire();
 
     // Execute
     int res = sqlite3_step(stmt);
@@ -545,7 +555,7 @@ bool SQLiteBatch::ExecStatement(sqlite3_stmt* stmt, std::span<const std::byte> b
         LogWarning("Unable to execute exec statement: %s", sqlite3_errstr(res));
     }
 
-    if (!m_txn) m_database.m_write_semaphore.release();
+    if (acquire_semaphore) m_database.m_write_semaphore.release();
 
     return res == SQLITE_DONE;
 }
@@ -661,9 +671,27 @@ std::unique_ptr<DatabaseCursor> SQLiteBatch::GetNewPrefixCursor(std::span<const
     return cursor;
 }
 
+bool SQLiteBatch::NeedsWriteSemaphore() const
+{
+    return !m_txn && !m_database.IsTxnOwner();
+}
+
 bool SQLiteBatch::TxnBegin()
 {
     if (!m_database.m_db || m_txn) return false;
+    if (m_database.IsTxnOwner()) {
+        // Another batch on this thread holds the semaphore for its transaction,
+        // so nest ours into it.
+        Assert(m_database.HasActiveTxn());
+        int res = Assert(m_exec_handler)->Exec(m_database, "SAVEPOINT wallet_batch");
+        if (res != SQLITE_OK) {
+            LogWarning("SQLiteBatch: Failed to begin the nested transaction");
+        } else {
+            m_txn = true;
+            m_savepoint = true;
+        }
+        return res == SQLITE_OK;
+    }
     m_database.m_write_semaphore.acquire();
     Assert(!m_database.HasActiveTxn());
     int res = Assert(m_exec_handler)->Exec(m_database, "BEGIN TRANSACTION");
@@ -672,6 +700,7 @@ bool SQLiteBatch::TxnBegin()
         m_database.m_write_semaphore.release();
     } else {
         m_txn = true;
+        m_database.m_txn_owner = std::this_thread::get_id();
     }
     return res == SQLITE_OK;
 }
@@ -680,11 +709,22 @@ bool SQLiteBatch::TxnCommit()
 {
     if (!m_database.m_db || !m_txn) return false;
     Assert(m_database.HasActiveTxn());
+    if (m_savepoint) {
+        int res = Assert(m_exec_handler)->Exec(m_database, "RELEASE SAVEPOINT wallet_batch");
+        if (res != SQLITE_OK) {
+            LogWarning("SQLiteBatch: Failed to commit the nested transaction");
+        } else {
+            m_txn = false;
+            m_savepoint = false;
+        }
+        return res == SQLITE_OK;
+    }
     int res = Assert(m_exec_handler)->Exec(m_database, "COMMIT TRANSACTION");
     if (res != SQLITE_OK) {
         LogWarning("SQLiteBatch: Failed to commit the transaction");
     } else {
         m_txn = false;
+        m_database.m_txn_owner = std::thread::id{};
         m_database.m_write_semaphore.release();
     }
     return res == SQLITE_OK;
@@ -694,11 +734,25 @@ bool SQLiteBatch::TxnAbort()
 {
     if (!m_database.m_db || !m_txn) return false;
     Assert(m_database.HasActiveTxn());
+    if (m_savepoint) {
+        // Rolling back to a savepoint keeps it open, so it has to be released
+        // afterwards as well.
+        int res = Assert(m_exec_handler)->Exec(m_database, "ROLLBACK TO SAVEPOINT wallet_batch");
+        if (res == SQLITE_OK) res = Assert(m_exec_handler)->Exec(m_database, "RELEASE SAVEPOINT wallet_batch");
+        if (res != SQLITE_OK) {
+            LogWarning("SQLiteBatch: Failed to abort the nested transaction");
+        } else {
+            m_txn = false;
+            m_savepoint = false;
+        }
+        return res == SQLITE_OK;
+    }
     int res = Assert(m_exec_handler)->Exec(m_database, "ROLLBACK TRANSACTION");
     if (res != SQLITE_OK) {
         LogWarning("SQLiteBatch: Failed to abort the transaction");
     } else {
         m_txn = false;
+        m_database.m_txn_owner = std::thread::id{};
         m_database.m_write_semaphore.release();
     }
     return res == SQLITE_OK;
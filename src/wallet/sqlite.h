@@ -8,7 +8,9 @@
 #include <sync.h>
 #include <wallet/db.h>
 
+#include <atomic>
 #include <semaphore>
+#include <thread>
 
 struct bilingual_str;
 
@@ -72,6 +74,17 @@ private:
      */
     bool m_txn{false};
 
+    /** Whether the transaction of this batch is a savepoint nested into the transaction of another batch
+     * on the same thread (see SQLiteDatabase::m_txn_owner).  In that case, the semaphore belongs to the
+     * outer transaction and committing only merges the changes into it.
+     */
+    bool m_savepoint{false};
+
+    /** Whether a write must acquire m_write_semaphore, i.e. it is neither part of a transaction of this
+     * batch nor of one started by another batch on the same thread.
+     */
+    bool NeedsWriteSemaphore() const;
+
     void SetupSQLStatements();
     bool ExecStatement(sqlite3_stmt* stmt, std::span<const std::byte> blob);
 
@@ -139,6 +152,15 @@ public:
     // This ensures that only one batch is modifying the database at a time.
     std::binary_semaphore m_write_semaphore;
 
+    /** The thread whose batch currently holds m_write_semaphore for a transaction, or a default id if there
+     * is none.  Other batches used on that thread write as part of this transaction and start their own
+     * ones as savepoints within it, so that e.g. all writes while connecting a block are committed at once.
+     * Waiting for the semaphore on that thread would deadlock instead.
+     */
+    std::atomic<std::thread::id> m_txn_owner{};
+
+    bool IsTxnOwner() const { return m_txn_owner.load() == std::this_thread::get_id(); }
+
     bool Verify(bilingual_str& error);
 
     /** Open the database if it is not already opened */
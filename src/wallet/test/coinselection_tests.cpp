@@ -9,6 +9,8 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <set>
+
 namespace wallet {
 BOOST_FIXTURE_TEST_SUITE(coinselection_tests, TestingSetup)
 
@@ -318,5 +320,52 @@ BOOST_AUTO_TEST_CASE(srd_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(name_batch_test)
+{
+    std::vector<OutputGroup> utxo_pool;
+    const auto empty = SelectNameBatchCoins(utxo_pool, {10'000, 20'000}, /*cost_of_change=*/0);
+    BOOST_REQUIRE_EQUAL(empty.size(), 2U);
+    BOOST_CHECK(!empty[0] && !empty[1]);
+
+    AddCoins(utxo_pool, {5 * CENT, 15'000, 1 * CENT, 30'000, 21'000});
+
+    // The largest target is served first and takes the closest coin above it, so that the
+    // smaller targets do not use it up.  The change is minimal for every transaction.
+    const std::vector<CAmount> targets{12'000, 20'000, 29'000, 14'000};
+    const auto results = SelectNameBatchCoins(utxo_pool, targets, /*cost_of_change=*/0);
+    BOOST_REQUIRE_EQUAL(results.size(), targets.size());
+    const std::vector<CAmount> expected{1 * CENT, 21'000, 30'000, 15'000};
+    for (size_t i = 0; i < targets.size(); ++i) {
+        BOOST_REQUIRE(results[i]);
+        BOOST_CHECK(results[i]->GetAlgo() == SelectionAlgorithm::NAME_BATCH);
+        BOOST_CHECK_EQUAL(results[i]->GetTarget(), targets[i]);
+        BOOST_REQUIRE_EQUAL(results[i]->GetInputSet().size(), 1U);
+        BOOST_CHECK_EQUAL(results[i]->GetSelectedEffectiveValue(), expected[i]);
+    }
+
+    // Every group is used at most once, and targets above all remaining groups are left
+    // for the normal coin selection.
+    const auto partial = SelectNameBatchCoins(utxo_pool, {40'000, 40'000, 10 * CENT}, /*cost_of_change=*/0);
+    BOOST_REQUIRE_EQUAL(partial.size(), 3U);
+    BOOST_REQUIRE(partial[0] && partial[1]);
+    BOOST_CHECK(!partial[2]);
+    const std::set<CAmount> selected{partial[0]->GetSelectedEffectiveValue(), partial[1]->GetSelectedEffectiveValue()};
+    BOOST_CHECK(selected == std::set<CAmount>({1 * CENT, 5 * CENT}));
+
+    // A set of groups that matches a target within the cost of change is preferred over a
+    // single larger group, so that the transaction needs no change output.  Its groups are
+    // not used for the other targets.
+    std::vector<OutputGroup> exact_pool;
+    AddCoins(exact_pool, {7'000, 5'100, 40'000, 3'000});
+    const auto exact = SelectNameBatchCoins(exact_pool, {12'000, 10'000}, /*cost_of_change=*/500);
+    BOOST_REQUIRE_EQUAL(exact.size(), 2U);
+    BOOST_REQUIRE(exact[0] && exact[1]);
+    BOOST_CHECK_EQUAL(exact[0]->GetInputSet().size(), 2U);
+    BOOST_CHECK_EQUAL(exact[0]->GetSelectedEffectiveValue(), 12'100);
+    BOOST_CHECK_EQUAL(exact[0]->GetChange(/*min_viable_change=*/500, /*change_fee=*/0), 0);
+    BOOST_REQUIRE_EQUAL(exact[1]->GetInputSet().size(), 1U);
+    BOOST_CHECK_EQUAL(exact[1]->GetSelectedEffectiveValue(), 40'000);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 } // namespace wallet
@@ -19,6 +19,7 @@
 #include <span>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -297,6 +298,58 @@ BOOST_AUTO_TEST_CASE(concurrent_txn_dont_interfere)
     BOOST_CHECK_EQUAL(read_value, value2);
 }
 
+BOOST_AUTO_TEST_CASE(nested_txn_same_thread)
+{
+    DatabaseOptions options;
+    DatabaseStatus status;
+    bilingual_str error;
+    const auto& database = MakeSQLiteDatabase(m_path_root / "sqlite", options, status, error);
+
+    std::unique_ptr<DatabaseBatch> outer = Assert(database)->MakeBatch();
+    std::unique_ptr<DatabaseBatch> plain = Assert(database)->MakeBatch();
+    std::unique_ptr<DatabaseBatch> nested = Assert(database)->MakeBatch();
+
+    // While the outer batch has a txn, other batches on the same thread write
+    // as part of it (instead of waiting for it forever), and their own txns
+    // are nested into it.
+    BOOST_CHECK(outer->TxnBegin());
+    BOOST_CHECK(plain->Write(std::string{"plain"}, std::string{"value"}));
+    BOOST_CHECK(nested->TxnBegin());
+    BOOST_CHECK(nested->Write(std::string{"committed"}, std::string{"value"}));
+    BOOST_CHECK(nested->TxnCommit());
+    BOOST_CHECK(nested->TxnBegin());
+    BOOST_CHECK(nested->Write(std::string{"aborted"}, std::string{"value"}));
+    BOOST_CHECK(nested->TxnAbort());
+    BOOST_CHECK(!nested->TxnCommit());
+    BOOST_CHECK(database->HasActiveTxn());
+
+    BOOST_CHECK(outer->Exists(std::string{"plain"}));
+    BOOST_CHECK(outer->Exists(std::string{"committed"}));
+    BOOST_CHECK(!outer->Exists(std::string{"aborted"}));
+
+    // Aborting the outer txn discards everything.
+    BOOST_CHECK(outer->TxnAbort());
+    BOOST_CHECK(!database->HasActiveTxn());
+    BOOST_CHECK(!plain->Exists(std::string{"plain"}));
+    BOOST_CHECK(!plain->Exists(std::string{"committed"}));
+
+    // The same with a commit, and the semaphore is released for other threads.
+    BOOST_CHECK(outer->TxnBegin());
+    BOOST_CHECK(nested->TxnBegin());
+    BOOST_CHECK(nested->Write(std::string{"committed"}, std::string{"value"}));
+    BOOST_CHECK(nested->TxnCommit());
+    BOOST_CHECK(outer->TxnCommit());
+    std::thread other{[&] {
+        std::unique_ptr<DatabaseBatch> batch = database->MakeBatch();
+        BOOST_CHECK(batch->Exists(std::string{"committed"}));
+        BOOST_CHECK(batch->TxnBegin());
+        BOOST_CHECK(batch->Write(std::string{"other"}, std::string{"value"}));
+        BOOST_CHECK(batch->TxnCommit());
+    }};
+    other.join();
+    BOOST_CHECK(plain->Exists(std::string{"other"}));
+}
+
 BOOST_AUTO_TEST_CASE(in_memory_database_cannot_reopen)
 {
     // Reopening an in-memory database would create a fresh empty connection,
@@ -6,11 +6,14 @@
 
 #include <cstdint>
 #include <future>
+#include <limits>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include <addresstype.h>
 #include <interfaces/chain.h>
+#include <kernel/types.h>
 #include <key_io.h>
 #include <node/blockstorage.h>
 #include <node/types.h>
@@ -749,15 +752,76 @@ BOOST_FIXTURE_TEST_CASE(RemoveTxs, TestChain100Setup)
         BOOST_CHECK(wallet->HasWalletSpend(prev_tx));
         BOOST_CHECK(wallet->mapWallet.contains(block_hash));
 
+        const COutPoint block_outpoint{block_hash, 0};
+        BOOST_CHECK(wallet->GetUnspentTXOs().contains(block_outpoint));
+
         std::vector<Txid> vHashIn{ block_hash };
         BOOST_CHECK(wallet->RemoveTxs(vHashIn));
 
         BOOST_CHECK(!wallet->HasWalletSpend(prev_tx));
         BOOST_CHECK(!wallet->mapWallet.contains(block_hash));
+        BOOST_CHECK(!wallet->GetUnspentTXOs().contains(block_outpoint));
     }
 
     TestUnloadWallet(std::move(wallet));
 }
 
+BOOST_FIXTURE_TEST_CASE(block_connected_batch, TestingSetup)
+{
+    m_args.ForceSetArg("-unsafesqlitesync", "1");
+    WalletContext context;
+    context.args = &m_args;
+    context.chain = m_node.chain.get();
+    auto wallet = TestCreateWallet(context);
+
+    std::vector<std::pair<Txid, ChangeType>> notifications;
+    btcsignals::scoped_connection conn{wallet->NotifyTransactionChanged.connect([&](const Txid& hash, ChangeType status) {
+        notifications.emplace_back(hash, status);
+    })};
+
+    CBlock block;
+    const CScript other_script{CScript() << OP_TRUE};
+    const auto add_tx{[&](const COutPoint& prevout, const CScript& script) {
+        CMutableTransaction mtx;
+        mtx.vin.emplace_back(prevout);
+        mtx.vout.emplace_back(COIN, script);
+        block.vtx.push_back(MakeTransactionRef(mtx));
+        return block.vtx.back()->GetHash();
+    }};
+
+    // The transaction spending the wallet's output is only relevant once the
+    // one paying to the wallet is applied, as both are in the same block.
+    // The other transactions do not touch the wallet.
+    for (int i = 0; i < 300; ++i) add_tx(COutPoint{Txid::FromUint256(m_rng.rand256()), 0}, other_script);
+    CScript wallet_script;
+    {
+        LOCK(wallet->cs_wallet);
+        wallet_script = GetScriptForDestination(*Assert(wallet->GetNewDestination(OutputType::BECH32, "")));
+    }
+    const Txid receive_txid{add_tx(COutPoint{Txid::FromUint256(m_rng.rand256()), 0}, wallet_script)};
+    for (int i = 0; i < 300; ++i) add_tx(COutPoint{Txid::FromUint256(m_rng.rand256()), 0}, other_script);
+    const Txid spend_txid{add_tx(COutPoint{receive_txid, 0}, other_script)};
+
+    interfaces::BlockInfo info{m_rng.rand256()};
+    info.height = 1;
+    info.data = &block;
+    info.chain_time_max = std::numeric_limits<unsigned int>::max();
+    wallet->blockConnected(kernel::ChainstateRole{}, info);
+
+    {
+        LOCK(wallet->cs_wallet);
+        BOOST_CHECK_EQUAL(wallet->mapWallet.size(), 2U);
+        BOOST_CHECK(wallet->mapWallet.contains(receive_txid));
+        BOOST_CHECK(wallet->mapWallet.contains(spend_txid));
+        BOOST_CHECK(wallet->GetUnspentTXOs().empty());
+    }
+
+    // Each transaction is notified once, in block order.
+    const std::vector<std::pair<Txid, ChangeType>> expected{{receive_txid, CT_NEW}, {spend_txid, CT_NEW}};
+    BOOST_CHECK(notifications == expected);
+
+    TestUnloadWallet(std::move(wallet));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 } // namespace wallet
@@ -92,5 +92,57 @@ BOOST_FIXTURE_TEST_CASE(wallet_load_descriptors, TestingSetup)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(wallet_load_witness_variants, TestingSetup)
+{
+    bilingual_str _error;
+    std::vector<bilingual_str> _warnings;
+    std::unique_ptr<WalletDatabase> database = CreateMockableWalletDatabase();
+
+    // Two transactions, the first with an additional witness variant
+    CMutableTransaction mtx_a;
+    mtx_a.vin.emplace_back(COutPoint{Txid::FromUint256(uint256::ONE), 0});
+    mtx_a.vin[0].scriptWitness.stack = {{1}};
+    mtx_a.vout.emplace_back(COIN, CScript() << OP_TRUE);
+    CMutableTransaction mtx_a2{mtx_a};
+    mtx_a2.vin[0].scriptWitness.stack = {{2, 2}};
+    CMutableTransaction mtx_b{mtx_a};
+    mtx_b.vin[0].prevout.n = 1;
+
+    const CTransactionRef tx_a{MakeTransactionRef(mtx_a)};
+    const CTransactionRef tx_a2{MakeTransactionRef(mtx_a2)};
+    const CTransactionRef tx_b{MakeTransactionRef(mtx_b)};
+    BOOST_REQUIRE_EQUAL(tx_a->GetHash(), tx_a2->GetHash());
+    {
+        WalletBatch batch(*database);
+        BOOST_CHECK(batch.WriteTx(CWalletTx{tx_a, TxStateInactive{}}));
+        BOOST_CHECK(batch.WriteWtxVariant(tx_a->GetHash(), tx_a2));
+        BOOST_CHECK(batch.WriteTx(CWalletTx{tx_b, TxStateInactive{}}));
+    }
+
+    {
+        const std::shared_ptr<CWallet> wallet(new CWallet(m_node.chain.get(), "", std::move(database)));
+        BOOST_CHECK_EQUAL(wallet->PopulateWalletFromDB(_error, _warnings), DBErrors::LOAD_OK);
+        LOCK(wallet->cs_wallet);
+        BOOST_REQUIRE_EQUAL(wallet->mapWallet.size(), 2U);
+        const auto& txs_a{wallet->mapWallet.at(tx_a->GetHash()).GetTxs()};
+        BOOST_CHECK_EQUAL(txs_a.size(), 2U);
+        BOOST_CHECK(txs_a.contains(tx_a->GetWitnessHash()));
+        BOOST_CHECK(txs_a.contains(tx_a2->GetWitnessHash()));
+        BOOST_CHECK_EQUAL(wallet->mapWallet.at(tx_b->GetHash()).GetTxs().size(), 1U);
+    }
+
+    // A variant stored under the wrong txid is corrupt.
+    database = CreateMockableWalletDatabase();
+    {
+        WalletBatch batch(*database);
+        BOOST_CHECK(batch.WriteTx(CWalletTx{tx_a, TxStateInactive{}}));
+        BOOST_CHECK(batch.WriteWtxVariant(tx_a->GetHash(), tx_b));
+    }
+    {
+        const std::shared_ptr<CWallet> wallet(new CWallet(m_node.chain.get(), "", std::move(database)));
+        BOOST_CHECK_EQUAL(wallet->PopulateWalletFromDB(_error, _warnings), DBErrors::CORRUPT);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 } // namespace wallet
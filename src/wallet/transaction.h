@@ -8,6 +8,8 @@
 #include <attributes.h>
 #include <consensus/amount.h>
 #include <primitives/transaction.h>
+#include <script/names.h>
+#include <script/script.h>
 #include <tinyformat.h>
 #include <uint256.h>
 #include <util/check.h>
@@ -437,17 +439,28 @@ private:
     const CWalletTx& m_wtx;
     const CTxOut& m_output;
 
+    /** The name operation of the output, or OP_NOP if it is not a name output.
+     *  Balances and coin selection check this for every output, so the script
+     *  is parsed only once here. */
+    opcodetype m_name_op;
+
 public:
     WalletTXO(const CWalletTx& wtx, const CTxOut& output)
     : m_wtx(wtx),
     m_output(output)
     {
         Assume(std::ranges::find(wtx.GetTx()->vout, output) != wtx.GetTx()->vout.end());
+        const CNameScript nameOp(output.scriptPubKey);
+        m_name_op = nameOp.isNameOp() ? nameOp.getNameOp() : OP_NOP;
     }
 
     const CWalletTx& GetWalletTx() const { return m_wtx; }
 
     const CTxOut& GetTxOut() const { return m_output; }
+
+    bool IsNameOutput() const { return m_name_op != OP_NOP; }
+    /** Whether this is a name_firstupdate or name_update (but not name_new) output. */
+    bool IsNameUpdate() const { return m_name_op == OP_NAME_FIRSTUPDATE || m_name_op == OP_NAME_UPDATE; }
 };
 } // namespace wallet
 
@@ -20,6 +20,7 @@
 #include <consensus/consensus.h>
 #include <consensus/validation.h>
 #include <external_signer.h>
+#include <hash.h>
 #include <interfaces/chain.h>
 #include <interfaces/handler.h>
 #include <interfaces/wallet.h>
@@ -28,6 +29,7 @@
 #include <key.h>
 #include <key_io.h>
 #include <names/encoding.h>
+#include <names/main.h>
 #include <node/types.h>
 #include <outputtype.h>
 #include <policy/feerate.h>
@@ -61,6 +63,7 @@
 #include <util/moneystr.h>
 #include <util/result.h>
 #include <util/string.h>
+#include <util/threadpool.h>
 #include <util/time.h>
 #include <util/translation.h>
 #include <wallet/coincontrol.h>
@@ -77,11 +80,17 @@
 #include <algorithm>
 #include <cassert>
 #include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <exception>
+#include <future>
+#include <limits>
+#include <memory>
 #include <optional>
 #include <stdexcept>
 #include <thread>
 #include <tuple>
+#include <unordered_set>
 #include <variant>
 
 struct KeyOriginInfo;
@@ -315,10 +324,24 @@ std::shared_ptr<CWallet> LoadWalletInternal(WalletContext& context, const std::s
     }
 }
 
+/**
+ * Returns the filter type to use for fast rescans, if any index is available.
+ * The NAMES filter is preferred.  The BASIC filter does not contain the
+ * addresses of name outputs, so with it, names sent to the wallet in blocks
+ * without any other wallet outputs are not found.
+ */
+static std::optional<BlockFilterType> GetRescanFilterType(interfaces::Chain& chain)
+{
+    for (const auto filter_type : {BlockFilterType::NAMES, BlockFilterType::BASIC}) {
+        if (chain.hasBlockFilterIndex(filter_type)) return filter_type;
+    }
+    return std::nullopt;
+}
+
 class FastWalletRescanFilter
 {
 public:
-    FastWalletRescanFilter(const CWallet& wallet) : m_wallet(wallet)
+    FastWalletRescanFilter(const CWallet& wallet, BlockFilterType filter_type) : m_wallet(wallet), m_filter_type(filter_type)
     {
         // create initial filter with scripts from all ScriptPubKeyMans
         for (auto spkm : m_wallet.GetAllScriptPubKeyMans()) {
@@ -332,27 +355,42 @@ public:
         }
     }
 
-    void UpdateIfNeeded()
+    /** Returns true if the filter set has changed.  */
+    bool UpdateIfNeeded()
     {
+        bool updated{false};
         // repopulate filter with new scripts if top-up has happened since last iteration
         for (const auto& [desc_spkm_id, last_range_end] : m_last_range_ends) {
             auto desc_spkm{dynamic_cast<DescriptorScriptPubKeyMan*>(m_wallet.GetScriptPubKeyMan(desc_spkm_id))};
             assert(desc_spkm != nullptr);
             int32_t current_range_end{desc_spkm->GetEndRange()};
             if (current_range_end > last_range_end) {
+                if (!updated) {
+                    // Blocks may still be matched against the current set on the
+                    // read-ahead threads, so the new one is a copy.
+                    m_filter_set = std::make_shared<GCSFilter::ElementSet>(*m_filter_set);
+                    updated = true;
+                }
                 AddScriptPubKeys(desc_spkm, last_range_end);
                 m_last_range_ends.at(desc_spkm->GetID()) = current_range_end;
             }
         }
+        return updated;
     }
 
     std::optional<bool> MatchesBlock(const uint256& block_hash) const
     {
-        return m_wallet.chain().blockFilterMatchesAny(BlockFilterType::BASIC, block_hash, m_filter_set);
+        return m_wallet.chain().blockFilterMatchesAny(m_filter_type, block_hash, *m_filter_set);
     }
 
+    BlockFilterType GetFilterType() const { return m_filter_type; }
+
+    /** Returns the current filter set, which stays valid after updates.  */
+    std::shared_ptr<const GCSFilter::ElementSet> GetFilterSet() const { return m_filter_set; }
+
 private:
     const CWallet& m_wallet;
+    const BlockFilterType m_filter_type;
     /** Map for keeping track of each range descriptor's last seen end range.
       * This information is used to detect whether new addresses were derived
       * (that is, if the current end range is larger than the saved end range)
@@ -360,15 +398,32 @@ private:
       * take possible keypool top-ups into account.
       */
     std::map<uint256, int32_t> m_last_range_ends;
-    GCSFilter::ElementSet m_filter_set;
+    std::shared_ptr<GCSFilter::ElementSet> m_filter_set{std::make_shared<GCSFilter::ElementSet>()};
 
     void AddScriptPubKeys(const DescriptorScriptPubKeyMan* desc_spkm, int32_t last_range_end = 0)
     {
         for (const auto& script_pub_key : desc_spkm->GetScriptPubKeys(last_range_end)) {
-            m_filter_set.emplace(script_pub_key.begin(), script_pub_key.end());
+            m_filter_set->emplace(script_pub_key.begin(), script_pub_key.end());
         }
     }
 };
+
+/** Number of blocks each rescan worker thread may check and read ahead.  */
+constexpr size_t RESCAN_READ_AHEAD_PER_THREAD{16};
+
+/** Minimum number of transactions in a connected block to match them on threads.  */
+constexpr size_t PARALLEL_MATCH_MIN_TXS{512};
+/** Maximum number of threads matching the transactions of a connected block.  */
+constexpr int MAX_MATCH_THREADS{8};
+
+/** A block checked and read ahead of the rescan on a worker thread.  */
+struct RescanBlockAhead {
+    uint256 hash;
+    /** Result of the block filter match, if the rescan uses filters.  */
+    std::optional<bool> filter_match;
+    /** The block data, unless the filter did not match.  */
+    CBlock block;
+};
 } // namespace
 
 std::shared_ptr<CWallet> LoadWallet(WalletContext& context, const std::string& name, std::optional<bool> load_on_start, const DatabaseOptions& options, DatabaseStatus& status, bilingual_str& error, std::vector<bilingual_str>& warnings)
@@ -813,6 +868,7 @@ CWallet::SpendType CWallet::HowSpent(const COutPoint& outpoint) const
 void CWallet::AddToSpends(const COutPoint& outpoint, const Txid& txid)
 {
     mapTxSpends.insert(std::make_pair(outpoint, txid));
+    UpdateUnspentTXO(outpoint);
 
     UnlockCoin(outpoint);
 
@@ -1079,6 +1135,7 @@ CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const TxState& state, const
         wtx.m_it_wtxOrdered = wtxOrdered.insert(std::make_pair(wtx.nOrderPos, &wtx));
         wtx.nTimeSmart = ComputeTimeSmart(wtx, rescanning_old_block);
         AddToSpends(wtx);
+        PruneNameNews(*tx);
 
         // Update birth time when tx time is older than it.
         MaybeUpdateBirthTime(wtx.GetTxTime());
@@ -1087,6 +1144,11 @@ CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const TxState& state, const
     if (!fInsertedNew)
     {
         fUpdated |= wtx.Update(tx, state);
+        if (fUpdated) {
+            for (const CTxIn& txin : tx->vin) {
+                UpdateUnspentTXO(txin.prevout);
+            }
+        }
     }
 
     // Mark inactive coinbase transactions and their descendants as abandoned
@@ -1135,7 +1197,7 @@ CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const TxState& state, const
     RefreshTXOsFromTx(wtx);
 
     // Notify UI of new or updated transaction
-    NotifyTransactionChanged(hash, fInsertedNew ? CT_NEW : CT_UPDATED);
+    NotifyTxChanged(hash, fInsertedNew ? CT_NEW : CT_UPDATED);
 
 #if HAVE_SYSTEM
     // notify an external script when a wallet transaction comes in or is updated
@@ -1297,6 +1359,7 @@ void CWallet::MarkInputsDirty(const CTransactionRef& tx)
         if (it != mapWallet.end()) {
             it->second.MarkDirty();
         }
+        UpdateUnspentTXO(txin.prevout);
     }
 }
 
@@ -1402,7 +1465,7 @@ void CWallet::RecursiveUpdateTxState(WalletBatch* batch, const Txid& tx_hash, co
             }
 
             if (update_state == TxUpdate::NOTIFY_CHANGED) {
-                NotifyTransactionChanged(wtx.GetHash(), CT_UPDATED);
+                NotifyTxChanged(wtx.GetHash(), CT_UPDATED);
             }
 
             // If a transaction changes its tx state, that usually changes the balance
@@ -1542,6 +1605,7 @@ void CWallet::blockConnected(const ChainstateRole& role, const interfaces::Block
         return;
     }
     assert(block.data);
+    EffectTransactionQueue(block.height);
     LOCK(cs_wallet);
 
     // Update the best block in memory first. This will set the best block's height, which is
@@ -1552,18 +1616,127 @@ void CWallet::blockConnected(const ChainstateRole& role, const interfaces::Block
     // Uses chain max time and twice the grace period to adjust time for block time variability.
     if (block.chain_time_max < m_birth_time.load() - (TIMESTAMP_WINDOW * 2)) return;
 
-    // Scan block
+    // All the writes while processing the block (transactions, key pool
+    // top-ups and the best block) go to the database in one transaction.
+    // The UI is notified of the changed transactions once they are written.
+    WalletBatch batch(GetDatabase());
+    const bool in_txn{batch.TxnBegin()};
+    m_pending_tx_notifications.emplace();
+    m_block_new_spks.emplace();
+    const auto end_block{[&]() EXCLUSIVE_LOCKS_REQUIRED(cs_wallet) {
+        m_block_new_spks.reset();
+        const auto notifications{std::move(*m_pending_tx_notifications)};
+        m_pending_tx_notifications.reset();
+        std::unordered_set<Txid, SaltedTxidHasher> notified;
+        for (const auto& [hash, status] : notifications) {
+            if (notified.insert(hash).second) NotifyTransactionChanged(hash, status);
+        }
+    }};
+
+    // Match all transactions of the block first, and only sync those that may be
+    // relevant.  A transaction may also become relevant by spending an output of
+    // one synced before it, or by paying to a script added by a key pool top-up
+    // in the meantime, so the others are checked for these while applying.
+    const auto& txs{block.data->vtx};
+    const std::vector<uint8_t> matches{MatchBlockTransactions(txs)};
+    bool any_synced{false};
+    const auto became_relevant{[&](const CTransaction& tx) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet) {
+        if (any_synced && std::any_of(tx.vin.begin(), tx.vin.end(), [&](const CTxIn& txin) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet) {
+                return mapWallet.contains(txin.prevout.hash);
+            })) {
+            return true;
+        }
+        return !m_block_new_spks->empty() && std::any_of(tx.vout.begin(), tx.vout.end(), [&](const CTxOut& txout) {
+            return m_block_new_spks->contains(CNameScript(txout.scriptPubKey).getAddress());
+        });
+    }};
     bool wallet_updated = false;
-    for (size_t index = 0; index < block.data->vtx.size(); index++) {
-        wallet_updated |= SyncTransaction(block.data->vtx[index], TxStateConfirmed{block.hash, block.height, static_cast<int>(index)});
-        transactionRemovedFromMempool(block.data->vtx[index], MemPoolRemovalReason::BLOCK);
+    try {
+        for (size_t index = 0; index < txs.size(); index++) {
+            const CTransactionRef& tx{txs[index]};
+            if (!matches[index] && !became_relevant(*tx)) continue;
+            const bool synced{SyncTransaction(tx, TxStateConfirmed{block.hash, block.height, static_cast<int>(index)})};
+            wallet_updated |= synced;
+            any_synced |= synced;
+            transactionRemovedFromMempool(tx, MemPoolRemovalReason::BLOCK);
+        }
+    } catch (...) {
+        end_block();
+        throw;
     }
-    EffectTransactionQueue();
 
     // Update on disk if this block resulted in us updating a tx, or periodically every 144 blocks (~1 day)
     if (wallet_updated || block.height % 144 == 0) {
         WriteBestBlock();
     }
+
+    if (in_txn && !batch.TxnCommit()) {
+        WalletLogPrintf("Failed to commit the wallet changes for block %s\n", block.hash.ToString());
+    }
+    end_block();
+}
+
+bool CWallet::TxMayBeRelevant(const CTransaction& tx) const
+{
+    if (mapWallet.contains(tx.GetHash())) return true;
+    for (const CTxIn& txin : tx.vin) {
+        if (mapWallet.contains(txin.prevout.hash) || mapTxSpends.contains(txin.prevout)) return true;
+    }
+    for (const CTxOut& txout : tx.vout) {
+        if (m_cached_spks.contains(CNameScript(txout.scriptPubKey).getAddress())) return true;
+    }
+    return false;
+}
+
+std::vector<uint8_t> CWallet::MatchBlockTransactions(const std::vector<CTransactionRef>& txs) const
+{
+    AssertLockHeld(cs_wallet);
+    std::vector<uint8_t> matches(txs.size(), false);
+
+    const int max_threads{std::min(GetNumCores(), MAX_MATCH_THREADS)};
+    int num_threads{1};
+    if (txs.size() >= PARALLEL_MATCH_MIN_TXS) {
+        num_threads = std::min<int>(max_threads, txs.size() / (PARALLEL_MATCH_MIN_TXS / 2));
+    }
+    if (num_threads <= 1) {
+        for (size_t i = 0; i < txs.size(); ++i) {
+            matches[i] = TxMayBeRelevant(*txs[i]);
+        }
+        return matches;
+    }
+
+    // The threads only read the wallet, which cannot change while we hold
+    // cs_wallet and wait for them.  The pool is kept for the following
+    // blocks, so that its threads are only created once.
+    if (m_match_pool.WorkersCount() == 0) m_match_pool.Start(max_threads);
+    std::vector<std::future<void>> futures;
+    for (int t = 0; t < num_threads; ++t) {
+        const auto match_txs{[&, t]() EXCLUSIVE_LOCKS_REQUIRED(cs_wallet) {
+            for (size_t i = t; i < txs.size(); i += num_threads) {
+                matches[i] = TxMayBeRelevant(*txs[i]);
+            }
+        }};
+        auto future{m_match_pool.Submit(match_txs)};
+        if (future) {
+            futures.push_back(std::move(*future));
+        } else {
+            match_txs();
+        }
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+    return matches;
+}
+
+void CWallet::NotifyTxChanged(const Txid& hash, ChangeType status)
+{
+    AssertLockHeld(cs_wallet);
+    if (m_pending_tx_notifications) {
+        m_pending_tx_notifications->emplace_back(hash, status);
+    } else {
+        NotifyTransactionChanged(hash, status);
+    }
 }
 
 void CWallet::blockDisconnected(const interfaces::BlockInfo& block)
@@ -1577,6 +1750,12 @@ void CWallet::blockDisconnected(const interfaces::BlockInfo& block)
     // future with a stickier abandoned state or even removing abandontransaction call.
     int disconnect_height = block.height;
 
+    // Queued transactions may become valid earlier on the new chain, e.g. if
+    // their inputs get confirmed at a lower height, so try all of them again.
+    for (auto& [txid, queued] : queuedTransactionMap) {
+        ScheduleQueuedTransaction(txid, queued, 0);
+    }
+
     for (size_t index = 0; index < block.data->vtx.size(); index++) {
         const CTransactionRef& ptx = block.data->vtx[index];
         // Coinbase transactions are not only inactive but also abandoned,
@@ -1916,10 +2095,13 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
     ScanResult result;
 
     std::unique_ptr<FastWalletRescanFilter> fast_rescan_filter;
-    if (chain().hasBlockFilterIndex(BlockFilterType::BASIC)) fast_rescan_filter = std::make_unique<FastWalletRescanFilter>(*this);
+    if (const auto filter_type{GetRescanFilterType(chain())}) fast_rescan_filter = std::make_unique<FastWalletRescanFilter>(*this, *filter_type);
 
     WalletLogPrintf("Rescan started from block %s... (%s)\n", start_block.ToString(),
                     fast_rescan_filter ? "fast variant using block filters" : "slow variant inspecting all blocks");
+    if (fast_rescan_filter && fast_rescan_filter->GetFilterType() == BlockFilterType::BASIC) {
+        WalletLogPrintf("Rescan uses the basic block filters, names received without other wallet outputs are not found (use -blockfilterindex=names)\n");
+    }
 
     ShowProgress(strprintf("[%s] %s", DisplayName(), _("Rescanning…")), 0); // show rescan progress in GUI as dialog or on splashscreen, if rescan required on startup (e.g. due to corruption)
     uint256 tip_hash = WITH_LOCK(cs_wallet, return GetLastBlockHash());
@@ -1929,6 +2111,33 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
     double progress_end = chain().guessVerificationProgress(end_hash);
     double progress_current = progress_begin;
     int block_height = start_height;
+
+    // With -rescanthreads, the worker threads match the block filters and
+    // read the blocks ahead of the scan, which then applies them in order.
+    // The queue is dropped if the chain or the filter set changes.
+    const int rescan_threads{m_rescan_threads};
+    std::deque<std::future<RescanBlockAhead>> read_ahead;
+    uint256 read_ahead_last;
+    int read_ahead_last_height{0};
+    ThreadPool read_pool{"rescan"};
+    if (rescan_threads > 0) read_pool.Start(rescan_threads);
+    const auto queue_block{[&](const uint256& hash, const int height) {
+        auto filter_set{fast_rescan_filter ? fast_rescan_filter->GetFilterSet() : nullptr};
+        const auto filter_type{fast_rescan_filter ? fast_rescan_filter->GetFilterType() : BlockFilterType::INVALID};
+        auto future{read_pool.Submit([this, hash, filter_type, filter_set = std::move(filter_set)] {
+            RescanBlockAhead res;
+            res.hash = hash;
+            if (filter_set) res.filter_match = chain().blockFilterMatchesAny(filter_type, hash, *filter_set);
+            if (res.filter_match.value_or(true)) chain().findBlock(hash, FoundBlock().data(res.block));
+            return res;
+        })};
+        if (!future) return false;
+        read_ahead.push_back(std::move(*future));
+        read_ahead_last = hash;
+        read_ahead_last_height = height;
+        return true;
+    }};
+
     while (!fAbortRescan && !chain().shutdownRequested()) {
         if (progress_end - progress_begin > 0.0) {
             m_scanning_progress = (progress_current - progress_begin) / (progress_end - progress_begin);
@@ -1945,10 +2154,30 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
             WalletLogPrintf("Still rescanning. At block %d. Progress=%f\n", block_height, progress_current);
         }
 
+        if (fast_rescan_filter && fast_rescan_filter->UpdateIfNeeded()) {
+            read_ahead.clear();
+        }
+        std::optional<RescanBlockAhead> ahead;
+        if (rescan_threads > 0 && (!read_ahead.empty() || queue_block(block_hash, block_height))) {
+            const int end_height{std::min(max_height.value_or(std::numeric_limits<int>::max()), WITH_LOCK(cs_wallet, return GetLastBlockHeight()))};
+            while (read_ahead.size() < static_cast<size_t>(rescan_threads) * RESCAN_READ_AHEAD_PER_THREAD && read_ahead_last_height < end_height) {
+                bool next_active{false};
+                uint256 next_hash;
+                chain().findBlock(read_ahead_last, FoundBlock().nextBlock(FoundBlock().inActiveChain(next_active).hash(next_hash)));
+                if (!next_active || !queue_block(next_hash, read_ahead_last_height + 1)) break;
+            }
+            ahead = read_ahead.front().get();
+            read_ahead.pop_front();
+            if (ahead->hash != block_hash) {
+                // The chain changed since the block was queued.
+                ahead.reset();
+                read_ahead.clear();
+            }
+        }
+
         bool fetch_block{true};
         if (fast_rescan_filter) {
-            fast_rescan_filter->UpdateIfNeeded();
-            auto matches_block{fast_rescan_filter->MatchesBlock(block_hash)};
+            auto matches_block{ahead ? ahead->filter_match : fast_rescan_filter->MatchesBlock(block_hash)};
             if (matches_block.has_value()) {
                 if (*matches_block) {
                     LogDebug(BCLog::SCAN, "Fast rescan: inspect block %d [%s] (filter matched)\n", block_height, block_hash.ToString());
@@ -1974,7 +2203,12 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
             CBlock block;
             CBlockLocator loc;
             // Find block
-            FoundBlock found_block{FoundBlock().data(block)};
+            FoundBlock found_block;
+            if (ahead) {
+                block = std::move(ahead->block);
+            } else {
+                found_block.data(block);
+            }
             if (save_progress && next_interval) found_block.locator(loc);
             chain().findBlock(block_hash, found_block);
 
@@ -1987,6 +2221,11 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
                     result.status = ScanResult::FAILURE;
                     break;
                 }
+                // Write everything found in the block in one database transaction.
+                // It must not be kept open beyond the block, as other threads
+                // would wait for it while holding cs_wallet.
+                WalletBatch batch(GetDatabase());
+                const bool in_txn{batch.TxnBegin()};
                 for (size_t posInBlock = 0; posInBlock < block.vtx.size(); ++posInBlock) {
                     SyncTransaction(block.vtx[posInBlock], TxStateConfirmed{block_hash, block_height, static_cast<int>(posInBlock)}, /*rescanning_old_block=*/true);
                 }
@@ -1996,9 +2235,11 @@ CWallet::ScanResult CWallet::ScanForWalletTransactions(const uint256& start_bloc
 
                 if (!loc.IsNull()) {
                     WalletLogPrintf("Saving scan progress %d.\n", block_height);
-                    WalletBatch batch(GetDatabase());
                     batch.WriteBestBlock(loc);
                 }
+                if (in_txn && !batch.TxnCommit()) {
+                    WalletLogPrintf("Failed to commit the rescanned transactions of block %d.\n", block_height);
+                }
             } else {
                 // could not scan block, keep scanning but record this block as the most recent failure
                 result.last_failed_block = block_hash;
@@ -2509,9 +2750,13 @@ util::Result<void> CWallet::RemoveTxs(WalletBatch& batch, std::vector<Txid>& txs
                         break;
                     }
                 }
+                UpdateUnspentTXO(txin.prevout);
             }
             for (unsigned int i = 0; i < it->second.GetTx()->vout.size(); ++i) {
-                m_txos.erase(COutPoint(hash, i));
+                const auto txo_it{m_txos.find(COutPoint(hash, i))};
+                if (txo_it == m_txos.end()) continue;
+                EraseUnspentTXO(txo_it->first, txo_it->second);
+                m_txos.erase(txo_it);
             }
             mapWallet.erase(it);
             NotifyTransactionChanged(hash, CT_DELETED);
@@ -3131,6 +3376,7 @@ bool CWallet::LoadWalletArgs(std::shared_ptr<CWallet> wallet, const WalletContex
     }
 
     wallet->m_keypool_size = std::max(args.GetIntArg("-keypool", DEFAULT_KEYPOOL_SIZE), int64_t{1});
+    wallet->m_rescan_threads = std::clamp<int>(args.GetIntArg("-rescanthreads", DEFAULT_RESCAN_THREADS), 0, MAX_RESCAN_THREADS);
     wallet->m_notify_tx_changed_script = args.GetArg("-walletnotify", "");
     wallet->SetBroadcastTransactions(args.GetBoolArg("-walletbroadcast", DEFAULT_WALLETBROADCAST));
 
@@ -3393,21 +3639,137 @@ bool CWallet::WriteQueuedTransaction(const Txid &txid, const CMutableTransaction
     AssertLockHeld(cs_wallet);
 
     const bool success = WalletBatch(GetDatabase()).WriteQueuedTransaction(txid, tx);
-    if(success)
-        queuedTransactionMap[txid] = tx;
+    if(success) {
+        auto& queued = queuedTransactionMap[txid];
+        queued.tx = tx;
+        ScheduleQueuedTransaction(txid, queued, HaveChain() ? GetQueuedTransactionDueHeight(tx, GetLastBlockHeight()) : 0);
+    }
 
     return success;
 }
 
+bool CWallet::WriteQueuedTransactions(const std::vector<CMutableTransaction>& txs,
+                                      const std::vector<std::pair<valtype, NameNewSalt>>& name_news)
+{
+    AssertLockHeld(cs_wallet);
+
+    const bool success = RunWithinTxn(GetDatabase(), "queue transactions", [&](WalletBatch& batch) {
+        for (const auto& tx : txs) {
+            if (!batch.WriteQueuedTransaction(tx.GetHash(), tx)) return false;
+            for (const auto& txin : tx.vin) {
+                if (!batch.WriteLockedUTXO(txin.prevout)) return false;
+            }
+        }
+        for (const auto& [name, name_new] : name_news) {
+            if (!batch.WriteNameNew(Hash160(name), name_new)) return false;
+        }
+        return true;
+    });
+    if (!success)
+        return false;
+
+    for (const auto& tx : txs) {
+        const Txid txid = tx.GetHash();
+        auto& queued = queuedTransactionMap[txid];
+        queued.tx = tx;
+        ScheduleQueuedTransaction(txid, queued, HaveChain() ? GetQueuedTransactionDueHeight(tx, GetLastBlockHeight()) : 0);
+        // The inputs may have been locked in memory only before.
+        for (const auto& txin : tx.vin) {
+            m_locked_coins.insert_or_assign(txin.prevout, /*persistent=*/true);
+        }
+    }
+    for (const auto& [name, name_new] : name_news) {
+        m_name_news[Hash160(name)] = name_new;
+    }
+
+    return true;
+}
+
+void CWallet::LoadQueuedTransaction(const Txid& txid, const CMutableTransaction& tx)
+{
+    AssertLockHeld(cs_wallet);
+    auto& queued = queuedTransactionMap[txid];
+    queued.tx = tx;
+    // The chain is not known yet while loading, so try it on the next block.
+    ScheduleQueuedTransaction(txid, queued, 0);
+}
+
 bool CWallet::EraseQueuedTransaction(const Txid& txid)
 {
     AssertLockHeld(cs_wallet);
     const bool success = WalletBatch(GetDatabase()).EraseQueuedTransaction(txid);
-    if(success)
-        queuedTransactionMap.erase(txid);
+    if(success) {
+        auto it = queuedTransactionMap.find(txid);
+        if (it != queuedTransactionMap.end()) {
+            m_queued_tx_schedule.erase({it->second.due_height, txid});
+            queuedTransactionMap.erase(it);
+        }
+    }
     return success;
 }
 
+bool CWallet::WriteNameNew(const valtype& name, const NameNewSalt& name_new)
+{
+    AssertLockHeld(cs_wallet);
+    const uint160 name_hash{Hash160(name)};
+    if (!WalletBatch(GetDatabase()).WriteNameNew(name_hash, name_new))
+        return false;
+    m_name_news[name_hash] = name_new;
+    return true;
+}
+
+bool CWallet::EraseNameNew(const valtype& name, const COutPoint& outpoint)
+{
+    AssertLockHeld(cs_wallet);
+    const uint160 name_hash{Hash160(name)};
+    const auto it = m_name_news.find(name_hash);
+    if (it == m_name_news.end() || it->second.outpoint != outpoint)
+        return true;
+    if (!WalletBatch(GetDatabase()).EraseNameNew(name_hash))
+        return false;
+    m_name_news.erase(it);
+    return true;
+}
+
+void CWallet::PruneNameNews(const CTransaction& tx)
+{
+    AssertLockHeld(cs_wallet);
+    if (m_name_news.empty() || !tx.IsNamecoin()) return;
+    // Only a name_firstupdate can spend the output of a name_new, and it
+    // does so for the same name.
+    for (const CTxOut& txout : tx.vout) {
+        const CNameScript nameOp(txout.scriptPubKey);
+        if (!nameOp.isNameOp() || nameOp.getNameOp() != OP_NAME_FIRSTUPDATE) continue;
+        const auto it = m_name_news.find(Hash160(nameOp.getOpName()));
+        if (it == m_name_news.end()) continue;
+        const COutPoint outpoint{it->second.outpoint};
+        for (const CTxIn& txin : tx.vin) {
+            if (txin.prevout != outpoint) continue;
+            if (EraseNameNew(nameOp.getOpName(), outpoint)) {
+                WalletLogPrintf("Erased stored name_new %s:%u, spent by %s", outpoint.hash.ToString(), outpoint.n, tx.GetHash().ToString());
+            } else {
+                WalletLogPrintf("Failed to erase stored name_new %s:%u", outpoint.hash.ToString(), outpoint.n);
+            }
+            break;
+        }
+    }
+}
+
+std::optional<NameNewSalt> CWallet::GetNameNew(const valtype& name) const
+{
+    AssertLockHeld(cs_wallet);
+    const auto it = m_name_news.find(Hash160(name));
+    if (it == m_name_news.end())
+        return std::nullopt;
+    return it->second;
+}
+
+void CWallet::LoadNameNew(const uint160& name_hash, const NameNewSalt& name_new)
+{
+    AssertLockHeld(cs_wallet);
+    m_name_news[name_hash] = name_new;
+}
+
 bool CWallet::GetQueuedTransaction(const Txid &txid, CMutableTransaction *data) const
 {
     AssertLockHeld(cs_wallet);
@@ -3415,38 +3777,143 @@ bool CWallet::GetQueuedTransaction(const Txid &txid, CMutableTransaction *data)
     if (it == queuedTransactionMap.end())
         return false;
     if (data != nullptr)
-        (*data) = it->second;
+        (*data) = it->second.tx;
     return true;
 }
 
-void CWallet::EffectTransactionQueue()
+void CWallet::ScheduleQueuedTransaction(const Txid& txid, QueuedTransaction& queued, const int due_height)
+{
+    AssertLockHeld(cs_wallet);
+    m_queued_tx_schedule.erase({queued.due_height, txid});
+    queued.due_height = due_height;
+    m_queued_tx_schedule.emplace(due_height, txid);
+}
+
+int CWallet::GetQueuedTransactionDueHeight(const CMutableTransaction& tx, const int tip_height) const
+{
+    std::map<COutPoint, Coin> coins;
+    for (const auto& txin : tx.vin) {
+        coins[txin.prevout];
+    }
+    chain().findCoins(coins);
+
+    // The transaction is accepted to the mempool when its constraints allow
+    // it to be mined in the block after the tip.
+    int due_height{0};
+    bool has_non_final_input{false};
+    for (const auto& txin : tx.vin) {
+        has_non_final_input |= txin.nSequence != CTxIn::SEQUENCE_FINAL;
+
+        const Coin& coin = coins.at(txin.prevout);
+        if (coin.IsSpent()) continue;
+        const CNameScript nameOp(coin.out.scriptPubKey);
+        const bool spends_name_new = nameOp.isNameOp() && nameOp.getNameOp() == OP_NAME_NEW;
+        if (coin.nHeight == MEMPOOL_HEIGHT) {
+            // The mempool accepts a name_firstupdate whose name_new is still
+            // unconfirmed, but it should not be revealed before it can be mined.
+            if (spends_name_new) {
+                due_height = std::max(due_height, tip_height + static_cast<int>(MIN_FIRSTUPDATE_DEPTH));
+            }
+            continue;
+        }
+        const int coin_height = static_cast<int>(coin.nHeight);
+
+        // BIP68 relative lock time by height.
+        if (tx.version >= 2
+            && !(txin.nSequence & CTxIn::SEQUENCE_LOCKTIME_DISABLE_FLAG)
+            && !(txin.nSequence & CTxIn::SEQUENCE_LOCKTIME_TYPE_FLAG)) {
+            const int lock = static_cast<int>(txin.nSequence & CTxIn::SEQUENCE_LOCKTIME_MASK);
+            due_height = std::max(due_height, coin_height + lock - 1);
+        }
+
+        if (spends_name_new) {
+            due_height = std::max(due_height, coin_height + static_cast<int>(MIN_FIRSTUPDATE_DEPTH) - 1);
+        }
+    }
+
+    // Absolute lock time by height.
+    if (has_non_final_input && tx.nLockTime < LOCKTIME_THRESHOLD) {
+        due_height = std::max(due_height, static_cast<int>(tx.nLockTime));
+    }
+
+    return due_height;
+}
+
+void CWallet::EffectTransactionQueue(const int height)
 {
     // This is called when we get a new block to deal with queued transactions.
+    // We only do this for fresh blocks. Otherwise, we might trigger way too early.
     if (chain().isInitialBlockDownload())
         return;
-    // We only do this for fresh blocks. Otherwise, we might trigger way too early.
-    std::set<Txid> to_dequeue;
-    // Kludge; we can't remove items in a map while iterating over it.
-    AssertLockHeld(cs_wallet);
-    for (const auto& i : queuedTransactionMap)
-    // For each transaction in the queue...
+
+    // Take out the transactions that are due, so that they can be broadcast
+    // without holding cs_wallet.  Their due height may have been set before
+    // their inputs were confirmed (or before the chain was known), so check
+    // it again first.
+    std::vector<std::pair<Txid, CTransactionRef>> due;
     {
-        const Txid& txid = i.first;
-        const CMutableTransaction& tx = i.second;
+        LOCK(cs_wallet);
+        std::vector<std::pair<Txid, int>> later;
+        while (!m_queued_tx_schedule.empty() && m_queued_tx_schedule.begin()->first <= height) {
+            const Txid txid = m_queued_tx_schedule.begin()->second;
+            m_queued_tx_schedule.erase(m_queued_tx_schedule.begin());
+            const auto it = queuedTransactionMap.find(txid);
+            assert(it != queuedTransactionMap.end());
+            const int due_height = GetQueuedTransactionDueHeight(it->second.tx, height);
+            if (due_height > height) {
+                later.emplace_back(txid, due_height);
+                continue;
+            }
+            // Not scheduled at all while being broadcast.
+            it->second.due_height = -1;
+            due.emplace_back(txid, MakeTransactionRef(it->second.tx));
+        }
+        for (const auto& [txid, due_height] : later) {
+            ScheduleQueuedTransaction(txid, queuedTransactionMap.at(txid), due_height);
+        }
+    }
+    if (due.empty())
+        return;
 
+    std::vector<Txid> broadcast;
+    for (const auto& [txid, tx] : due) {
         std::string unused_err_string;
-        if (chain().broadcastTransaction(MakeTransactionRef(tx), m_default_max_tx_fee, node::TxBroadcast::MEMPOOL_AND_BROADCAST_TO_ALL, unused_err_string))
+        if (chain().broadcastTransaction(tx, m_default_max_tx_fee, node::TxBroadcast::MEMPOOL_AND_BROADCAST_TO_ALL, unused_err_string))
         // attempt to broadcast
         {
-            to_dequeue.emplace(txid);
-            WalletLogPrintf("Broadcast queued transaction with txid %s, %s", txid.GetHex(), CTransaction(tx).ToString().c_str());
+            broadcast.push_back(txid);
+            WalletLogPrintf("Broadcast queued transaction with txid %s, %s", txid.GetHex(), tx->ToString().c_str());
             // No newline here, since tx's ToString contains one.
         }
         // If the transaction isn't yet valid, there's nothing to do.
     }
 
-    for (const auto& i : to_dequeue)
-        queuedTransactionMap.erase(i);
+    LOCK(cs_wallet);
+    WalletBatch batch(GetDatabase());
+    for (const auto& txid : broadcast) {
+        const auto it = queuedTransactionMap.find(txid);
+        if (it == queuedTransactionMap.end())
+            continue;
+        // Locks on the now spent inputs (see WriteQueuedTransactions) are
+        // no longer needed.
+        for (const auto& txin : it->second.tx.vin) {
+            if (IsLockedCoin(txin.prevout)) UnlockCoin(txin.prevout);
+        }
+        m_queued_tx_schedule.erase({it->second.due_height, txid});
+        queuedTransactionMap.erase(it);
+        batch.EraseQueuedTransaction(txid);
+    }
+
+    // The others are tried again when they may have become valid, which is
+    // on the next block if the reason is not known.  They may have been
+    // dequeued or queued again meanwhile.
+    for (const auto& [txid, tx] : due) {
+        const auto it = queuedTransactionMap.find(txid);
+        if (it == queuedTransactionMap.end() || it->second.due_height != -1)
+            continue;
+        const int due_height = std::max(GetQueuedTransactionDueHeight(it->second.tx, height), height + 1);
+        ScheduleQueuedTransaction(txid, it->second, due_height);
+    }
 }
 
 int CWallet::GetTxDepthInMainChain(const CWalletTx& wtx) const
@@ -4105,6 +4572,9 @@ util::Result<void> CWallet::ApplyMigrationData(WalletBatch& local_wallet_batch,
     (void)local_wallet_batch.ReadBestBlock(best_block_locator);
 
     // Update m_txos to match the descriptors remaining in this wallet
+    m_unspent_txos.clear();
+    m_unspent_name_txos.clear();
+    m_unspent_names.clear();
     m_txos.clear();
     RefreshAllTXOs();
 
@@ -4637,10 +5107,13 @@ void CWallet::CacheNewScriptPubKeys(const std::set<CScript>& spks, ScriptPubKeyM
     for (const auto& script : spks) {
         m_cached_spks[script].push_back(spkm);
     }
+    if (m_block_new_spks) m_block_new_spks->insert(spks.begin(), spks.end());
 }
 
 void CWallet::TopUpCallback(const std::set<CScript>& spks, ScriptPubKeyMan* spkm)
 {
+    // The key pool is only topped up with cs_wallet held.
+    AssertLockHeld(cs_wallet);
     // Update scriptPubKey cache
     CacheNewScriptPubKeys(spks, spkm);
 }
@@ -4716,10 +5189,56 @@ void CWallet::RefreshTXOsFromTx(const CWalletTx& wtx)
         if (m_txos.contains(outpoint)) {
         } else {
             m_txos.emplace(outpoint, WalletTXO{wtx, txout});
+            UpdateUnspentTXO(outpoint);
+        }
+    }
+}
+
+void CWallet::UpdateUnspentTXO(const COutPoint& outpoint)
+{
+    AssertLockHeld(cs_wallet);
+    const auto it{m_txos.find(outpoint)};
+    if (it == m_txos.end()) return;
+    const WalletTXO& txo{it->second};
+    if (HowSpent(outpoint) == SpendType::CONFIRMED) {
+        EraseUnspentTXO(outpoint, txo);
+        return;
+    }
+    if (!txo.IsNameOutput()) {
+        m_unspent_txos.emplace(outpoint, &txo);
+        return;
+    }
+    m_unspent_name_txos.emplace(outpoint, &txo);
+    if (txo.IsNameUpdate()) {
+        m_unspent_names[CNameScript(txo.GetTxOut().scriptPubKey).getOpName()].insert(outpoint);
+    }
+}
+
+void CWallet::EraseUnspentTXO(const COutPoint& outpoint, const WalletTXO& txo)
+{
+    AssertLockHeld(cs_wallet);
+    if (!txo.IsNameOutput()) {
+        m_unspent_txos.erase(outpoint);
+        return;
+    }
+    m_unspent_name_txos.erase(outpoint);
+    if (txo.IsNameUpdate()) {
+        const auto it{m_unspent_names.find(CNameScript(txo.GetTxOut().scriptPubKey).getOpName())};
+        if (it != m_unspent_names.end()) {
+            it->second.erase(outpoint);
+            if (it->second.empty()) m_unspent_names.erase(it);
         }
     }
 }
 
+std::vector<COutPoint> CWallet::GetUnspentNameOutpoints(const valtype& name) const
+{
+    AssertLockHeld(cs_wallet);
+    const auto it{m_unspent_names.find(name)};
+    if (it == m_unspent_names.end()) return {};
+    return {it->second.begin(), it->second.end()};
+}
+
 void CWallet::RefreshAllTXOs()
 {
     AssertLockHeld(cs_wallet);
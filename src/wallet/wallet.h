@@ -31,6 +31,7 @@
 #include <util/log.h>
 #include <util/result.h>
 #include <util/string.h>
+#include <util/threadpool.h>
 #include <util/time.h>
 #include <util/ui_change_type.h>
 #include <wallet/crypter.h>
@@ -52,6 +53,7 @@
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -132,6 +134,10 @@ inline constexpr bool DEFAULT_WALLET_REJECT_LONG_CHAINS{true};
 inline constexpr unsigned int DEFAULT_TX_CONFIRM_TARGET = 6;
 //! -walletrbf default
 inline constexpr bool DEFAULT_WALLET_RBF = true;
+//! -rescanthreads default, by default blocks are read on the rescanning thread
+inline constexpr int DEFAULT_RESCAN_THREADS{0};
+//! Maximum number of threads reading blocks ahead of a rescan
+inline constexpr int MAX_RESCAN_THREADS{16};
 inline constexpr bool DEFAULT_WALLETBROADCAST = true;
 inline constexpr bool DEFAULT_DISABLE_WALLET = false;
 inline constexpr bool DEFAULT_WALLETCROSSCHAIN = false;
@@ -308,12 +314,24 @@ struct CRecipient
     CScript nameScript;
 };
 
+/** A transaction queued for broadcast once it becomes valid.  */
+struct QueuedTransaction
+{
+    CMutableTransaction tx;
+    //! Tip height at which broadcasting the transaction is tried next
+    int due_height{0};
+};
+
 class WalletRescanReserver; //forward declarations for ScanForWalletTransactions/RescanFromTime
 /**
  * A CWallet maintains a set of transactions and balances, and provides the ability to create new transactions.
  */
 class CWallet final : public WalletStorage, public interfaces::Chain::Notifications
 {
+public:
+    //! Unspent outputs of the wallet by outpoint, pointing into m_txos
+    using UnspentTXOMap = std::unordered_map<COutPoint, const WalletTXO*, SaltedOutpointHasher>;
+
 private:
     CKeyingMaterial vMasterKey GUARDED_BY(cs_wallet);
 
@@ -383,6 +401,25 @@ private:
 
     bool SyncTransaction(const CTransactionRef& tx, const SyncTxState& state, bool rescanning_old_block = false) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
+    /**
+     * Whether SyncTransaction may do anything for the transaction: it is in the wallet
+     * already, spends an output that the wallet has or spends, or pays to a script in
+     * m_cached_spks.  This only reads the wallet, so it may run on other threads while
+     * the calling thread holds cs_wallet for them.
+     */
+    bool TxMayBeRelevant(const CTransaction& tx) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    /** Runs TxMayBeRelevant for the transactions of a block, on threads for large blocks */
+    std::vector<uint8_t> MatchBlockTransactions(const std::vector<CTransactionRef>& txs) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
+    /**
+     * While set, the transaction notifications are collected here instead of being
+     * sent, so that blockConnected sends them once per transaction after the block
+     * is written.
+     */
+    std::optional<std::vector<std::pair<Txid, ChangeType>>> m_pending_tx_notifications GUARDED_BY(cs_wallet);
+    /** Sends NotifyTransactionChanged, or adds it to m_pending_tx_notifications */
+    void NotifyTxChanged(const Txid& hash, ChangeType status) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
     /** WalletFlags set on this wallet. */
     std::atomic<uint64_t> m_wallet_flags{0};
 
@@ -438,10 +475,35 @@ private:
 
     //! Cache of descriptor ScriptPubKeys used for IsMine. Maps ScriptPubKey to set of spkms
     std::unordered_map<CScript, std::vector<ScriptPubKeyMan*>, SaltedSipHasher> m_cached_spks;
+    /** Scripts added to m_cached_spks while blockConnected applies a block, after matching it */
+    std::optional<std::unordered_set<CScript, SaltedSipHasher>> m_block_new_spks GUARDED_BY(cs_wallet);
+    /** Threads that match the transactions of large blocks, started on first use by MatchBlockTransactions */
+    mutable ThreadPool m_match_pool GUARDED_BY(cs_wallet){"walletmatch"};
 
     //! Set of both spent and unspent transaction outputs owned by this wallet
     std::unordered_map<COutPoint, WalletTXO, SaltedOutpointHasher> m_txos GUARDED_BY(cs_wallet);
 
+    /**
+     * The entries of m_txos that are not spent by a confirmed transaction.
+     * Only these can be available coins or count towards the balance, so
+     * coin selection and balances do not have to walk the whole history.
+     * They still check how the outputs are spent, as this also contains
+     * outputs spent by unconfirmed transactions.  Kept up to date with the
+     * spends and their states by UpdateUnspentTXO.
+     *
+     * Name outputs are kept separately in m_unspent_name_txos, so that
+     * ordinary coin selection and balances never see them.  The outputs of
+     * name_firstupdate's and name_update's are also indexed by the name.
+     */
+    UnspentTXOMap m_unspent_txos GUARDED_BY(cs_wallet);
+    UnspentTXOMap m_unspent_name_txos GUARDED_BY(cs_wallet);
+    std::map<valtype, std::set<COutPoint>> m_unspent_names GUARDED_BY(cs_wallet);
+
+    /** Adds or removes the outpoint in the unspent indices depending on how it is spent */
+    void UpdateUnspentTXO(const COutPoint& outpoint) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    /** Removes the outpoint of the given TXO from the unspent indices */
+    void EraseUnspentTXO(const COutPoint& outpoint, const WalletTXO& txo) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
     /**
      * Catch wallet up to current chain, scanning new blocks, updating the best
      * block locator and m_last_block_processed, and registering for
@@ -457,7 +519,32 @@ private:
     //! Update mempool conflicts for TRUC sibling transactions
     void UpdateTrucSiblingConflicts(const CWalletTx& parent_wtx, const Txid& child_txid, bool add_conflict) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
-    void EffectTransactionQueue();
+    /**
+     * Queued transactions ordered by the tip height at which they are tried
+     * next, so that each block only has to look at the ones that are due.
+     */
+    std::set<std::pair<int, Txid>> m_queued_tx_schedule GUARDED_BY(cs_wallet);
+
+    /** Sets the due height of a queued transaction and (re)schedules it.  */
+    void ScheduleQueuedTransaction(const Txid& txid, QueuedTransaction& queued, int due_height) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
+    /**
+     * Returns the lowest tip height at which a queued transaction may be
+     * accepted to the mempool, based on its lock time, the relative lock
+     * times of its inputs and the maturity of a spent name_new (before which
+     * a name_firstupdate is of no use), with the chain tip at the given
+     * height.  This is only a lower bound:  constraints that cannot be
+     * expressed as a height, like time locks or unconfirmed inputs, are
+     * ignored, except that an unconfirmed name_new cannot mature before it
+     * is confirmed.
+     */
+    int GetQueuedTransactionDueHeight(const CMutableTransaction& tx, int tip_height) const;
+
+    /**
+     * Tries to broadcast the queued transactions that are due at the given
+     * (new) tip height.  The broadcasts are done without holding cs_wallet.
+     */
+    void EffectTransactionQueue(int height) EXCLUSIVE_LOCKS_REQUIRED(!cs_wallet);
 
 public:
     /**
@@ -532,6 +619,12 @@ public:
 
     const std::unordered_map<COutPoint, WalletTXO, SaltedOutpointHasher>& GetTXOs() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet) { AssertLockHeld(cs_wallet); return m_txos; };
     std::optional<WalletTXO> GetTXO(const COutPoint& outpoint) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    /** The outputs owned by the wallet that are not spent by a confirmed transaction, except name outputs */
+    const UnspentTXOMap& GetUnspentTXOs() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet) { AssertLockHeld(cs_wallet); return m_unspent_txos; }
+    /** The name outputs owned by the wallet that are not spent by a confirmed transaction */
+    const UnspentTXOMap& GetUnspentNameTXOs() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet) { AssertLockHeld(cs_wallet); return m_unspent_name_txos; }
+    /** The unspent name_firstupdate and name_update outputs of the wallet for the given name */
+    std::vector<COutPoint> GetUnspentNameOutpoints(const valtype& name) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
     /** Cache outputs that belong to the wallet from a single transaction */
     void RefreshTXOsFromTx(const CWalletTx& wtx) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
@@ -760,6 +853,9 @@ public:
     /** Number of pre-generated keys/scripts by each spkm (part of the look-ahead process, used to detect payments) */
     int64_t m_keypool_size{DEFAULT_KEYPOOL_SIZE};
 
+    /** Number of threads that match block filters and read blocks ahead of rescans (set by -rescanthreads) */
+    int m_rescan_threads{DEFAULT_RESCAN_THREADS};
+
     /** Notify external script when a wallet transaction comes in or is updated (handled by -walletnotify) */
     std::string m_notify_tx_changed_script;
 
@@ -1084,7 +1180,7 @@ public:
     bool CanGrindR() const;
 
     //! Add scriptPubKeys for this ScriptPubKeyMan into the scriptPubKey cache
-    void CacheNewScriptPubKeys(const std::set<CScript>& spks, ScriptPubKeyMan* spkm);
+    void CacheNewScriptPubKeys(const std::set<CScript>& spks, ScriptPubKeyMan* spkm) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
     void TopUpCallback(const std::set<CScript>& spks, ScriptPubKeyMan* spkm) override;
 
@@ -1109,7 +1205,7 @@ public:
     //! Disconnect chain notifications and wait for all notifications to be processed
     void DisconnectChainNotifications();
 
-    std::map<Txid, CMutableTransaction> queuedTransactionMap;
+    std::map<Txid, QueuedTransaction> queuedTransactionMap;
 
     bool QueuedTransactionExists(const Txid &txid) const;
     bool WriteQueuedTransaction(
@@ -1117,6 +1213,34 @@ public:
             const CMutableTransaction &tx);
     bool EraseQueuedTransaction(const Txid &txid);
     bool GetQueuedTransaction(const Txid &txid, CMutableTransaction *data=nullptr) const;
+    /**
+     * Queues transactions created by the wallet itself, writing them all in
+     * a single database transaction.  Their inputs are locked (persistently),
+     * so that the wallet does not spend them in other transactions before the
+     * queued ones are broadcast.  The given name_new's are recorded in the
+     * same database transaction.
+     */
+    bool WriteQueuedTransactions(const std::vector<CMutableTransaction>& txs,
+                                 const std::vector<std::pair<valtype, NameNewSalt>>& name_news = {}) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    //! Adds a queued transaction read from the database, without writing it
+    void LoadQueuedTransaction(const Txid& txid, const CMutableTransaction& tx) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
+    /**
+     * Outpoints and salts of the wallet's name_new's by the hash of the name.
+     * If there are several name_new's for the same name, the latest one
+     * is kept.
+     */
+    std::map<uint160, NameNewSalt> m_name_news GUARDED_BY(cs_wallet);
+
+    //! Records the outpoint and salt of a name_new for the given name
+    bool WriteNameNew(const valtype& name, const NameNewSalt& name_new) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    //! Forgets the name_new for the name, if it is the one at the given outpoint
+    bool EraseNameNew(const valtype& name, const COutPoint& outpoint) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    std::optional<NameNewSalt> GetNameNew(const valtype& name) const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    //! Forgets the name_new's spent by the name_firstupdate in tx
+    void PruneNameNews(const CTransaction& tx) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+    //! Adds a name_new read from the database, without writing it
+    void LoadNameNew(const uint160& name_hash, const NameNewSalt& name_new) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 };
 
 /**
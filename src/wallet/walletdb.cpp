@@ -15,6 +15,7 @@
 #include <script/script.h>
 #include <serialize.h>
 #include <sync.h>
+#include <uint256.h>
 #include <util/bip32.h>
 #include <util/check.h>
 #include <util/fs.h>
@@ -47,6 +48,7 @@ const std::string LOCKED_UTXO{"lockedutxo"};
 const std::string MASTER_KEY{"mkey"};
 const std::string MINVERSION{"minversion"};
 const std::string NAME{"name"};
+const std::string NAME_NEW{"name_new"};
 const std::string OLD_KEY{"wkey"};
 const std::string ORDERPOSNEXT{"orderposnext"};
 const std::string POOL{"pool"};
@@ -306,6 +308,16 @@ bool WalletBatch::EraseQueuedTransaction(const Txid& txid)
     return EraseIC(std::make_pair(DBKeys::QUEUED_TX, txid));
 }
 
+bool WalletBatch::WriteNameNew(const uint160& name_hash, const NameNewSalt& name_new)
+{
+    return WriteIC(std::make_pair(DBKeys::NAME_NEW, name_hash), name_new);
+}
+
+bool WalletBatch::EraseNameNew(const uint160& name_hash)
+{
+    return EraseIC(std::make_pair(DBKeys::NAME_NEW, name_hash));
+}
+
 bool LoadKey(CWallet* pwallet, DataStream& ssKey, DataStream& ssValue, std::string& strErr)
 {
     LOCK(pwallet->cs_wallet);
@@ -715,25 +727,6 @@ static DBErrors LoadLegacyWalletRecords(CWallet* pwallet, DatabaseBatch& batch,
     });
     result = std::max(result, watch_meta_res.m_result);
 
-    // Load queued transactions
-    LoadResult queued_res = LoadRecords(pwallet, batch, DBKeys::QUEUED_TX,
-        [] (CWallet* pwallet, DataStream& key, DataStream& value, std::string& err) {
-        std::string strTxid;
-        key >> strTxid;
-
-        const auto u256Txid = uint256::FromHex(strTxid);
-        if (!u256Txid)
-            return DBErrors::CORRUPT;
-
-        CMutableTransaction pending;
-        value >> TX_WITH_WITNESS (pending);
-
-        pwallet->queuedTransactionMap[Txid::FromUint256(*u256Txid)] = pending;
-
-        return DBErrors::LOAD_OK;
-    });
-    result = std::max(result, queued_res.m_result);
-
     // Deal with old "wkey" and "defaultkey" records.
     // These are not actually loaded, but we need to check for them
 
@@ -1016,51 +1009,55 @@ static DBErrors LoadAddressBookRecords(CWallet* pwallet, DatabaseBatch& batch) E
     return result;
 }
 
-static std::map<Wtxid, CTransactionRef> ReadWtxVariants(DatabaseBatch& batch, const Txid& txid)
-{
-    std::map<Wtxid, CTransactionRef> variants;
-
-    DataStream prefix;
-    prefix << DBKeys::WTX_VARIANT << txid;
-    std::unique_ptr<DatabaseCursor> cursor = batch.GetNewPrefixCursor(prefix);
-    if (!cursor) {
-        throw std::runtime_error(strprintf("Error getting database cursor for '%s' records", DBKeys::WTX_VARIANT));
-    }
-
-    DataStream key;
-    DataStream value;
-    while (true) {
-        DatabaseCursor::Status status = cursor->Next(key, value);
-        if (status == DatabaseCursor::Status::DONE) break;
-        if (status == DatabaseCursor::Status::FAIL) {
-            throw std::runtime_error(strprintf("Error reading '%s' record", DBKeys::WTX_VARIANT));
-        }
-        CTransactionRef tx;
-        value >> TX_WITH_WITNESS(tx);
-        if (tx->GetHash() != txid) {
-            throw std::runtime_error(strprintf("Corrupted witness variant, tx hash differs"));
-        }
-        if (!variants.emplace(tx->GetWitnessHash(), std::move(tx)).second) {
-            throw std::runtime_error(strprintf("Duplicate witness variant"));
-        }
-    }
-    return variants;
-}
-
 static DBErrors LoadTxRecords(CWallet* pwallet, DatabaseBatch& batch, bool& any_unordered) EXCLUSIVE_LOCKS_REQUIRED(pwallet->cs_wallet)
 {
     AssertLockHeld(pwallet->cs_wallet);
     DBErrors result = DBErrors::LOAD_OK;
 
+    // Load the witness variants of all transactions in one pass, rather than
+    // querying the database for each tx record.
+    //
+    // TODO: All transactions are still loaded into memory in full. Loading
+    // only their metadata and output summaries, and reading the transactions
+    // from the database on demand through an LRU cache, needs every user of
+    // CWalletTx::tx to handle a transaction that is not in memory.
+    std::map<Txid, std::map<Wtxid, CTransactionRef>> variants;
+    LoadResult variant_res = LoadRecords(pwallet, batch, DBKeys::WTX_VARIANT,
+        [&variants] (CWallet* pwallet, DataStream& key, DataStream& value, std::string& err) {
+        Txid txid;
+        key >> txid;
+        try {
+            CTransactionRef tx;
+            value >> TX_WITH_WITNESS(tx);
+            if (tx->GetHash() != txid) {
+                err = "Error: Corrupted witness variant, tx hash differs";
+                return DBErrors::CORRUPT;
+            }
+            if (!variants[txid].emplace(tx->GetWitnessHash(), std::move(tx)).second) {
+                err = "Error: Duplicate witness variant";
+                return DBErrors::CORRUPT;
+            }
+        } catch (const std::exception& e) {
+            err = strprintf("Error: Corrupt witness variant record found: %s", e.what());
+            return DBErrors::CORRUPT;
+        }
+        return DBErrors::LOAD_OK;
+    });
+    result = std::max(result, variant_res.m_result);
+
     // Load tx record
     any_unordered = false;
     LoadResult tx_res = LoadRecords(pwallet, batch, DBKeys::TX,
-        [&any_unordered, &batch] (CWallet* pwallet, DataStream& key, DataStream& value, std::string& err) EXCLUSIVE_LOCKS_REQUIRED(pwallet->cs_wallet) {
+        [&any_unordered, &variants] (CWallet* pwallet, DataStream& key, DataStream& value, std::string& err) EXCLUSIVE_LOCKS_REQUIRED(pwallet->cs_wallet) {
         DBErrors result = DBErrors::LOAD_OK;
         Txid hash;
         key >> hash;
         try {
-            CWalletTx wtx{deserialize, value, ReadWtxVariants(batch, hash)};
+            std::map<Wtxid, CTransactionRef> tx_variants;
+            if (const auto it{variants.find(hash)}; it != variants.end()) {
+                tx_variants = std::move(it->second);
+            }
+            CWalletTx wtx{deserialize, value, tx_variants};
             if (wtx.GetHash() != hash) {
                 result = std::max(result, DBErrors::NEED_RESCAN);
             }
@@ -1118,6 +1115,41 @@ static DBErrors LoadTxRecords(CWallet* pwallet, DatabaseBatch& batch, bool& any_
     return result;
 }
 
+static DBErrors LoadNamecoinRecords(CWallet* pwallet, DatabaseBatch& batch) EXCLUSIVE_LOCKS_REQUIRED(pwallet->cs_wallet)
+{
+    AssertLockHeld(pwallet->cs_wallet);
+    DBErrors result = DBErrors::LOAD_OK;
+
+    // Load queued transactions
+    LoadResult queued_res = LoadRecords(pwallet, batch, DBKeys::QUEUED_TX,
+        [] (CWallet* pwallet, DataStream& key, DataStream& value, std::string& err) EXCLUSIVE_LOCKS_REQUIRED(pwallet->cs_wallet) {
+        Txid txid;
+        key >> txid;
+
+        CMutableTransaction pending;
+        value >> TX_WITH_WITNESS (pending);
+
+        pwallet->LoadQueuedTransaction(txid, pending);
+
+        return DBErrors::LOAD_OK;
+    });
+    result = std::max(result, queued_res.m_result);
+
+    // Load the salts of name_new's
+    LoadResult name_new_res = LoadRecords(pwallet, batch, DBKeys::NAME_NEW,
+        [] (CWallet* pwallet, DataStream& key, DataStream& value, std::string& err) EXCLUSIVE_LOCKS_REQUIRED(pwallet->cs_wallet) {
+        uint160 name_hash;
+        key >> name_hash;
+        NameNewSalt name_new;
+        value >> name_new;
+        pwallet->LoadNameNew(name_hash, name_new);
+        return DBErrors::LOAD_OK;
+    });
+    result = std::max(result, name_new_res.m_result);
+
+    return result;
+}
+
 static DBErrors LoadActiveSPKMs(CWallet* pwallet, DatabaseBatch& batch) EXCLUSIVE_LOCKS_REQUIRED(pwallet->cs_wallet)
 {
     AssertLockHeld(pwallet->cs_wallet);
@@ -1207,6 +1239,9 @@ DBErrors WalletBatch::LoadWallet(CWallet* pwallet)
 
         // Load tx records
         result = std::max(LoadTxRecords(pwallet, *m_batch, any_unordered), result);
+
+        // Load queued transactions and name_new salts
+        result = std::max(LoadNamecoinRecords(pwallet, *m_batch), result);
     } catch (std::runtime_error& e) {
         // Exceptions that can be ignored or treated as non-critical are handled by the individual loading functions.
         // Any uncaught exceptions will be caught here and treated as critical.
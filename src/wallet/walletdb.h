@@ -184,6 +184,20 @@ public:
     }
 };
 
+/**
+ * The outpoint and salt of a name_new created by the wallet.  They are
+ * stored keyed by the hash of the name, so that name_firstupdate can find
+ * them without recomputing salts and matching them against the wallet's
+ * name_new outputs.
+ */
+struct NameNewSalt
+{
+    COutPoint outpoint;
+    valtype rand;
+
+    SERIALIZE_METHODS(NameNewSalt, obj) { READWRITE(obj.outpoint, obj.rand); }
+};
+
 struct DbTxnListener
 {
     std::function<void()> on_commit, on_abort;
@@ -273,6 +287,9 @@ public:
     bool WriteQueuedTransaction(const Txid& txid, const CMutableTransaction& tx);
     bool EraseQueuedTransaction(const Txid& txid);
 
+    bool WriteNameNew(const uint160& name_hash, const NameNewSalt& name_new);
+    bool EraseNameNew(const uint160& name_hash);
+
     DBErrors LoadWallet(CWallet* pwallet);
 
     //! Write the given client_version.
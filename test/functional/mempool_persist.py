@@ -33,18 +33,24 @@ Test is as follows:
     mempool.
   - Verify that savemempool throws when the RPC is called if
     node1 can't write to disk.
+  - Verify that a dump is reloaded without script checks only at the tip
+    it was written at, only by the node itself and only for transactions
+    that still match their recorded wtxid.
 
 """
 from decimal import Decimal
 import os
+import shutil
 import time
 
+from test_framework.messages import tx_from_hex
 from test_framework.p2p import P2PTxInvStore
 from test_framework.test_framework import BitcoinTestFramework
 from test_framework.util import (
     assert_equal,
     assert_greater_than_or_equal,
     assert_raises_rpc_error,
+    util_xor,
 )
 from test_framework.wallet import MiniWallet, COIN
 
@@ -196,6 +202,7 @@ class MempoolPersistTest(BitcoinTestFramework):
 
         self.test_importmempool_union()
         self.test_persist_unbroadcast()
+        self.test_dump_tip()
 
     def test_persist_unbroadcast(self):
         node0 = self.nodes[0]
@@ -219,6 +226,63 @@ class MempoolPersistTest(BitcoinTestFramework):
         node0.mockscheduler(16 * 60)  # 15 min + 1 for buffer
         self.wait_until(lambda: len(conn.get_invs()) == 1)
 
+    def test_dump_tip(self):
+        node = self.nodes[0]
+        mempooldat = node.chain_path / "mempool.dat"
+        skip_msg = "Mempool file was written at the current chain tip, skipping the script checks"
+        wallet = MiniWallet(node)
+
+        self.log.debug("Reload a dump written at the current tip without script checks")
+        wallet.send_self_transfer(from_node=node)
+        num_txs = len(node.getrawmempool())
+        with node.assert_debug_log([skip_msg, f"Imported mempool transactions from file: {num_txs} succeeded"]):
+            self.restart_node(0, extra_args=["-disablewallet"])
+        assert_equal(len(node.getrawmempool()), num_txs)
+
+        self.log.debug("Check that importmempool never skips the script checks")
+        assert_equal(str(mempooldat), node.savemempool()["filename"])
+        dump_copy = node.chain_path / "mempool_copy.dat"
+        shutil.copyfile(mempooldat, dump_copy)
+        with node.assert_debug_log(["Imported mempool transactions from file"], unexpected_msgs=[skip_msg]):
+            assert_equal({}, node.importmempool(dump_copy))
+
+        self.log.debug("Check the script checks of a transaction that does not match its recorded wtxid")
+        tx = wallet.send_self_transfer(from_node=node)
+        node.savemempool()
+        self.stop_node(0)
+        corrupted = tx_from_hex(tx["hex"])
+        control_block = corrupted.wit.vtxinwit[0].scriptWitness.stack[1]
+        corrupted.wit.vtxinwit[0].scriptWitness.stack[1] = control_block[:-1] + bytes([control_block[-1] ^ 1])
+        with open(mempooldat, "rb") as f:
+            data = f.read()
+        # version (8 bytes), then the obfuscation key with its size prefix
+        key = data[9:17]
+        plain = util_xor(data[17:], key, offset=17)
+        assert_equal(plain.count(tx["tx"].serialize()), 1)
+        plain = plain.replace(tx["tx"].serialize(), corrupted.serialize())
+        with open(mempooldat, "wb") as f:
+            f.write(data[:17] + util_xor(plain, key, offset=17))
+        with node.assert_debug_log([skip_msg, f"{num_txs} succeeded, 1 failed"]):
+            self.start_node(0, extra_args=["-disablewallet"])
+        assert tx["txid"] not in node.getrawmempool()
+
+        self.log.debug("Check that the scripts are checked if the tip moved since the dump")
+        wallet.send_self_transfer(from_node=node)
+        num_txs = len(node.getrawmempool())
+        node.savemempool()
+        shutil.copyfile(mempooldat, dump_copy)
+        self.generateblock(node, output=wallet.get_address(), transactions=[], sync_fun=self.no_op)
+        self.stop_node(0)
+        shutil.copyfile(dump_copy, mempooldat)
+        with node.assert_debug_log([f"Imported mempool transactions from file: {num_txs} succeeded"], unexpected_msgs=[skip_msg]):
+            self.start_node(0, extra_args=["-disablewallet"])
+
+        self.log.debug("Check that a legacy dump is reloaded with script checks")
+        self.restart_node(0, extra_args=["-disablewallet", "-persistmempoolv1=1"])
+        with node.assert_debug_log([f"Imported mempool transactions from file: {num_txs} succeeded"], unexpected_msgs=[skip_msg]):
+            self.restart_node(0, extra_args=["-disablewallet"])
+        os.remove(dump_copy)
+
     def test_importmempool_union(self):
         self.log.debug("Submit different transactions to node0 and node1's mempools")
         self.start_node(0)
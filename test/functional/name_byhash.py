@@ -9,6 +9,9 @@ from test_framework.names import NameTestFramework
 from test_framework.util import *
 
 import hashlib
+import http.client
+import json
+import urllib.parse
 
 
 class NameByHashTest (NameTestFramework):
@@ -46,7 +49,8 @@ class NameByHashTest (NameTestFramework):
     assert_equal (node.getindexinfo ("namehash"), {})
 
     # Restart the node and enable indexing.
-    self.restart_node (0, extra_args=["-namehashindex", "-namehistory"])
+    self.restart_node (0, extra_args=["-namehashindex", "-namehistory",
+                                      "-rest"])
     self.wait_until (
         lambda: all (i["synced"] for i in node.getindexinfo ().values ()))
     assert_equal (node.getindexinfo ("namehash"), {
@@ -68,11 +72,85 @@ class NameByHashTest (NameTestFramework):
     assert_raises_rpc_error (-4, "name hash not found",
                              node.name_show, "42" * 32, byHashOptions)
 
+    # Batch lookups of several names, including unknown ones.
+    self.log.info ("Testing name_show_many...")
+    otherName = "othername"
+    otherHashHex = self.nameHash (otherName)
+    new = node.name_new (otherName)
+    self.generate (node, 10)
+    self.firstupdateName (0, otherName, new, "first")
+    self.generate (node, 5)
+    node.name_update (otherName, "second")
+    self.generate (node, 1)
+
+    res = node.name_show_many ([otherHashHex, "42" * 32, doubleHashHex],
+                               byHashOptions)
+    assert_equal (len (res), 3)
+    assert_equal (res[0]["name"], otherName.encode ("ascii").hex ())
+    assert_equal (res[0]["value"], "second")
+    assert_equal (res[1], None)
+    assert_equal (res[2]["name"], nameHex)
+    assert_equal (res[2]["value"], "value")
+    assert_equal (node.name_show_many ([], byHashOptions), [])
+
+    res = node.name_show_many ([name, "unknown"])
+    assert_equal (res[0]["name"], name)
+    assert_equal (res[1], None)
+
+    # The same lookup through REST.
+    res = self.restNameHashes ([otherHashHex, "42" * 32, doubleHashHex])
+    assert_equal (res[0]["name"], otherName)
+    assert_equal (res[0]["value"], "second")
+    assert_equal (res[1], None)
+    assert_equal (res[2]["name"], name)
+    self.restNameHashes (["abcd"], status=400)
+    self.restNameHashes (["42" * 32] * 101, status=400)
+
+    # Expired names are returned as null unless allowExpired is set.  The
+    # other name would be expired by now based on its name_firstupdate, but
+    # it has been updated since.
+    self.generate (node, 25)
+    res = node.name_show_many ([doubleHashHex, otherHashHex], byHashOptions)
+    assert_equal (res[0], None)
+    assert_equal (res[1]["value"], "second")
+    assert_equal (res[1]["expired"], False)
+    res = node.name_show_many ([doubleHashHex, otherHashHex],
+                               {**byHashOptions, "allowExpired": True})
+    assert_equal (res[0]["expired"], True)
+    assert_equal (res[0]["value"], "value")
+    assert_equal (self.restNameHashes ([doubleHashHex, otherHashHex])[0], None)
+
     # General errors with the parameters.
     assert_raises_rpc_error (-8, "Invalid value for byHash",
                              node.name_show, doubleHashHex, {"byHash": "foo"})
     assert_raises_rpc_error (-8, "must be 32 bytes long",
                              node.name_show, "abcd", {"byHash": "sha256d"})
+    assert_raises_rpc_error (-8, "must be 32 bytes long",
+                             node.name_show_many, ["abcd"], byHashOptions)
+    assert_raises_rpc_error (-8, "at most 100 name hashes",
+                             node.name_show_many, ["42" * 32] * 101,
+                             byHashOptions)
+
+  def nameHash (self, name):
+    """
+    Returns the hex-encoded SHA-256d hash of the given name.
+    """
+
+    singleHash = hashlib.new ("sha256", name.encode ("ascii")).digest ()
+    return hashlib.new ("sha256", singleHash).hexdigest ()
+
+  def restNameHashes (self, hashes, status=200):
+    """
+    Looks up names by their hashes through the /rest/namehashes endpoint.
+    """
+
+    url = urllib.parse.urlparse (self.nodes[0].url)
+    conn = http.client.HTTPConnection (url.hostname, url.port)
+    conn.request ("GET", "/rest/namehashes/%s.json" % "/".join (hashes))
+    resp = conn.getresponse ()
+    assert_equal (resp.status, status)
+    if status == 200:
+      return json.loads (resp.read ().decode ("utf-8"))
 
 
 if __name__ == '__main__':
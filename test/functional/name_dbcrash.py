@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026 The Namecoin Core developers
+# Distributed under the MIT/X11 software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+# Test recovery from a crash between writing the name database and the
+# final batch of the coin database during a flush.
+
+from test_framework.names import NameTestFramework
+from test_framework.util import *
+
+
+class NameDbCrashTest (NameTestFramework):
+
+  def set_test_params (self):
+    self.setup_clean_chain = True
+    self.setup_name_test ([[]])
+
+  def run_test (self):
+    node = self.nodes[0]
+    self.generate (node, 200)
+
+    new = node.name_new ("d/crash")
+    self.generate (node, 12)
+    self.firstupdateName (0, "d/crash", new, "before")
+    self.generate (node, 1)
+    node.gettxoutsetinfo ()
+
+    # The flush is small enough to be written in a single coins batch, so
+    # with a crash ratio of one, the first crash point hit is the one right
+    # after the name database has been written.  The first flush after the
+    # restart happens already when the next block is accepted, before it is
+    # connected, so the node has to come back at the old tip.
+    self.log.info ("Crashing after the name database is flushed...")
+    self.restart_node (0, ["-dbcrashratio=1"])
+    height = node.getblockcount ()
+    with node.assert_debug_log (["Simulating a crash"]):
+      try:
+        self.generate (node, 1, sync_fun=self.no_op)
+        node.gettxoutsetinfo ()
+        raise AssertionError ("the node did not crash")
+      except (OSError, ConnectionError) as exc:
+        self.log.debug ("RPC call failed: %s" % exc)
+      self.wait_for_node_exit (0, timeout=10)
+
+    self.log.info ("Restarting after the crash...")
+    self.start_node (0)
+    assert_equal (node.getblockcount (), height)
+    self.checkName (0, "d/crash", "before", None, False)
+    node.gettxoutsetinfo ()
+
+    self.restart_node (0)
+    assert_equal (node.getblockcount (), height)
+    self.checkName (0, "d/crash", "before", None, False)
+
+
+if __name__ == '__main__':
+  NameDbCrashTest (__file__).main ()
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026 The Namecoin Core developers
+# Distributed under the MIT/X11 software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+# RPC test for registering many names at once with name_register_batch.
+
+from test_framework.names import NameTestFramework
+from test_framework.util import *
+
+
+class NameRegisterBatchTest (NameTestFramework):
+
+  def set_test_params (self):
+    self.setup_clean_chain = True
+    self.setup_name_test ([[]] * 2)
+
+  def run_test (self):
+    node = self.nodes[0]
+    self.generate (node, 200)
+
+    self.log.info ("Invalid batches are rejected as a whole.")
+    assert_raises_rpc_error (-8, "duplicate name: d/x",
+                             node.name_register_batch,
+                             [{"name": "d/x"}, {"name": "d/x"}])
+    assert_raises_rpc_error (-8, "the name is too long",
+                             node.name_register_batch,
+                             [{"name": "x" * 256}])
+    assert_equal (node.listqueuedtransactions (), {})
+
+    self.log.info ("Register names in two batches.")
+    res = node.name_register_batch ([
+      {"name": "d/a", "value": "value a"},
+      {"name": "d/b"},
+      {"name": "d/c", "value": "value c"},
+    ])
+    otherAddr = self.nodes[1].getnewaddress ()
+    res.extend (node.name_register_batch ([{"name": "d/d"}],
+                                          {"destAddress": otherAddr}))
+    assert_equal ([r["name"] for r in res], ["d/a", "d/b", "d/c", "d/d"])
+
+    mempool = node.getrawmempool ()
+    queued = node.listqueuedtransactions ()
+    assert_equal (len (queued), 4)
+    for r in res:
+      assert r["txid"] in mempool
+      assert r["firstupdate"] in queued
+      assert r["firstupdate"] not in mempool
+
+    # The outputs that the queued name_firstupdates spend are locked right
+    # away, so that no later name_new of the batch spends them.
+    firstInputs = set ()
+    for q in queued.values ():
+      for i in node.decoderawtransaction (q["transaction"])["vin"]:
+        firstInputs.add ((i["txid"], i["vout"]))
+    assert_equal (len (firstInputs), 8)
+    locked = set ((l["txid"], l["vout"]) for l in node.listlockunspent ())
+    assert firstInputs.issubset (locked)
+    for r in res:
+      for i in node.getrawtransaction (r["txid"], True)["vin"]:
+        assert (i["txid"], i["vout"]) not in firstInputs
+
+    self.log.info ("The name_firstupdates wait for the name_new's to mature.")
+    self.generate (node, 11)
+    assert_equal (len (node.listqueuedtransactions ()), 4)
+    # When they are broadcast, the stored name_new's are no longer needed.
+    erased = ["Erased stored name_new %s:" % r["txid"] for r in res]
+    with node.assert_debug_log (erased):
+      self.generate (node, 1)
+    assert_equal (node.listqueuedtransactions (), {})
+    mempool = node.getrawmempool ()
+    for r in res:
+      assert r["firstupdate"] in mempool
+
+    self.generate (node, 1)
+    self.checkName (0, "d/a", "value a", 30, False)
+    self.checkName (0, "d/b", "", 30, False)
+    self.checkName (0, "d/c", "value c", 30, False)
+    data = self.checkName (0, "d/d", "", 30, False)
+    assert_equal (data["address"], otherAddr)
+    assert_equal (node.name_show ("d/a")["txid"], res[0]["firstupdate"])
+
+    self.log.info ("Names that exist already are rejected.")
+    assert_raises_rpc_error (-25, "this name exists already: d/a",
+                             node.name_register_batch, [{"name": "d/a"}])
+
+
+if __name__ == '__main__':
+  NameRegisterBatchTest (__file__).main ()
@@ -178,6 +178,19 @@ class NameRegistrationTest (NameTestFramework):
     self.checkName (0, "name-1", "reregistered", 23, False)
     self.checkNameHistory (0, "name-1", ["x" * 520, "reregistered"])
 
+    # The wallet remembers the name_new and its salt also across a restart,
+    # so that name_firstupdate works without rand and txid.  The record is
+    # used instead of scanning the wallet, and erased once it is spent.
+    newRestart = node.name_new ("name-restart")
+    self.restart_node (0)
+    self.connect_nodes (0, 1)
+    self.generateToOther (12)
+    with node.assert_debug_log (["using stored name_new %s:" % newRestart[0],
+                                 "Erased stored name_new %s:" % newRestart[0]]):
+      node.name_firstupdate ("name-restart", None, None, "restarted")
+    self.generateToOther (1)
+    self.checkName (0, "name-restart", "restarted", 30, False)
+
     # Test that name updates are even possible with less balance in the wallet
     # than what is locked in a name (0.01 NMC).  There was a bug preventing
     # this from working.
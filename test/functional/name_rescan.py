@@ -0,0 +1,90 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026 The Namecoin Core developers
+# Distributed under the MIT/X11 software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+# Tests that wallet rescans find names sent to the wallet, also with the
+# fast variant using the names block filters and with blocks read ahead
+# on threads.
+
+from test_framework.names import NameTestFramework
+from test_framework.util import *
+
+
+class NameRescanTest (NameTestFramework):
+
+  def set_test_params (self):
+    self.setup_clean_chain = True
+    self.setup_name_test ([["-blockfilterindex=names", "-rescanthreads=2"]])
+
+  def getWalletState (self, w):
+    names = sorted ([n["name"] for n in w.name_list ()])
+    txids = sorted ([t["txid"] for t in w.listtransactions ("*", 1000)])
+    return names, txids
+
+  def restore (self, name, backup, debugMsg):
+    node = self.nodes[0]
+    with node.assert_debug_log ([debugMsg]):
+      node.restorewallet (name, backup)
+    return node.get_wallet_rpc (name)
+
+  def run_test (self):
+    node = self.nodes[0]
+    node.createwallet ("recv")
+    recv = node.get_wallet_rpc ("recv")
+    default = node.get_wallet_rpc (self.default_wallet_name)
+
+    recvAddr = recv.getnewaddress ()
+    backup = node.datadir_path / "recv.bak"
+    recv.backupwallet (backup)
+
+    self.generate (node, 110)
+
+    # The name is registered by the default wallet and only sent to the
+    # receiving wallet, so the name output is the only match for it in
+    # the block.
+    self.log.info ("Send names and coins to the wallet.")
+    newA = default.name_new ("d/a")
+    newB = default.name_new ("d/b")
+    self.generate (node, 12)
+    default.name_firstupdate ("d/a", newA[1], newA[0], "value a",
+                              {"destAddress": recvAddr})
+    default.name_firstupdate ("d/b", newB[1], newB[0], "value b")
+    self.generate (node, 5)
+    default.name_update ("d/b", "value b", {"destAddress": recvAddr})
+    self.generate (node, 5)
+    coinTxid = default.sendtoaddress (recv.getnewaddress (), 1)
+    self.generate (node, 20)
+
+    expected = self.getWalletState (recv)
+    assert_equal (expected[0], ["d/a", "d/b"])
+    assert coinTxid in expected[1]
+
+    self.log.info ("Fast rescan with read-ahead threads.")
+    w = self.restore ("fast_threads", backup,
+                      "fast variant using block filters")
+    assert_equal (self.getWalletState (w), expected)
+
+    self.log.info ("Fast rescan without threads.")
+    self.restart_node (0, ["-blockfilterindex=names"])
+    w = self.restore ("fast", backup, "fast variant using block filters")
+    assert_equal (self.getWalletState (w), expected)
+
+    self.log.info ("Slow rescan with read-ahead threads.")
+    self.restart_node (0, ["-rescanthreads=2"])
+    w = self.restore ("slow_threads", backup,
+                      "slow variant inspecting all blocks")
+    assert_equal (self.getWalletState (w), expected)
+
+    # The BASIC filter does not contain the addresses of name outputs.  It is
+    # used if there is no names index, but misses the blocks in which the
+    # name outputs are the only matches for the wallet.
+    self.log.info ("Rescan with only the basic filter index.")
+    self.restart_node (0, ["-blockfilterindex"])
+    w = self.restore ("basic", backup,
+                      "names received without other wallet outputs are not found")
+    assert_equal (self.getWalletState (w), ([], [coinTxid]))
+
+
+if __name__ == '__main__':
+  NameRescanTest (__file__).main ()
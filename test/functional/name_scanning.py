@@ -57,6 +57,12 @@ class NameScanningTest (NameTestFramework):
     self.checkList (self.node.name_scan ("", 2), ["d/a", "d/b"])
     self.checkList (self.node.name_scan ("d/b", 1), ["d/b"])
 
+    # Single requests stream their result, while batched ones do not.  Both
+    # must give the same data.
+    [batched] = self.node.batch ([self.node.name_scan.get_request ()])
+    assert "error" not in batched
+    assert_equal (batched["result"], self.node.name_scan ())
+
     # Verify encoding for start argument.
     self.checkList (self.node.name_scan ("642f63", 10, {"nameEncoding": "hex"}),
                     ["642f63", "642f6161"])
@@ -71,6 +71,29 @@ class NameTransactionQueueTest(NameTestFramework):
         self.log.info("Check name is registered.")
         self.checkName(0, "d/name", "value", 30, False)
 
+        self.log.info("Queue a transaction with a lock time.")
+        lockHeight = node.getblockcount () + 5
+        lock_txRaw = node.createrawtransaction([], {node.getnewaddress(): Decimal("1")}, lockHeight)
+        lock_txFunded = node.fundrawtransaction(lock_txRaw)['hex']
+        lock_txSigned = node.signrawtransactionwithwallet(lock_txFunded)['hex']
+        lock_txid = node.queuerawtransaction(lock_txSigned)
+        assert lock_txid in node.listqueuedtransactions()
+
+        self.log.info("Make sure it survives a restart.")
+        self.restart_node(0)
+        assert lock_txid in node.listqueuedtransactions()
+
+        self.log.info("It is broadcast once the tip reaches the lock time.")
+        self.generate (node, 4)
+        assert lock_txid in node.listqueuedtransactions()
+        self.generate (node, 1)
+        assert lock_txid not in node.listqueuedtransactions()
+        assert lock_txid in node.getrawmempool()
+
+        self.log.info("Broadcast transactions are not queued after a restart.")
+        self.restart_node(0)
+        assert lock_txid not in node.listqueuedtransactions()
+
         self.log.info("OK!")
 
         self.log.info("Queue some garbage.")
@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+# Copyright (c) 2026 The Namecoin Core developers
+# Distributed under the MIT/X11 software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+# RPC test for updating many names at once with name_update_batch.
+
+from test_framework.names import NameTestFramework
+from test_framework.util import *
+
+
+class NameUpdateBatchTest (NameTestFramework):
+
+  def set_test_params (self):
+    self.setup_clean_chain = True
+    self.setup_name_test ([["-limitnamechains=2"], []])
+
+  def run_test (self):
+    node = self.nodes[0]
+    self.generate (node, 200)
+
+    otherAddr = self.nodes[1].getnewaddress ()
+    node.name_register_batch ([
+      {"name": "d/a", "value": "value a"},
+      {"name": "d/b", "value": "value b"},
+      {"name": "d/c"},
+    ])
+    node.name_register_batch ([{"name": "d/other"}],
+                              {"destAddress": otherAddr})
+    self.generate (node, 12)
+    self.generate (node, 1)
+    self.checkName (0, "d/a", "value a", 30, False)
+
+    self.log.info ("Invalid batches are rejected as a whole.")
+    assert_raises_rpc_error (-8, "duplicate name: d/a",
+                             node.name_update_batch,
+                             [{"name": "d/a"}, {"name": "d/a"}])
+    assert_raises_rpc_error (-25, "this name can not be updated",
+                             node.name_update_batch,
+                             [{"name": "d/a"}, {"name": "d/missing"}])
+    assert_raises_rpc_error (-4, "the wallet does not own the name d/other",
+                             node.name_update_batch,
+                             [{"name": "d/a"}, {"name": "d/other"}])
+    assert_equal (node.getrawmempool (), [])
+
+    self.log.info ("Update names in a batch.")
+    res = node.name_update_batch ([
+      {"name": "d/a", "value": "new a"},
+      {"name": "d/b"},
+      {"name": "d/c", "value": "new c"},
+    ])
+    assert_equal ([r["name"] for r in res], ["d/a", "d/b", "d/c"])
+    mempool = node.getrawmempool ()
+    for r in res:
+      assert r["txid"] in mempool
+      # Each transaction is funded by a single coin next to the name input.
+      tx = node.getrawtransaction (r["txid"], True)
+      assert_equal (len (tx["vin"]), 2)
+
+    self.log.info ("Names with pending updates are chained upon.")
+    res2 = node.name_update_batch ([{"name": "d/a", "value": "newer a"}],
+                                   {"destAddress": otherAddr})
+    tx = node.getrawtransaction (res2[0]["txid"], True)
+    assert res[0]["txid"] in [i["txid"] for i in tx["vin"]]
+
+    self.generate (node, 1)
+    self.checkName (0, "d/a", "newer a", 30, False)
+    self.checkName (0, "d/b", "value b", 30, False)
+    self.checkName (0, "d/c", "new c", 30, False)
+    assert_equal (node.name_show ("d/a")["address"], otherAddr)
+    assert_equal (node.name_show ("d/c")["txid"], res[2]["txid"])
+
+    self.log.info ("Names sent away are no longer in the wallet.")
+    assert_raises_rpc_error (-4, "the wallet does not own the name d/a",
+                             node.name_update_batch, [{"name": "d/a"}])
+
+
+if __name__ == '__main__':
+  NameUpdateBatchTest (__file__).main ()
@@ -418,6 +418,7 @@ BASE_SCRIPTS = [
     'name_ant_workflow.py',
     'name_bumpfee.py',
     'name_byhash.py',
+    'name_dbcrash.py',
     # FIXME: Fix for descriptor wallets:
     #'name_deterministic_salt.py',
     'name_encodings.py',
@@ -434,12 +435,15 @@ BASE_SCRIPTS = [
     'name_pending.py',
     'name_psbt.py',
     'name_rawtx.py',
+    'name_register_batch.py',
     'name_registration.py',
     'name_reorg.py',
+    'name_rescan.py',
     'name_scanning.py',
     'name_segwit.py',
     'name_sendcoins.py',
     'name_txnqueue.py',
+    'name_update_batch.py',
     'name_utxo.py',
     'name_wallet.py',
 ]